@@ -0,0 +1,367 @@
+/**
+ * Micro benchmarks of the library hot paths.
+ *
+ * Run with --benchmark_format=json (or --benchmark_out=<file>) to get results
+ * that can be compared between releases.
+ */
+#include <benchmark/benchmark.h>
+
+#include <memory>
+#include <random>
+#include <boost/signals2.hpp>
+
+#include <robotcontext.h>
+#include <robotlogging.h>
+#include <common/value.h>
+#include <common/notifysubscription.h>
+#include <math/pid.h>
+#include <led/color.h>
+#include <led/colorlayer.h>
+#include <led/control.h>
+#include <motor/control.h>
+#include <motor/traction.h>
+#include <input/control.h>
+#include <kinematic/kinematic.h>
+#include <kinematic/controlscheme/allwheel.h>
+#include <kinematic/ackermann.h>
+#include <kinematic/path.h>
+#include <telemetry/telemetry.h>
+#include <telemetry/eventpool.h>
+#include <telemetry/sources/abstracttelemetrysource.h>
+
+using namespace std::literals;
+
+static Robot::Logging::LogInit __log_init { boost::log::trivial::warning };
+
+
+/**
+ * Pre generated input so the random generator is not part of the measurement
+ */
+template<typename T, std::size_t N = 1024>
+static std::array<T, N> randomInputs(T min, T max)
+{
+    std::mt19937 mt { 42 };
+    std::array<T, N> values;
+    for (auto &v : values) {
+        if constexpr (std::is_floating_point_v<T>) {
+            v = std::uniform_real_distribution<T>(min, max)(mt);
+        }
+        else {
+            v = std::uniform_int_distribution<T>(min, max)(mt);
+        }
+    }
+    return values;
+}
+
+
+
+// -----------------------------------------------
+// LED
+// -----------------------------------------------
+
+static void BM_ColorBlend(benchmark::State &state)
+{
+    using Robot::LED::Color;
+    auto alpha = randomInputs<int>(0, 255);
+    Color dst { 0x10, 0x20, 0x30 };
+    std::size_t i = 0;
+    for (auto _ : state) {
+        dst << Color { 0xFF, 0x80, 0x00, alpha[i++ % alpha.size()] };
+        benchmark::DoNotOptimize(dst);
+    }
+}
+BENCHMARK(BM_ColorBlend);
+
+
+static void BM_ColorBrightness(benchmark::State &state)
+{
+    using Robot::LED::Color;
+    auto brightness = randomInputs<float>(0.0f, 1.0f);
+    const Color color { 0xFF, 0x80, 0x40 };
+    std::size_t i = 0;
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(color * brightness[i++ % brightness.size()]);
+    }
+}
+BENCHMARK(BM_ColorBrightness);
+
+
+static void BM_ColorCorrection(benchmark::State &state)
+{
+    using Robot::LED::Color;
+    auto channel = randomInputs<int>(0, 255);
+    std::size_t i = 0;
+    for (auto _ : state) {
+        Color color { channel[i++ % channel.size()], 0x80, 0x40 };
+        benchmark::DoNotOptimize(color * Color::Correction::TypicalSMD5050);
+    }
+}
+BENCHMARK(BM_ColorCorrection);
+
+
+static void BM_ColorLayerComposite(benchmark::State &state)
+{
+    using namespace Robot::LED;
+    const auto nlayers = state.range(0);
+    std::vector<std::shared_ptr<ColorLayer>> layers;
+    for (auto n=0; n<nlayers; n++) {
+        auto layer = std::make_shared<ColorLayer>("bench", LAYER_DEPTH_ANIMATION+n);
+        layer->fill(Color { 0x20*n, 0x80, 0xFF-0x20*n, 0x80 });
+        layers.push_back(layer);
+    }
+    color_array_type pixels;
+    for (auto _ : state) {
+        pixels.fill(Color::BLACK);
+        for (const auto &layer : layers) {
+            pixels << *layer;
+        }
+        benchmark::DoNotOptimize(pixels);
+    }
+    state.SetItemsProcessed(state.iterations() * nlayers * PIXEL_COUNT);
+}
+BENCHMARK(BM_ColorLayerComposite)->Arg(1)->Arg(4)->Arg(8);
+
+
+static void BM_LEDUpdatePixels(benchmark::State &state)
+{
+    using namespace Robot::LED;
+    auto context = std::make_shared<Robot::Context>();
+    auto control = std::make_shared<Control>(context);
+    control->init(nullptr);
+    for (auto n=0; n<state.range(0); n++) {
+        auto layer = std::make_shared<ColorLayer>("bench", LAYER_DEPTH_ANIMATION+n);
+        layer->fill(Color { 0x20*n, 0x80, 0xFF-0x20*n, 0x80 });
+        layer->setVisible(true);
+        control->attachLayer(layer);
+    }
+    context->io().poll();
+
+    // update() posts the composite to the control strand, run it here
+    for (auto _ : state) {
+        control->update();
+        context->io().poll();
+        context->io().restart();
+    }
+
+    control->cleanup();
+}
+BENCHMARK(BM_LEDUpdatePixels)->Arg(1)->Arg(4);
+
+
+
+// -----------------------------------------------
+// Control
+// -----------------------------------------------
+
+static void BM_PIDUpdate(benchmark::State &state)
+{
+    Robot::Math::PID pid { 1.0f, 0.5f, 0.01f, 10ms };
+    pid.setLimits(-1.0f, 1.0f);
+    pid.setSetpoint(0.5f);
+    auto inputs = randomInputs<float>(-1.0f, 1.0f);
+    std::size_t i = 0;
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(pid.update(inputs[i++ % inputs.size()]));
+    }
+}
+BENCHMARK(BM_PIDUpdate);
+
+
+static void BM_TractionUpdate(benchmark::State &state)
+{
+    Robot::Motor::Traction traction;
+    const Robot::Motor::MotorValues expected { 100.0f, -100.0f, 100.0f, -100.0f };
+    auto inputs = randomInputs<float>(80.0f, 120.0f);
+    std::size_t i = 0;
+    for (auto _ : state) {
+        const Robot::Motor::MotorValues rpm { inputs[i % inputs.size()], -inputs[(i+1) % inputs.size()], inputs[(i+2) % inputs.size()], -inputs[(i+3) % inputs.size()] };
+        benchmark::DoNotOptimize(traction.update(expected, rpm));
+        i += 4;
+    }
+}
+BENCHMARK(BM_TractionUpdate);
+
+
+static void BM_WheelSteering(benchmark::State &state)
+{
+    auto context = std::make_shared<Robot::Context>();
+    auto motor_control = std::make_shared<Robot::Motor::Control>(context);
+    auto input_control = std::make_shared<Robot::Input::Control>(context);
+    auto kinematic = std::make_shared<Robot::Kinematic::Kinematic>(context);
+    kinematic->init(motor_control, nullptr, nullptr, input_control);
+
+    auto scheme = std::make_shared<Robot::Kinematic::ControlSchemeAllWheel>(kinematic);
+    scheme->init();
+
+    auto steering = randomInputs<float>(-1.0f, 1.0f);
+    auto throttle = randomInputs<float>(-1.0f, 1.0f);
+    std::size_t i = 0;
+    for (auto _ : state) {
+        auto n = i++ % steering.size();
+        scheme->steer(steering[n], throttle[n], 0.0f, 0.0f);
+    }
+
+    scheme->cleanup();
+    kinematic->cleanup();
+}
+BENCHMARK(BM_WheelSteering);
+
+
+static void BM_AckermannGeometry(benchmark::State &state)
+{
+    using Robot::Kinematic::Ackermann;
+    const auto &geometry = Robot::Kinematic::ACKERMANN_ALL_WHEEL;
+    const bool table = state.range(0)!=0;
+    auto angles = randomInputs<float>(0.01f, Ackermann::ANGLE_MAX);
+    std::size_t i = 0;
+    for (auto _ : state) {
+        auto angle = angles[i++ % angles.size()];
+        benchmark::DoNotOptimize(table ? geometry.lookup(angle) : geometry.analytic(angle));
+    }
+}
+BENCHMARK(BM_AckermannGeometry)->ArgName("table")->Arg(0)->Arg(1);
+
+
+static void BM_PurePursuit(benchmark::State &state)
+{
+    using namespace Robot::Kinematic;
+    // Zig-zag of the given number of 1m legs, the update should not depend on it
+    std::vector<Point> waypoints;
+    for (auto i=0; i<=state.range(0); i++) {
+        waypoints.push_back(Point { i*1000.0f, (i%2)*300.0f });
+    }
+    PurePursuit pursuit { 250.0f };
+    pursuit.setPath(std::make_shared<const Path>(waypoints, true));
+    Pose pose;
+    for (auto _ : state) {
+        auto command = pursuit.update(pose);
+        if (command.done) {
+            pursuit.reset();
+            pose = Pose {};
+        }
+        pose.advance(15.0f, command.curvature);
+        benchmark::DoNotOptimize(command);
+    }
+}
+BENCHMARK(BM_PurePursuit)->ArgName("legs")->Arg(4)->Arg(400);
+
+
+static void BM_ValueFromAngle(benchmark::State &state)
+{
+    auto angles = randomInputs<float>(-Robot::Value::PI_2, Robot::Value::PI_2);
+    std::size_t i = 0;
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(Robot::Value::fromAngle(angles[i++ % angles.size()]));
+    }
+}
+BENCHMARK(BM_ValueFromAngle);
+
+
+static void BM_ValueConversions(benchmark::State &state)
+{
+    auto floats = randomInputs<float>(-1.0f, 1.0f);
+    std::size_t i = 0;
+    for (auto _ : state) {
+        auto value = Robot::Value::fromFloat(floats[i++ % floats.size()]);
+        benchmark::DoNotOptimize(value.asAngle());
+        benchmark::DoNotOptimize(value.asServoPulse());
+        benchmark::DoNotOptimize(value.asPercent());
+    }
+}
+BENCHMARK(BM_ValueConversions);
+
+
+
+// -----------------------------------------------
+// Notification and signals
+// -----------------------------------------------
+
+static void BM_SubscriptionWriteRead(benchmark::State &state)
+{
+    using subscription_type = Robot::NotifySubscription<int>;
+    const auto batch = state.range(0);
+    auto sub = std::make_shared<subscription_type>();
+    for (auto _ : state) {
+        for (auto n=0; n<batch; n++) {
+            sub->write(n & 0x07);
+        }
+        benchmark::DoNotOptimize(sub->read());
+    }
+    state.SetItemsProcessed(state.iterations() * batch);
+}
+BENCHMARK(BM_SubscriptionWriteRead)->Arg(1)->Arg(16)->Arg(64);
+
+
+static void BM_SignalEmit(benchmark::State &state)
+{
+    boost::signals2::signal<void(int)> signal;
+    std::vector<boost::signals2::scoped_connection> connections;
+    volatile int sink = 0;
+    for (auto n=0; n<state.range(0); n++) {
+        connections.emplace_back(signal.connect([&sink](int v) { sink = v; }));
+    }
+    int i = 0;
+    for (auto _ : state) {
+        signal(i++);
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_SignalEmit)->Arg(0)->Arg(1)->Arg(4);
+
+
+
+// -----------------------------------------------
+// Telemetry
+// -----------------------------------------------
+
+class BenchSource : public Robot::Telemetry::AbstractSource<BenchSource> {
+    public:
+        BenchSource() : AbstractSource { "bench" }, m_events { "bench" } {}
+
+        void send(float pitch)
+        {
+            if (auto handle = m_events.acquire()) {
+                handle->pitch = pitch;
+                sendEvent(handle);
+            }
+        }
+
+        void sendCopy(float pitch)
+        {
+            sendEvent(Robot::Telemetry::EventIMU { "bench", pitch, 0.0f, 0.0f });
+        }
+
+    private:
+        Robot::Telemetry::EventPool<Robot::Telemetry::EventIMU> m_events;
+};
+
+
+static void BM_TelemetryProcess(benchmark::State &state)
+{
+    auto context = std::make_shared<Robot::Context>();
+    auto telemetry = std::make_shared<Robot::Telemetry::Telemetry>(context);
+    auto source = std::make_shared<BenchSource>();
+    telemetry->addSource(source);
+    telemetry->init();
+
+    const bool pooled = state.range(0)!=0;
+    auto pitch = randomInputs<float>(-1.0f, 1.0f);
+    std::size_t i = 0;
+    for (auto _ : state) {
+        if (pooled) {
+            source->send(pitch[i++ % pitch.size()]);
+        }
+        else {
+            source->sendCopy(pitch[i++ % pitch.size()]);
+        }
+        // Run the strand handler applying the event
+        context->io().poll();
+        context->io().restart();
+    }
+
+    telemetry->cleanup();
+}
+BENCHMARK(BM_TelemetryProcess)->ArgName("pooled")->Arg(0)->Arg(1);
+
+
+BENCHMARK_MAIN();
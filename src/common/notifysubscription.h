@@ -12,6 +12,8 @@
 #include <boost/lockfree/queue.hpp>
 #include <boost/log/trivial.hpp> 
 
+#include <metrics/metrics.h>
+#include <metrics/probes.h>
 #include "withnotify.h"
 
 namespace Robot {
@@ -153,6 +155,9 @@ namespace Robot {
                     return true;
                 }
                 else {
+                    static const auto dropped = Metrics::registry().counter("robot_subscription_dropped", "Notifications dropped because a subscription queue was full");
+                    dropped->inc();
+                    ROBOT_PROBE2(notify__queue__full, m_fd, value);
                     BOOST_LOG_TRIVIAL(warning) << *this << " PUSH (" << value << ") queue full";
                 }
                 return false;
@@ -4,6 +4,7 @@
 #include <boost/asio.hpp>
 #include <boost/log/trivial.hpp>
 #include <robotcontext.h>
+#include <metrics/trace.h>
 
 namespace Robot {
 
@@ -18,21 +19,49 @@ namespace Robot {
         protected:
             mutable strand_type m_strand;
 
+            /**
+             * Wrap handler so the time it runs on the strand shows up in the trace,
+             * paired with the strand.* instant recorded where it was handed over.
+             */
+            template<typename Handler>
+            static auto traced(Handler &&handler)
+            {
+                return [handler=std::forward<Handler>(handler)]() mutable {
+                    ROBOT_TRACE_SCOPE("strand.run");
+                    handler();
+                };
+            }
+
             template<typename Handler>
             void dispatch(Handler handler) 
             {
+                if (Metrics::Trace::enabled()) {
+                    Metrics::Trace::instant("strand.dispatch");
+                    boost::asio::dispatch(m_strand, traced(std::move(handler)));
+                    return;
+                }
                 boost::asio::dispatch(m_strand, handler);
             }
 
             template<typename Handler>
             void defer(Handler handler) 
             {
+                if (Metrics::Trace::enabled()) {
+                    Metrics::Trace::instant("strand.defer");
+                    boost::asio::defer(m_strand, traced(std::move(handler)));
+                    return;
+                }
                 boost::asio::defer(m_strand, handler);
             }
 
             template<typename Handler>
             void post(Handler handler) 
             {
+                if (Metrics::Trace::enabled()) {
+                    Metrics::Trace::instant("strand.post");
+                    boost::asio::post(m_strand, traced(std::move(handler)));
+                    return;
+                }
                 boost::asio::post(m_strand, handler);
             }
     };
@@ -23,6 +23,14 @@ namespace Robot::Config {
     inline constexpr float WHEEL_DIAMETER_MM { WHEEL_CIRC_MM / M_PI };
     inline constexpr auto WHEEL_ENCODER_CPR { 20 };
     inline constexpr auto WHEEL_GEARING { 100 };
+    inline constexpr auto WHEEL_MAX_RPM { 150.0f }; // Full throttle when throttle is closed loop
+    inline constexpr auto WHEEL_NO_LOAD_RPM { 180.0f }; // Wheel speed at full duty without load
+    inline constexpr auto WHEEL_TIME_CONSTANT { 0.075f }; // s, wheel speed step response while balancing
+
+    // Body standing on the rear axle when balancing
+    inline constexpr auto BODY_MASS { 1.2f };       // kg
+    inline constexpr auto BODY_HEIGHT_MM { 80.0f }; // Rear axle to center of mass
+    inline constexpr auto BODY_INERTIA { 0.004f };  // kg*m^2 around the center of mass
 
     // Wheel servo limits 
     inline constexpr auto WHEEL_SERVO_LIMIT_MIN { 650u };
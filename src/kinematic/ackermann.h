@@ -0,0 +1,122 @@
+#ifndef _ROBOT_KINEMATIC_ACKERMANN_H_
+#define _ROBOT_KINEMATIC_ACKERMANN_H_
+
+#include <array>
+#include <cmath>
+#include <cstddef>
+#include <algorithm>
+
+#include <robotconfig.h>
+#include <math/constmath.h>
+
+namespace Robot::Kinematic {
+
+    /**
+     * Turning geometry of the wheel steering schemes.
+     *
+     * With the inner wheels at inner_angle the turning circle center is at
+     * wheel_base_factor/tan(inner_angle) from the inner wheels. The outer wheels sit
+     * WHEEL_BASE_MM further out, which gives their angle and the inner to outer
+     * wheel speed ratio.
+     *
+     * The steering fraction and skew only enter through the inner angle, so the
+     * geometry is tabulated over the inner angle at compile time and interpolated
+     * linearly, replacing the tan/atan evaluation of each steer event.
+     */
+    class Ackermann {
+        public:
+            static constexpr std::size_t SEGMENTS { 64 };
+            static constexpr float ANGLE_MAX { Robot::Config::WHEEL_MAX_TURN_ANGLE };
+
+            struct Geometry {
+                float outer_angle;  ///< rad, angle of the outer wheels
+                float ratio;        ///< Inner wheel speed relative to the outer wheels
+            };
+
+            constexpr explicit Ackermann(float wheel_base_factor) :
+                m_wheel_base_factor { wheel_base_factor },
+                m_outer_angle {},
+                m_ratio {}
+            {
+                const double factor = wheel_base_factor;
+                const double base = Robot::Config::WHEEL_BASE_MM;
+                for (std::size_t i=0; i<=SEGMENTS; i++) {
+                    // Written so the straight ahead entry stays finite
+                    const auto t = Robot::Math::Const::tan(i*STEP);
+                    m_outer_angle[i] = static_cast<float>(Robot::Math::Const::atan(factor*t / (factor + base*t)));
+                    m_ratio[i] = static_cast<float>(factor / (factor + base*t));
+                }
+            }
+
+            /**
+             * @brief Interpolated geometry for the inner wheel angle
+             *
+             * @param inner_angle rad, clamped to [0,ANGLE_MAX]
+             */
+            constexpr Geometry lookup(float inner_angle) const
+            {
+                const auto x = std::clamp(inner_angle, 0.0f, ANGLE_MAX) / static_cast<float>(STEP);
+                const auto i = std::min(static_cast<std::size_t>(x), SEGMENTS-1);
+                const auto frac = x - static_cast<float>(i);
+                return Geometry {
+                    m_outer_angle[i] + frac*(m_outer_angle[i+1]-m_outer_angle[i]),
+                    m_ratio[i] + frac*(m_ratio[i+1]-m_ratio[i]),
+                };
+            }
+
+            /**
+             * @brief Geometry evaluated with tan/atan at run time, for reference
+             */
+            Geometry analytic(float inner_angle) const
+            {
+                auto inner_circle_dist = std::tan(M_PI_2-inner_angle) * m_wheel_base_factor;
+                auto outer_angle = std::atan(m_wheel_base_factor/(inner_circle_dist+Robot::Config::WHEEL_BASE_MM));
+                auto outer_circle_dist = std::tan(M_PI_2-outer_angle) * m_wheel_base_factor;
+                return Geometry { static_cast<float>(outer_angle), static_cast<float>(inner_circle_dist/outer_circle_dist) };
+            }
+
+            /**
+             * @brief Curvature (1/mm) of the path of the chassis center
+             *
+             * @param inner_angle rad, the sign is ignored
+             */
+            float curvature(float inner_angle) const
+            {
+                const auto t = std::tan(std::abs(inner_angle));
+                return t / (m_wheel_base_factor + 0.5f*Robot::Config::WHEEL_BASE_MM*t);
+            }
+
+            /**
+             * @brief Inner wheel angle turning the chassis center on a curvature, inverse of curvature()
+             *
+             * @param curvature 1/mm, the sign is ignored
+             * @return rad, clamped to ANGLE_MAX
+             */
+            float innerAngle(float curvature) const
+            {
+                const auto k = std::abs(curvature);
+                const auto denominator = 1.0f - 0.5f*Robot::Config::WHEEL_BASE_MM*k;
+                if (denominator<=0.0f)
+                    return ANGLE_MAX;
+                return std::min(std::atan(m_wheel_base_factor*k/denominator), ANGLE_MAX);
+            }
+
+            float wheelBaseFactor() const { return m_wheel_base_factor; }
+
+        private:
+            static constexpr double STEP { static_cast<double>(ANGLE_MAX)/SEGMENTS };
+
+            const float m_wheel_base_factor;
+            std::array<float, SEGMENTS+1> m_outer_angle;
+            std::array<float, SEGMENTS+1> m_ratio;
+    };
+
+
+    /// Geometry of all wheel steering
+    inline constexpr Ackermann ACKERMANN_ALL_WHEEL { Robot::Config::WHEEL_BASE_MM };
+    /// Geometry of front or rear wheel steering
+    inline constexpr Ackermann ACKERMANN_SINGLE_AXLE { Robot::Config::WHEEL_BASE_2_MM };
+
+}
+
+#endif
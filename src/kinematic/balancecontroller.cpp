@@ -0,0 +1,163 @@
+#include "balancecontroller.h"
+
+#include <cmath>
+#include <algorithm>
+#include <boost/format.hpp>
+#include <boost/log/trivial.hpp>
+
+#include <robotconfig.h>
+#include <math/lqr.h>
+
+using namespace Robot::Config;
+
+namespace Robot::Kinematic {
+
+static constexpr auto GRAVITY { 9.81 };
+
+
+BalanceController::Gains BalanceController::Gains::defaults()
+{
+    // Tuned against the simulated plant at the 100Hz IMU rate
+    Gains gains;
+    gains.mode = Mode::CASCADE;
+    gains.angle_p = 25.0f;
+    gains.angle_i = 0.0f;
+    gains.angle_d = 1.5f;
+    gains.velocity_p = 0.3f;
+    gains.velocity_i = 0.0f;
+    gains.position_p = 1.0f;
+    gains.tilt_max = 0.15f;
+    gains.q_tilt = 100.0f;
+    gains.q_tilt_rate = 1.0f;
+    gains.q_position = 10.0f;
+    gains.q_velocity = 1.0f;
+    gains.r_duty = 1.0f;
+    return gains;
+}
+
+
+BalanceController::Model BalanceController::Model::defaults()
+{
+    Model model;
+    model.body_mass = BODY_MASS;
+    model.body_height = BODY_HEIGHT_MM/1000.0f;
+    model.body_inertia = BODY_INERTIA;
+    model.wheel_speed_max = WHEEL_NO_LOAD_RPM*WHEEL_CIRC_MM/(60.0f*1000.0f);
+    model.wheel_time_constant = WHEEL_TIME_CONSTANT;
+    return model;
+}
+
+
+
+BalanceController::BalanceController(sample_time_type Ts) :
+    m_Ts { Ts },
+    m_gains { Gains::defaults() },
+    m_mode { Mode::CASCADE },
+    m_angle_pid { m_gains.angle_p, m_gains.angle_i, 0.0f, Ts },
+    m_velocity_pid { m_gains.velocity_p, m_gains.velocity_i, 0.0f, Ts },
+    m_velocity { 0.0f },
+    m_position { 0.0f },
+    m_tilt_reference { 0.0f }
+{
+    configure(m_gains);
+}
+
+
+bool BalanceController::configure(const Gains &gains, const Model &model)
+{
+    using Robot::Math::Matrix;
+
+    m_gains = gains;
+    m_angle_pid.set(gains.angle_p, gains.angle_i, 0.0f);
+    m_angle_pid.setLimits(-1.0f, 1.0f);
+    m_velocity_pid.set(gains.velocity_p, gains.velocity_i, 0.0f);
+    m_velocity_pid.setLimits(-gains.tilt_max, gains.tilt_max);
+    m_mode = Mode::CASCADE;
+
+    if (gains.mode!=Mode::LQR)
+        return true;
+
+    // Linearised around upright with the wheel speed following the duty with a first order lag
+    //   v'     = (vmax*u - v) / tau
+    //   tilt'' = c * (g*tilt - v'),   c = m*h / (I + m*h^2)
+    const double ml = model.body_mass * model.body_height;
+    const double c = ml / (model.body_inertia + ml*model.body_height);
+    const double tau = model.wheel_time_constant;
+    const double vmax = model.wheel_speed_max;
+    const Matrix<4, 4, double> A {
+        0.0,        1.0, 0.0, 0.0,
+        c*GRAVITY,  0.0, 0.0, c/tau,
+        0.0,        0.0, 0.0, 1.0,
+        0.0,        0.0, 0.0, -1.0/tau,
+    };
+    const Matrix<4, 1, double> B { 0.0, -c*vmax/tau, 0.0, vmax/tau };
+
+    Matrix<4, 4, double> Q;
+    Q(TILT, TILT) = gains.q_tilt;
+    Q(TILT_RATE, TILT_RATE) = gains.q_tilt_rate;
+    Q(POSITION, POSITION) = gains.q_position;
+    Q(VELOCITY, VELOCITY) = gains.q_velocity;
+    const Matrix<1, 1, double> R { gains.r_duty };
+
+    Matrix<4, 4, double> Ad;
+    Matrix<4, 1, double> Bd;
+    Robot::Math::discretize(A, B, static_cast<double>(m_Ts.count()), Ad, Bd);
+    Matrix<1, 4, double> K;
+    if (gains.r_duty<=0.0f || !Robot::Math::dlqr(Ad, Bd, Q, R, K)) {
+        BOOST_LOG_TRIVIAL(warning) << "Balancing LQR gain could not be solved, using the cascade";
+        return false;
+    }
+    m_lqr_gain = K.cast<float>();
+    m_mode = Mode::LQR;
+
+    BOOST_LOG_TRIVIAL(info) << boost::format("Balancing LQR gain [%.3f %.3f %.3f %.3f]") % m_lqr_gain[TILT] % m_lqr_gain[TILT_RATE] % m_lqr_gain[POSITION] % m_lqr_gain[VELOCITY];
+    return true;
+}
+
+
+void BalanceController::reset(float position)
+{
+    m_position = position;
+    m_tilt_reference = 0.0f;
+    m_angle_pid.reset();
+    m_velocity_pid.reset();
+}
+
+
+float BalanceController::update(const state_type &state)
+{
+    // The position reference travels with the commanded velocity
+    m_position += m_velocity * m_Ts.count();
+
+    if (m_mode==Mode::LQR) {
+        auto error = state;
+        error[POSITION] -= m_position;
+        error[VELOCITY] -= m_velocity;
+        return std::clamp(-(m_lqr_gain*error)[0], -1.0f, 1.0f);
+    }
+
+    // Outer loops, lean into the wanted acceleration
+    m_velocity_pid.setSetpoint(m_velocity + m_gains.position_p*(m_position-state[POSITION]));
+    m_tilt_reference = m_velocity_pid.update(state[VELOCITY]);
+
+    // Inner loop drives the wheels under the lean. The PID sees the tilt mirrored,
+    // leaning further forward than the reference has to drive forward.
+    m_angle_pid.setSetpoint(-m_tilt_reference);
+    auto duty = m_angle_pid.update(-state[TILT]) + m_gains.angle_d*state[TILT_RATE];
+    return std::clamp(duty, -1.0f, 1.0f);
+}
+
+
+
+std::ostream &operator<<(std::ostream &os, const BalanceController::Mode &mode)
+{
+    switch (mode) {
+        case BalanceController::Mode::CASCADE:
+            return os << "CASCADE";
+        case BalanceController::Mode::LQR:
+            return os << "LQR";
+    }
+    return os;
+}
+
+}
@@ -0,0 +1,117 @@
+#ifndef _ROBOT_KINEMATIC_BALANCECONTROLLER_H_
+#define _ROBOT_KINEMATIC_BALANCECONTROLLER_H_
+
+#include <cstddef>
+#include <iostream>
+
+#include <math/pid.h>
+#include <math/matrix.h>
+
+namespace Robot::Kinematic {
+
+    /**
+     * Balancing controller for the rover standing on its rear axle.
+     *
+     * The state is the tilt from upright (rad, positive leaning forward), the tilt
+     * rate (rad/s), the axle position (m) and the axle velocity (m/s). The output is
+     * the common duty of the rear wheels. Two structures are available:
+     *
+     *  - CASCADE: the position error adds to the velocity reference, a velocity PI
+     *    turns it into a tilt reference and the angle PD(I) drives the wheels.
+     *  - LQR: full state feedback u = -K(x - x_ref), K is solved in configure() from
+     *    a model linearised around upright and built from the chassis constants.
+     *
+     * configure() may allocate and iterate, update() only does a few fixed size
+     * operations and is meant to be called at the IMU rate.
+     */
+    class BalanceController {
+        public:
+            using sample_time_type = Robot::Math::PID::sample_time_type;
+            using state_type = Robot::Math::Vector<4>;
+            using gain_type = Robot::Math::Matrix<1, 4>;
+
+            enum class Mode {
+                CASCADE,
+                LQR,
+            };
+
+            struct Gains {
+                Mode mode;
+                // Cascade
+                float angle_p;
+                float angle_i;
+                float angle_d;          // Applied to the measured tilt rate
+                float velocity_p;
+                float velocity_i;
+                float position_p;
+                float tilt_max;         // rad, limit of the tilt reference
+                // LQR weights
+                float q_tilt;
+                float q_tilt_rate;
+                float q_position;
+                float q_velocity;
+                float r_duty;
+
+                static Gains defaults();
+            };
+
+            struct Model {
+                float body_mass;        // kg
+                float body_height;      // m, axle to center of mass
+                float body_inertia;     // kg*m^2 around the center of mass
+                float wheel_speed_max;  // m/s at full duty without load
+                float wheel_time_constant; // s
+
+                static Model defaults();
+            };
+
+            explicit BalanceController(sample_time_type Ts);
+            BalanceController(const BalanceController&) = delete; // No copy constructor
+            BalanceController(BalanceController&&) = delete; // No move constructor
+
+            /**
+             * @brief Set the gains and, in LQR mode, solve the state feedback gain
+             *
+             * @return false if the LQR gain could not be solved, the cascade is then used
+             */
+            bool configure(const Gains &gains, const Model &model = Model::defaults());
+            const Gains &gains() const { return m_gains; }
+            Mode mode() const { return m_mode; }
+            const gain_type &lqrGain() const { return m_lqr_gain; }
+
+            /// Velocity to drive at (m/s), zero holds the position
+            void setVelocity(float velocity) { m_velocity = velocity; }
+            float getVelocity() const { return m_velocity; }
+
+            /// Restart with the position reference at the given position
+            void reset(float position = 0.0f);
+
+            /// Evaluate one sample, returns the duty
+            float update(const state_type &state);
+
+            float getTiltReference() const { return m_tilt_reference; }
+
+            static constexpr std::size_t TILT { 0 };
+            static constexpr std::size_t TILT_RATE { 1 };
+            static constexpr std::size_t POSITION { 2 };
+            static constexpr std::size_t VELOCITY { 3 };
+
+        private:
+            const sample_time_type m_Ts;
+            Gains m_gains;
+            Mode m_mode;
+
+            Robot::Math::PID m_angle_pid;
+            Robot::Math::PID m_velocity_pid;
+            gain_type m_lqr_gain;
+
+            float m_velocity;
+            float m_position;
+            float m_tilt_reference;
+    };
+
+    std::ostream &operator<<(std::ostream &os, const BalanceController::Mode &mode);
+
+}
+
+#endif
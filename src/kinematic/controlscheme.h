@@ -13,6 +13,7 @@ namespace Robot::Kinematic {
             virtual void cleanup() = 0;
 
             virtual void updateOrientation(Orientation orientation) = 0;
+            virtual void updateThrottleMode(ThrottleMode mode) = 0;
 
             virtual void idle() {};
             virtual void steer(float steering, float throttle, float aux_x, float aux_y) = 0;
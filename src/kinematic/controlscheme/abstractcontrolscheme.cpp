@@ -1,13 +1,18 @@
 #include "abstractcontrolscheme.h"
 
+#include <algorithm>
 #include <boost/log/trivial.hpp>
 
+#include <robotconfig.h>
+
 #include <motor/motor.h>
 #include <motor/servo.h>
 #include <motor/control.h>
 #include "../types.h"
 
 
+using namespace Robot::Config;
+
 namespace Robot::Kinematic {
 
 
@@ -15,8 +20,7 @@ AbstractControlScheme::AbstractControlScheme(std::shared_ptr<Kinematic> kinemati
     WithStrand { kinematic->strand() },
     m_initialized { false },
     m_orientation { Orientation::NORTH },
-    m_orientation_reverse { false },
-    m_motor_map { MOTOR_MAP_NORTH },
+    m_throttle_mode { ThrottleMode::DUTY },
     m_context { kinematic->context() },
     m_motor_control { kinematic->motorControl() },
     m_last_steering { 0.0f },
@@ -24,6 +28,7 @@ AbstractControlScheme::AbstractControlScheme(std::shared_ptr<Kinematic> kinemati
     m_last_aux_x { 0.0f },
     m_last_aux_y { 0.0f }
 {
+    m_motor_throttle.fill(0.0f);
 }
 
 
@@ -31,25 +36,8 @@ void AbstractControlScheme::updateOrientation(Orientation orientation)
 {
     BOOST_LOG_TRIVIAL(info) << "UpdateOrientation: " << orientation;
     if (m_orientation!=orientation) {
+        // The mixers hold a table per orientation
         m_orientation = orientation;
-        switch (orientation) {
-        case Orientation::NORTH:
-            m_motor_map = MOTOR_MAP_NORTH;
-            m_orientation_reverse = false;
-            break;
-        case Orientation::SOUTH:
-            m_motor_map = MOTOR_MAP_SOUTH;
-            m_orientation_reverse = true;
-            break;
-        case Orientation::WEST:
-            m_orientation_reverse = false;
-            m_motor_map = MOTOR_MAP_WEST;
-            break;
-        case Orientation::EAST:
-            m_orientation_reverse = true;
-            m_motor_map = MOTOR_MAP_EAST;
-            break;
-        }
         if (m_initialized) {
             orientationUpdated(orientation);
         }
@@ -57,4 +45,44 @@ void AbstractControlScheme::updateOrientation(Orientation orientation)
 }
 
 
+
+void AbstractControlScheme::updateThrottleMode(ThrottleMode mode)
+{
+    if (m_throttle_mode!=mode) {
+        m_throttle_mode = mode;
+        if (m_initialized) {
+            steer(m_last_steering, m_last_throttle, m_last_aux_x, m_last_aux_y);
+        }
+    }
+}
+
+
+void AbstractControlScheme::mixMotors(const Mixer &mixer, const ChassisCommand &command)
+{
+    const auto output = mixer.mix(m_orientation, command);
+    for (std::size_t i=0; i<output.servo.size(); i++) {
+        m_transaction.setServo(i, output.servo[i]);
+    }
+    m_motor_throttle = output.throttle;
+}
+
+
+void AbstractControlScheme::applyMotors()
+{
+    switch (m_throttle_mode) {
+        case ThrottleMode::DUTY:
+            m_transaction.setDuty(m_motor_throttle);
+            break;
+        case ThrottleMode::RPM: {
+            Motor::MotorValues rpm;
+            std::transform(m_motor_throttle.begin(), m_motor_throttle.end(), rpm.begin(), [](auto throttle) { return throttle*WHEEL_MAX_RPM; });
+            m_transaction.setTargetRPM(rpm);
+            break;
+        }
+    }
+    m_motor_control->commit(m_transaction);
+    m_transaction.clear();
+}
+
+
 }
\ No newline at end of file
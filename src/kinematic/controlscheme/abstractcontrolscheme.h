@@ -13,6 +13,7 @@
 #include <rc/receiver.h>
 #include "../controlscheme.h"
 #include "../kinematic.h"
+#include "../mixer.h"
 
 namespace Robot::Kinematic {
 
@@ -21,6 +22,7 @@ namespace Robot::Kinematic {
             virtual ~AbstractControlScheme() { }
 
             virtual void updateOrientation(Orientation orientation) override;
+            virtual void updateThrottleMode(ThrottleMode mode) override;
 
             virtual void steer(float steering, float throttle, float aux_x, float aux_y) override {}
 
@@ -29,8 +31,9 @@ namespace Robot::Kinematic {
 
             bool m_initialized;
             Orientation m_orientation;
-            bool m_orientation_reverse;
-            MotorMap m_motor_map;
+            ThrottleMode m_throttle_mode;
+            Motor::MotorValues m_motor_throttle;
+            Motor::Transaction m_transaction;
             std::shared_ptr<Robot::Context> m_context;
             std::shared_ptr<Robot::Motor::Control> m_motor_control;
 
@@ -39,6 +42,7 @@ namespace Robot::Kinematic {
             float m_last_aux_x;
             float m_last_aux_y;
 
+            /// Schemes are reused between activations, init() clears the last command
             void setLastSteering(float steering, float throttle, float aux_x, float aux_y) 
             {
                 m_last_steering = steering;
@@ -47,24 +51,19 @@ namespace Robot::Kinematic {
                 m_last_aux_y = aux_y;
             }
 
-            inline auto &motor(MotorPosition position) const 
-            {
-                return m_motor_control->getMotors()[m_motor_map[static_cast<uint>(position)].index];
-            }
-            inline void motorServo(MotorPosition position, Value value) {
-                auto &entry = m_motor_map[static_cast<uint>(position)];
-                m_motor_control->getMotors()[entry.index]->servo()->setValue(entry.invert ? -value : value);
-            }
-            inline void motorDuty(MotorPosition position, float value) {
-                auto &entry = m_motor_map[static_cast<uint>(position)];
-                m_motor_control->getMotors()[entry.index]->setDuty(entry.invert_duty ? -value : value);
-            }
-            inline void motorSet(MotorPosition position, Value servo, float throttle) {
-                auto &entry = m_motor_map[static_cast<uint>(position)];
-                auto &motor = m_motor_control->getMotors()[entry.index];
-                motor->servo()->setValue(entry.invert ? -servo : servo);
-                motor->setDuty(entry.invert_duty ? -throttle : throttle);
-            }
+            /**
+             * @brief Mix a chassis command for the current orientation
+             *
+             * The servo values and throttle are staged and sent by applyMotors()
+             */
+            void mixMotors(const Mixer &mixer, const ChassisCommand &command);
+            /**
+             * @brief Commit the staged servo values and throttle as one command set
+             * 
+             * Depending on the throttle mode the throttle is either set as duty, or 
+             * scaled to a target RPM held by the motor RPM loop.
+             */
+            void applyMotors();
 
             virtual void orientationUpdated(Orientation orientation) {
                 steer(m_last_steering, m_last_throttle, m_last_aux_x, m_last_aux_y);
@@ -14,9 +14,10 @@ using namespace Robot::Config;
 
 namespace Robot::Kinematic {
 
-AbstractWheelSteering::AbstractWheelSteering(std::shared_ptr<Kinematic> kinematic, float wheel_base_factor) :
+AbstractWheelSteering::AbstractWheelSteering(std::shared_ptr<Kinematic> kinematic, const Ackermann &geometry, const Mixer &mixer) :
     AbstractControlScheme { kinematic },
-    m_wheel_base_factor { wheel_base_factor }
+    m_geometry { geometry },
+    m_mixer { mixer }
 {
 
 }
@@ -25,6 +26,7 @@ AbstractWheelSteering::AbstractWheelSteering(std::shared_ptr<Kinematic> kinemati
 void AbstractWheelSteering::init() 
 {
     resetMotors(0.0f, 0.0f);
+    applyMotors();
 
     const auto &motors = m_motor_control->getMotors();
     for (auto &motor : motors) {
@@ -34,6 +36,7 @@ void AbstractWheelSteering::init()
 
     }
 
+    setLastSteering(0.0f, 0.0f, 0.0f, 0.0f);
     m_initialized = true;
 }
 
@@ -56,10 +59,7 @@ void AbstractWheelSteering::cleanup()
 
 void AbstractWheelSteering::resetMotors(float throttle, float skew)
 {
-    motorSet(MotorPosition::FRONT_LEFT, Value::fromAngle(WHEEL_STRAIGHT_ANGLE - skew), throttle);
-    motorSet(MotorPosition::FRONT_RIGHT,Value::fromAngle(WHEEL_STRAIGHT_ANGLE + skew), throttle);
-    motorSet(MotorPosition::REAR_LEFT,  Value::fromAngle(WHEEL_STRAIGHT_ANGLE + skew), throttle);
-    motorSet(MotorPosition::REAR_RIGHT, Value::fromAngle(WHEEL_STRAIGHT_ANGLE - skew), throttle);
+    mixMotors(MIXER_STRAIGHT, ChassisCommand { 0.0f, 0.0f, skew, throttle, throttle });
 }
 
 
@@ -73,13 +73,11 @@ void AbstractWheelSteering::steer(float steering, float throttle, float aux_x, f
     const auto asteering = std::abs(steering);
     
     auto skew = aux_x * WHEEL_MAX_TURN_ANGLE * std::max(0.0f, 1.0f-4.0f*asteering);
-    if (m_orientation_reverse) {
-        skew = -skew;        
-    }
 
     // Just go straight (to avoid infinite numbers for turning radius)
     if (asteering < 0.01) {
         resetMotors(throttle, skew);
+        applyMotors();
         return;
     }
     else if (asteering> 0.25f) {
@@ -89,22 +87,17 @@ void AbstractWheelSteering::steer(float steering, float throttle, float aux_x, f
     // Inner angle is just the fraction of steering times max turn angle
     auto inner_angle = asteering * (WHEEL_MAX_TURN_ANGLE-std::abs(skew));
 
-    // Inner wheel turning circle center from inner wheels centerpoint.
-    auto inner_circle_dist = tan(M_PI_2-inner_angle) * m_wheel_base_factor;
-
-    // Calculate outer angle
-    auto outer_angle = atan(m_wheel_base_factor/(inner_circle_dist+WHEEL_BASE_MM));
-    // Outer turning circle radius
-    auto outer_circle_dist = tan(M_PI_2-outer_angle) * m_wheel_base_factor;
+    // Outer wheel angle and the slower inner wheels on the smaller circle, see Ackermann
+    const auto geometry = m_geometry.lookup(inner_angle);
+    auto inner_throttle = throttle * geometry.ratio;
 
     if (steering > 0.0) {
-        setMotors(-outer_angle, inner_angle, skew);
-        setMotorDuty(steering, throttle, outer_circle_dist, inner_circle_dist, inner_angle);
+        mixMotors(m_mixer, ChassisCommand { -geometry.outer_angle, inner_angle, skew, throttle, inner_throttle });
     }
     else {
-        setMotors(inner_angle, -outer_angle, skew);
-        setMotorDuty(steering, throttle, outer_circle_dist, inner_circle_dist, inner_angle);
+        mixMotors(m_mixer, ChassisCommand { inner_angle, -geometry.outer_angle, skew, inner_throttle, throttle });
     }
+    applyMotors();
 
 }
 
@@ -9,6 +9,7 @@
 
 #include "abstractcontrolscheme.h"
 #include "../types.h"
+#include "../ackermann.h"
 
 namespace Robot::Kinematic {
 
@@ -21,14 +22,13 @@ namespace Robot::Kinematic {
 
 
         protected:
-            AbstractWheelSteering(std::shared_ptr<Kinematic> kinematic, float wheel_base_factor);
+            AbstractWheelSteering(std::shared_ptr<Kinematic> kinematic, const Ackermann &geometry, const Mixer &mixer);
 
             void resetMotors(float throttle, float skew);
-            virtual void setMotors(float left, float right, float skew) = 0;
-            virtual void setMotorDuty(float steering, float throttle, float outer_dist, float inner_dist, float inner_angle) = 0;
 
         private:
-            const float m_wheel_base_factor;
+            const Ackermann &m_geometry;
+            const Mixer &m_mixer;
 
     };
 
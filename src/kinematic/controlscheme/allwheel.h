@@ -13,10 +13,6 @@ namespace Robot::Kinematic {
             ControlSchemeAllWheel(const ControlSchemeAllWheel&) = delete; // No copy constructor
             ControlSchemeAllWheel(ControlSchemeAllWheel&&) = delete; // No move constructor
             virtual ~ControlSchemeAllWheel();
-
-        protected:
-            virtual void setMotors(float left, float right, float skew) override;
-            virtual void setMotorDuty(float steering, float throttle, float outer_dist, float inner_dist, float inner_angle) override;
     };
 
 }
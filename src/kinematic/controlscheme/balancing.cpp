@@ -5,11 +5,14 @@
 
 #include <cmath>
 #include <array>
+#include <algorithm>
+#include <boost/format.hpp>
 #include <boost/log/trivial.hpp>
 
 #include <robotconfig.h>
 #include <robotcontext.h>
 #include <common/properties.h>
+#include <metrics/probes.h>
 #include <motor/motor.h>
 #include <motor/servo.h>
 #include <motor/control.h>
@@ -25,15 +28,34 @@ using namespace Robot::Config;
 namespace Robot::Kinematic {
 
 static constexpr auto PROPERTY_GROUP { "balancing" };
+static constexpr auto PROPERTY_CONTROLLER { "controller" };
 static constexpr auto PROPERTY_PID_P { "pid_p" };
 static constexpr auto PROPERTY_PID_I { "pid_i" };
 static constexpr auto PROPERTY_PID_D { "pid_d" };
+static constexpr auto PROPERTY_VELOCITY_P { "velocity_p" };
+static constexpr auto PROPERTY_VELOCITY_I { "velocity_i" };
+static constexpr auto PROPERTY_POSITION_P { "position_p" };
+static constexpr auto PROPERTY_TILT_MAX { "tilt_max" };
+static constexpr auto PROPERTY_LQR_Q_TILT { "lqr_q_tilt" };
+static constexpr auto PROPERTY_LQR_Q_TILT_RATE { "lqr_q_tilt_rate" };
+static constexpr auto PROPERTY_LQR_Q_POSITION { "lqr_q_position" };
+static constexpr auto PROPERTY_LQR_Q_VELOCITY { "lqr_q_velocity" };
+static constexpr auto PROPERTY_LQR_R { "lqr_r" };
+static constexpr auto PROPERTY_SPEED_MAX { "speed_max" };
+static constexpr auto PROPERTY_TURN_MAX { "turn_max" };
 static constexpr auto PROPERTY_ANGLE { "angle" };
 
+static constexpr auto CONTROLLER_CASCADE { "cascade" };
+static constexpr auto CONTROLLER_LQR { "lqr" };
 
-static constexpr auto BALANCE_P { 1.0f } ;
-static constexpr auto BALANCE_I { 10.0f } ;
-static constexpr auto BALANCE_D { 0.0f } ;
+static constexpr auto SPEED_MAX { 0.3f };   // m/s at full throttle
+static constexpr auto TURN_MAX { 0.2f };    // Duty difference between the wheels at full steering
+
+// Rear wheels of the physical chassis, the balancing scheme ignores the orientation
+static constexpr auto &LEFT_ENTRY { MOTOR_MAP_NORTH[static_cast<uint>(MotorPosition::REAR_LEFT)] };
+static constexpr auto &RIGHT_ENTRY { MOTOR_MAP_NORTH[static_cast<uint>(MotorPosition::REAR_RIGHT)] };
+static constexpr auto METERS_PER_COUNT { WHEEL_CIRC_MM / (1000.0f*WHEEL_ENCODER_CPR*WHEEL_GEARING) };
+static constexpr auto METERS_PER_SECOND_PER_RPM { WHEEL_CIRC_MM / (1000.0f*60.0f) };
 
 
 static constexpr auto CRITICAL_ANGLE_DEGREES { 30.0f };
@@ -47,7 +69,8 @@ static constexpr auto WARNING_ANGLE { static_cast<float>(WARNING_ANGLE_DEGREES*M
 static constexpr auto ARM_GRACE_PERIOD { 4s };
 
 static constexpr auto INIT_DELAY { 500ms };
-static constexpr Robot::Math::PID::sample_time_type BALANCE_INTERVAL { 10ms };
+static constexpr BalanceController::sample_time_type BALANCE_INTERVAL { 10ms };
+static constexpr auto LOG_INTERVAL { 100ms };
 
 
 
@@ -57,9 +80,22 @@ ControlSchemeBalancing::ControlSchemeBalancing(std::shared_ptr<Kinematic> kinema
     m_led_control { kinematic->ledControl() },
     m_layer { std::make_shared<LED::ColorLayer>("balancing", LED::LAYER_BALANCE_INDICATORS) },
     m_init_timer { m_context->io() },
-    m_armed { false },
     m_state { State::IDLE },
-    m_pid { BALANCE_P, BALANCE_I, BALANCE_D, BALANCE_INTERVAL }
+    m_active { false },
+    m_armed { false },
+    m_angle { 0.0f },
+    m_duty { 0.0f },
+    m_velocity { 0.0f },
+    m_turn { 0.0f },
+    m_supervise_pending { false },
+    m_speed_max { SPEED_MAX },
+    m_turn_max { TURN_MAX },
+    m_controller { BALANCE_INTERVAL },
+    m_last_tilt { 0.0f },
+    m_left_motor { m_motor_control->getMotor(LEFT_ENTRY.index).get() },
+    m_right_motor { m_motor_control->getMotor(RIGHT_ENTRY.index).get() },
+    m_perf { Metrics::PerfLoop::get("balancing") },
+    m_latency { Metrics::registry().histogram("robot_balancing_latency_seconds", "Delay from IMU sample delivery until the balancing duty was written to the motors") }
 {
 }
 
@@ -72,10 +108,23 @@ ControlSchemeBalancing::~ControlSchemeBalancing()
 
 void ControlSchemeBalancing::registerProperties(const std::shared_ptr<Context> &context)
 {
+    const auto gains = BalanceController::Gains::defaults();
     PropertyMap values;
-    values.put(PROPERTY_PID_P, BALANCE_P);
-    values.put(PROPERTY_PID_I, BALANCE_I);
-    values.put(PROPERTY_PID_D, BALANCE_D);
+    values.put(PROPERTY_CONTROLLER, std::string(CONTROLLER_CASCADE));
+    values.put(PROPERTY_PID_P, gains.angle_p);
+    values.put(PROPERTY_PID_I, gains.angle_i);
+    values.put(PROPERTY_PID_D, gains.angle_d);
+    values.put(PROPERTY_VELOCITY_P, gains.velocity_p);
+    values.put(PROPERTY_VELOCITY_I, gains.velocity_i);
+    values.put(PROPERTY_POSITION_P, gains.position_p);
+    values.put(PROPERTY_TILT_MAX, gains.tilt_max);
+    values.put(PROPERTY_LQR_Q_TILT, gains.q_tilt);
+    values.put(PROPERTY_LQR_Q_TILT_RATE, gains.q_tilt_rate);
+    values.put(PROPERTY_LQR_Q_POSITION, gains.q_position);
+    values.put(PROPERTY_LQR_Q_VELOCITY, gains.q_velocity);
+    values.put(PROPERTY_LQR_R, gains.r_duty);
+    values.put(PROPERTY_SPEED_MAX, SPEED_MAX);
+    values.put(PROPERTY_TURN_MAX, TURN_MAX);
     values.put(PROPERTY_ANGLE, BASE_ANGLE);
     context->registerProperties(PROPERTY_GROUP, values);
 }
@@ -84,13 +133,30 @@ void ControlSchemeBalancing::registerProperties(const std::shared_ptr<Context> &
 void ControlSchemeBalancing::init() 
 {
     m_initialized = true;
+    setLastSteering(0.0f, 0.0f, 0.0f, 0.0f);
 
     const auto &properties = m_context->properties(PROPERTY_GROUP);
-    m_pid.set(properties.get(PROPERTY_PID_P, BALANCE_P), properties.get(PROPERTY_PID_I, BALANCE_I), properties.get(PROPERTY_PID_D, BALANCE_D));
-    m_pid.setLimits(-1.0f, 1.0f);
+    auto gains = BalanceController::Gains::defaults();
+    gains.mode = properties.get(PROPERTY_CONTROLLER, std::string(CONTROLLER_CASCADE))==CONTROLLER_LQR ? BalanceController::Mode::LQR : BalanceController::Mode::CASCADE;
+    gains.angle_p = properties.get(PROPERTY_PID_P, gains.angle_p);
+    gains.angle_i = properties.get(PROPERTY_PID_I, gains.angle_i);
+    gains.angle_d = properties.get(PROPERTY_PID_D, gains.angle_d);
+    gains.velocity_p = properties.get(PROPERTY_VELOCITY_P, gains.velocity_p);
+    gains.velocity_i = properties.get(PROPERTY_VELOCITY_I, gains.velocity_i);
+    gains.position_p = properties.get(PROPERTY_POSITION_P, gains.position_p);
+    gains.tilt_max = properties.get(PROPERTY_TILT_MAX, gains.tilt_max);
+    gains.q_tilt = properties.get(PROPERTY_LQR_Q_TILT, gains.q_tilt);
+    gains.q_tilt_rate = properties.get(PROPERTY_LQR_Q_TILT_RATE, gains.q_tilt_rate);
+    gains.q_position = properties.get(PROPERTY_LQR_Q_POSITION, gains.q_position);
+    gains.q_velocity = properties.get(PROPERTY_LQR_Q_VELOCITY, gains.q_velocity);
+    gains.r_duty = properties.get(PROPERTY_LQR_R, gains.r_duty);
+    m_controller.configure(gains);
+    BOOST_LOG_TRIVIAL(info) << "Balancing controller " << m_controller.mode();
+    m_speed_max = properties.get(PROPERTY_SPEED_MAX, SPEED_MAX);
+    m_turn_max = properties.get(PROPERTY_TURN_MAX, TURN_MAX);
     m_base_angle = properties.get(PROPERTY_ANGLE, BASE_ANGLE);
-    m_pid.setSetpoint(m_base_angle);
-    m_pid.reset();
+    m_velocity = 0.0f;
+    m_turn = 0.0f;
 
     m_layer->fill(LED::Color::TRANSPARENT);
     m_layer->setVisible(true);
@@ -101,11 +167,14 @@ void ControlSchemeBalancing::init()
     m_state = State::IDLE;
     m_armed = false;
     m_armed_grace = false;
+    m_last_log = clock_type::now();
 
     initMotors();
+    m_active = true;
 
     if (auto telemetry = m_telemetry.lock()) {
         m_imu_connection = telemetry->sig_imu.connect(Telemetry::IMUSignal::slot_type(&ControlSchemeBalancing::onIMUData, this, boost::placeholders::_1));
+        m_imu_activation = telemetry->acquire("mpu");
     }
 
     m_init_timer.expires_after(INIT_DELAY);
@@ -148,6 +217,7 @@ void ControlSchemeBalancing::initMotors()
         auto &motor = motors[static_cast<uint>(MotorPosition::REAR_LEFT)];
         motor->setDuty(0.0);
         motor->setEnabled(false);
+        motor->setDirect();
         motor->servo()->setValue(Value::fromAngle(WHEEL_STRAIGHT_ANGLE));
         motor->servo()->setEnabled(true);
     }
@@ -155,6 +225,7 @@ void ControlSchemeBalancing::initMotors()
         auto &motor = motors[static_cast<uint>(MotorPosition::REAR_RIGHT)];
         motor->setDuty(0.0);
         motor->setEnabled(false);
+        motor->setDirect();
         motor->servo()->setValue(Value::fromAngle(WHEEL_STRAIGHT_ANGLE));
         motor->servo()->setEnabled(true);
     }
@@ -164,7 +235,9 @@ void ControlSchemeBalancing::initMotors()
 
 void ControlSchemeBalancing::cleanup() 
 {
+    m_active = false;
     m_imu_connection.disconnect();
+    m_imu_activation.reset();
 
     if (!m_initialized) 
         return;
@@ -186,6 +259,7 @@ void ControlSchemeBalancing::cleanup()
         motor->setDuty(0.0);
     }
 
+    m_armed = false;
     m_state = State::IDLE;
 }
 
@@ -193,30 +267,22 @@ void ControlSchemeBalancing::cleanup()
 
 void ControlSchemeBalancing::arm() 
 {
-    auto &left_motor = m_motor_control->getMotor(static_cast<uint>(MotorPosition::REAR_LEFT));
-    auto &right_motor = m_motor_control->getMotor(static_cast<uint>(MotorPosition::REAR_RIGHT));
-
-    m_pid.reset();
-
-    left_motor->resetOdometer();
-    left_motor->setDuty(0.0);
-    left_motor->setEnabled(true);
-    right_motor->resetOdometer();
-    right_motor->setDuty(0.0);
-    right_motor->setEnabled(true);
-
-    m_armed = true;
+    // The fast path leaves the controller alone until m_armed is set
+    m_left_motor->resetOdometer();
+    m_left_motor->setEnabled(true);
+    m_right_motor->resetOdometer();
+    m_right_motor->setEnabled(true);
+    m_controller.reset(position());
+
+    m_armed.store(true, std::memory_order_release);
 }
 
 void ControlSchemeBalancing::disarm() 
 {
-    auto &left_motor = m_motor_control->getMotor(static_cast<uint>(MotorPosition::REAR_LEFT));
-    auto &right_motor = m_motor_control->getMotor(static_cast<uint>(MotorPosition::REAR_RIGHT));
+    m_armed.store(false, std::memory_order_release);
 
-    left_motor->setEnabled(false);
-    right_motor->setEnabled(false);
-
-    m_armed = false;
+    m_left_motor->setEnabled(false);
+    m_right_motor->setEnabled(false);
 }
 
 
@@ -275,74 +341,124 @@ void ControlSchemeBalancing::updateState(State state)
     }
 }
 
-void ControlSchemeBalancing::onIMUData(const Telemetry::IMUData &imu_data)
+void ControlSchemeBalancing::steer(float steering, float throttle, float aux_x, float aux_y)
 {
-    dispatch([this,imu_data]{
-        if (!m_initialized) 
-            return;
+    setLastSteering(steering, throttle, aux_x, aux_y);
+    m_velocity.store(throttle*m_speed_max, std::memory_order_relaxed);
+    m_turn.store(steering*m_turn_max, std::memory_order_relaxed);
+}
 
-        auto angle = imu_data.dmp_TaitBryan[TB_PITCH_X];
-        auto diff = std::abs<float>(angle-m_base_angle);
 
-        if (diff>CRITICAL_ANGLE) {
-            updateState(State::CRITICAL);
-            if (m_armed) {
-                disarm();
-            }
-            m_armed_grace = false;
-        }
-        else if (diff>WARNING_ANGLE) {
-            updateState(State::WARNING);
-            m_armed_grace = false;
-        }
-        else if (m_armed) {
-            updateState(State::OK);
+inline float ControlSchemeBalancing::position() const
+{
+    auto left = LEFT_ENTRY.invert_duty ? -m_left_motor->getEncoderValue() : m_left_motor->getEncoderValue();
+    auto right = RIGHT_ENTRY.invert_duty ? -m_right_motor->getEncoderValue() : m_right_motor->getEncoderValue();
+    return (left+right)*METERS_PER_COUNT/2.0f;
+}
+
+
+inline float ControlSchemeBalancing::velocity() const
+{
+    auto left = LEFT_ENTRY.invert_duty ? -m_left_motor->getRPM() : m_left_motor->getRPM();
+    auto right = RIGHT_ENTRY.invert_duty ? -m_right_motor->getRPM() : m_right_motor->getRPM();
+    return (left+right)*METERS_PER_SECOND_PER_RPM/2.0f;
+}
+
+
+void ControlSchemeBalancing::supervise()
+{
+    m_supervise_pending.store(false, std::memory_order_release);
+    if (!m_initialized) 
+        return;
+
+    auto angle = m_angle.load(std::memory_order_relaxed);
+    auto diff = std::abs(angle-m_base_angle);
+    auto armed = m_armed.load(std::memory_order_relaxed);
+
+    if (diff>CRITICAL_ANGLE) {
+        updateState(State::CRITICAL);
+        if (armed) {
+            disarm();
         }
-        else {
-            if (m_armed_grace) {
-                // In arm grace period
-                if ( (clock_type::now()-m_armed_grace_start) > ARM_GRACE_PERIOD ) {
-                    BOOST_LOG_TRIVIAL(info) << "Robot armed";
-                    arm();
-                    updateState(State::OK);
-                }
-                else {
-                    updateState(State::GRACE);
-                }
+        m_armed_grace = false;
+    }
+    else if (diff>WARNING_ANGLE) {
+        updateState(State::WARNING);
+        m_armed_grace = false;
+    }
+    else if (armed) {
+        updateState(State::OK);
+    }
+    else {
+        if (m_armed_grace) {
+            // In arm grace period
+            if ( (clock_type::now()-m_armed_grace_start) > ARM_GRACE_PERIOD ) {
+                BOOST_LOG_TRIVIAL(info) << "Robot armed";
+                arm();
+                updateState(State::OK);
             }
             else {
-                // Start arm grace period
-                BOOST_LOG_TRIVIAL(info) << "Arm grace period begin";
-                m_armed_grace = true;
-                m_armed_grace_start = clock_type::now();
                 updateState(State::GRACE);
             }
         }
-
-        float duty = 0.0f;
-        if (m_armed) {
-            duty = m_pid.update(angle);
-            BOOST_LOG_TRIVIAL(info) << "Duty " << boost::format("%.2f") % duty;
-        }
         else {
-            duty = 0.0f;
-        }
-        auto &left_motor = m_motor_control->getMotor(static_cast<uint>(MotorPosition::REAR_LEFT));
-        auto &right_motor = m_motor_control->getMotor(static_cast<uint>(MotorPosition::REAR_RIGHT));
-        left_motor->setDuty(duty);
-        right_motor->setDuty(duty);
-
-        auto now = clock_type::now();
-        static std::chrono::high_resolution_clock::time_point last;
-        if ((now-last) > 100ms) {
-            BOOST_LOG_TRIVIAL(info) 
-                << boost::format("angle: %.2f   diff: %.2f") % angle 
-                << "  armed: "  << m_armed 
-                << "  state: " << static_cast<int>(m_state) 
-                << "  duty: " << boost::format("%.2f") % duty;
-            last = now;
+            // Start arm grace period
+            BOOST_LOG_TRIVIAL(info) << "Arm grace period begin";
+            m_armed_grace = true;
+            m_armed_grace_start = clock_type::now();
+            updateState(State::GRACE);
         }
-    });
+    }
+
+    auto now = clock_type::now();
+    if ((now-m_last_log) > LOG_INTERVAL) {
+        BOOST_LOG_TRIVIAL(info) 
+            << boost::format("angle: %.2f   diff: %.2f") % angle % diff
+            << "  armed: "  << m_armed.load(std::memory_order_relaxed)
+            << "  state: " << static_cast<int>(m_state) 
+            << "  duty: " << boost::format("%.2f") % m_duty.load(std::memory_order_relaxed);
+        m_last_log = now;
+    }
+}
+
+
+void ControlSchemeBalancing::onIMUData(const Telemetry::IMUData &imu_data)
+{
+    // Fast path, runs in the MPU interrupt thread. The duty is computed and
+    // written to the motor drivers here, without locks or a hop to the io threads.
+    if (!m_active.load(std::memory_order_acquire)) 
+        return;
+    const auto start = clock_type::now();
+    const Metrics::PerfLoop::Scope perf { *m_perf };
+
+    auto angle = static_cast<float>(imu_data.dmp_TaitBryan[TB_PITCH_X]);
+    auto tilt = m_base_angle - angle;
+    auto tilt_rate = (tilt - m_last_tilt) / BALANCE_INTERVAL.count();
+    m_last_tilt = tilt;
+
+    auto duty = 0.0f;
+    auto left = 0.0f;
+    auto right = 0.0f;
+    // Cut the motors on the first sample past the critical angle, the supervisor disarms
+    if (m_armed.load(std::memory_order_acquire) && std::abs(tilt)<=CRITICAL_ANGLE) {
+        m_controller.setVelocity(m_velocity.load(std::memory_order_relaxed));
+        duty = m_controller.update({ tilt, tilt_rate, position(), velocity() });
+        auto turn = m_turn.load(std::memory_order_relaxed);
+        left = std::clamp(duty+turn, -1.0f, 1.0f);
+        right = std::clamp(duty-turn, -1.0f, 1.0f);
+    }
+    m_left_motor->writeDirect(LEFT_ENTRY.invert_duty ? -left : left);
+    m_right_motor->writeDirect(RIGHT_ENTRY.invert_duty ? -right : right);
+
+    m_latency->observe(clock_type::now()-start);
+    ROBOT_PROBE2(balancing__write, ROBOT_PROBE_MILLI(angle), ROBOT_PROBE_MILLI(duty));
+
+    // Arming, LEDs and logging follow on the strand with the latest sample, at most one is queued
+    m_angle.store(angle, std::memory_order_relaxed);
+    m_duty.store(duty, std::memory_order_relaxed);
+    if (!m_supervise_pending.exchange(true, std::memory_order_acq_rel)) {
+        post([this]{ supervise(); });
+    }
 }
 
 
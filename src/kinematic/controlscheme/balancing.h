@@ -3,6 +3,7 @@
 
 #include <memory>
 #include <chrono>
+#include <atomic>
 #include <boost/asio.hpp>
 
 #include <robotconfig.h>
@@ -11,8 +12,10 @@
 
 #include <telemetry/telemetry.h>
 #include <led/types.h>
-#include <math/pid.h>
+#include <metrics/perfcounters.h>
+#include <metrics/metrics.h>
 #include "abstractcontrolscheme.h"
+#include "../balancecontroller.h"
 
 namespace Robot::Kinematic {
 
@@ -28,6 +31,11 @@ namespace Robot::Kinematic {
             virtual void init() override;
             virtual void cleanup() override;
 
+            /**
+             * @brief Throttle sets the velocity held by the balancing controller and steering turns on the spot
+             */
+            virtual void steer(float steering, float throttle, float aux_x, float aux_y) override;
+
 
             static void registerProperties(const std::shared_ptr<Context> &context);
 
@@ -47,14 +55,33 @@ namespace Robot::Kinematic {
 
             boost::asio::steady_timer m_init_timer;
             boost::signals2::connection m_imu_connection;
+            std::shared_ptr<Robot::Telemetry::Activation> m_imu_activation;
 
             bool m_armed_grace;
             clock_type::time_point m_armed_grace_start;
-            bool m_armed;
+            clock_type::time_point m_last_log;
             State m_state;
             float m_base_angle;
 
-            Robot::Math::PID m_pid;
+            // Shared between the strand and the fast path in the MPU interrupt thread
+            std::atomic<bool> m_active;
+            std::atomic<bool> m_armed;
+            std::atomic<float> m_angle;
+            std::atomic<float> m_duty;
+            std::atomic<float> m_velocity;
+            std::atomic<float> m_turn;
+            std::atomic<bool> m_supervise_pending;
+            float m_speed_max;
+            float m_turn_max;
+
+            // Only touched by the fast path while armed
+            BalanceController m_controller;
+            float m_last_tilt;
+            Robot::Motor::Motor *m_left_motor;
+            Robot::Motor::Motor *m_right_motor;
+
+            std::shared_ptr<Metrics::PerfLoop> m_perf;
+            std::shared_ptr<Metrics::Histogram> m_latency;
 
             void initMotors();
 
@@ -63,6 +90,10 @@ namespace Robot::Kinematic {
 
             inline void updateState(State state);
 
+            inline float position() const;
+            inline float velocity() const;
+
+            void supervise();
             void onIMUData(const Robot::Telemetry::IMUData &data);
     };
 
@@ -13,10 +13,6 @@ namespace Robot::Kinematic {
             ControlSchemeFrontWheel(const ControlSchemeFrontWheel&) = delete; // No copy constructor
             ControlSchemeFrontWheel(ControlSchemeFrontWheel&&) = delete; // No move constructor
             virtual ~ControlSchemeFrontWheel();
-
-        protected:
-            virtual void setMotors(float left, float right, float skew) override;
-            virtual void setMotorDuty(float steering, float throttle, float outer_dist, float inner_dist, float inner_angle) override;
     };
 
 }
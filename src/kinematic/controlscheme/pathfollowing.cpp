@@ -0,0 +1,167 @@
+#include "pathfollowing.h"
+
+#include <cmath>
+#include <chrono>
+#include <algorithm>
+#include <boost/log/trivial.hpp>
+
+#include <robotconfig.h>
+#include <robotcontext.h>
+#include <common/properties.h>
+#include <motor/motor.h>
+#include <motor/servo.h>
+#include <motor/control.h>
+#include "../types.h"
+
+using namespace std::literals;
+using namespace Robot::Config;
+
+namespace Robot::Kinematic {
+
+static constexpr auto PROPERTY_GROUP { "path" };
+static constexpr auto PROPERTY_LOOKAHEAD { "lookahead" };
+
+static constexpr auto LOOKAHEAD { 250.0f };         // mm
+static constexpr auto APPROACH_THROTTLE { 0.3f };   // Fraction of the throttle left when reaching the end
+static constexpr auto UPDATE_INTERVAL { 20ms };
+static constexpr auto ODOMETER_STEP_MAX { 100 };    // mm per update, larger steps are odometer resets
+
+
+
+ControlSchemePathFollowing::ControlSchemePathFollowing(std::shared_ptr<Kinematic> kinematic) :
+    AbstractWheelSteering { kinematic, ACKERMANN_ALL_WHEEL, MIXER_ALL_WHEEL },
+    m_kinematic { kinematic },
+    m_timer { m_context->io() },
+    m_pursuit { LOOKAHEAD },
+    m_last_odometer { 0 },
+    m_curvature { 0.0f },
+    m_throttle { 0.0f },
+    m_done { true },
+    m_update_duration { Metrics::registry().histogram("robot_path_update_seconds", "Time spent on a path following update") }
+{
+}
+
+
+ControlSchemePathFollowing::~ControlSchemePathFollowing()
+{
+    cleanup();
+}
+
+
+void ControlSchemePathFollowing::registerProperties(const std::shared_ptr<Context> &context)
+{
+    PropertyMap values;
+    values.put(PROPERTY_LOOKAHEAD, LOOKAHEAD);
+    context->registerProperties(PROPERTY_GROUP, values);
+}
+
+
+void ControlSchemePathFollowing::init()
+{
+    AbstractWheelSteering::init();
+
+    const auto &properties = m_context->properties(PROPERTY_GROUP);
+    m_pursuit.setLookahead(properties.get(PROPERTY_LOOKAHEAD, LOOKAHEAD));
+    m_throttle = 0.0f;
+
+    if (auto kinematic = m_kinematic.lock()) {
+        start(kinematic);
+    }
+
+    m_timer.expires_at(std::chrono::steady_clock::now());
+    startTimer();
+}
+
+
+void ControlSchemePathFollowing::cleanup()
+{
+    if (!m_initialized)
+        return;
+    m_timer.cancel();
+    AbstractWheelSteering::cleanup();
+}
+
+
+void ControlSchemePathFollowing::start(const std::shared_ptr<Kinematic> &kinematic)
+{
+    // The path frame is the pose the rover has now
+    m_pursuit.setPath(kinematic->getPath());
+    m_pose = Pose {};
+    m_last_odometer = kinematic->getOdometer();
+    m_curvature = 0.0f;
+    m_done = !m_pursuit.getPath();
+}
+
+
+void ControlSchemePathFollowing::startTimer()
+{
+    m_timer.expires_at(m_timer.expiry() + UPDATE_INTERVAL);
+    m_timer.async_wait(boost::asio::bind_executor(m_strand,
+        [this] (boost::system::error_code error) {
+            if (error!=boost::system::errc::success || !m_initialized) {
+                return;
+            }
+            update();
+            startTimer();
+        }
+    ));
+}
+
+
+void ControlSchemePathFollowing::steer(float steering, float throttle, float aux_x, float aux_y)
+{
+    // Only moving forward along the path, the next update applies it
+    m_throttle = std::max(throttle, 0.0f);
+}
+
+
+void ControlSchemePathFollowing::update()
+{
+    auto kinematic = m_kinematic.lock();
+    if (!kinematic)
+        return;
+
+    const auto start_time = std::chrono::steady_clock::now();
+
+    if (kinematic->getPath()!=m_pursuit.getPath()) {
+        start(kinematic);
+    }
+
+    // Dead reckoning on the curvature commanded since the last update
+    const auto odometer = kinematic->getOdometer();
+    const auto distance = odometer-m_last_odometer;
+    if (std::abs(distance)<=ODOMETER_STEP_MAX) {
+        m_pose.advance(static_cast<float>(distance), m_curvature);
+    }
+    m_last_odometer = odometer;
+
+    auto steering = 0.0f;
+    auto throttle = 0.0f;
+    if (!m_done) {
+        const auto command = m_pursuit.update(m_pose);
+        if (command.done) {
+            BOOST_LOG_TRIVIAL(info) << "Path completed at " << m_pose.x << "," << m_pose.y;
+            m_done = true;
+        }
+        else {
+            // Positive steering turns right, positive curvature turns left
+            const auto inner_angle = ACKERMANN_ALL_WHEEL.innerAngle(command.curvature);
+            steering = -std::copysign(inner_angle/WHEEL_MAX_TURN_ANGLE, command.curvature);
+            const auto lookahead = m_pursuit.getLookahead();
+            throttle = m_throttle * std::clamp(command.remaining/lookahead, APPROACH_THROTTLE, 1.0f);
+        }
+    }
+
+    AbstractWheelSteering::steer(steering, throttle, 0.0f, 0.0f);
+    // Replays on orientation or throttle mode changes go through steer() with the input throttle
+    setLastSteering(0.0f, m_throttle, 0.0f, 0.0f);
+
+    // Going straight below the steering threshold of the wheel steering
+    const auto asteering = std::abs(steering);
+    m_curvature = asteering<0.01f ? 0.0f : -std::copysign(ACKERMANN_ALL_WHEEL.curvature(asteering*WHEEL_MAX_TURN_ANGLE), steering);
+
+    m_update_duration->observe(std::chrono::steady_clock::now() - start_time);
+}
+
+
+}
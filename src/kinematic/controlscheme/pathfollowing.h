@@ -0,0 +1,56 @@
+#ifndef _ROBOT_KINEMATIC_CONTROLSCHEMEPATHFOLLOWING_H_
+#define _ROBOT_KINEMATIC_CONTROLSCHEMEPATHFOLLOWING_H_
+
+#include <memory>
+#include <boost/asio.hpp>
+
+#include <metrics/metrics.h>
+#include "abstractwheelsteering.h"
+#include "../path.h"
+
+namespace Robot::Kinematic {
+
+    /**
+     * Follows the path set with Kinematic::setPath() using pure pursuit on top of
+     * the all wheel steering geometry.
+     *
+     * The pose is dead reckoned from the kinematic odometer and the commanded
+     * turning curvature, starting from the path origin when the scheme is
+     * activated or a new path is set. The input throttle sets the speed, the
+     * steering input is ignored.
+     */
+    class ControlSchemePathFollowing : public AbstractWheelSteering, public std::enable_shared_from_this<ControlSchemePathFollowing> {
+        public:
+            explicit ControlSchemePathFollowing(std::shared_ptr<Kinematic> kinematic);
+            ControlSchemePathFollowing(const ControlSchemePathFollowing&) = delete; // No copy constructor
+            ControlSchemePathFollowing(ControlSchemePathFollowing&&) = delete; // No move constructor
+            virtual ~ControlSchemePathFollowing();
+
+            virtual void init() override;
+            virtual void cleanup() override;
+
+            virtual void steer(float steering, float throttle, float aux_x, float aux_y) override;
+
+            static void registerProperties(const std::shared_ptr<Context> &context);
+
+        private:
+            std::weak_ptr<Kinematic> m_kinematic;
+            boost::asio::steady_timer m_timer;
+
+            PurePursuit m_pursuit;
+            Pose m_pose;
+            Kinematic::odometer_type m_last_odometer;
+            float m_curvature;
+            float m_throttle;
+            bool m_done;
+
+            std::shared_ptr<Metrics::Histogram> m_update_duration;
+
+            void start(const std::shared_ptr<Kinematic> &kinematic);
+            void startTimer();
+            void update();
+    };
+
+}
+
+#endif
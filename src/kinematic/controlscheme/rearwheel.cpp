@@ -15,7 +15,7 @@ using namespace Robot::Config;
 namespace Robot::Kinematic {
 
 ControlSchemeRearWheel::ControlSchemeRearWheel(std::shared_ptr<Kinematic> kinematic) :
-    AbstractWheelSteering { kinematic, WHEEL_BASE_2_MM }
+    AbstractWheelSteering { kinematic, ACKERMANN_SINGLE_AXLE, MIXER_REAR_WHEEL }
 {
 }
 
@@ -25,31 +25,4 @@ ControlSchemeRearWheel::~ControlSchemeRearWheel()
 }
 
 
-void ControlSchemeRearWheel::setMotors(float left, float right, float skew) 
-{
-    motorServo(MotorPosition::REAR_LEFT,  Value::fromAngle(WHEEL_STRAIGHT_ANGLE+left-skew));
-    motorServo(MotorPosition::REAR_RIGHT, Value::fromAngle(WHEEL_STRAIGHT_ANGLE+right+skew));
-    motorServo(MotorPosition::FRONT_LEFT,  Value::fromAngle(WHEEL_STRAIGHT_ANGLE+skew));
-    motorServo(MotorPosition::FRONT_RIGHT, Value::fromAngle(WHEEL_STRAIGHT_ANGLE-skew));
-}
-
-
-void ControlSchemeRearWheel::setMotorDuty(float steering, float throttle, float outer_dist, float inner_dist, float inner_angle)
-{
-    auto factor = inner_dist/outer_dist;
-    if (steering>=0.0f) {
-        motorDuty(MotorPosition::FRONT_LEFT, throttle);
-        motorDuty(MotorPosition::FRONT_RIGHT, throttle*factor);
-        motorDuty(MotorPosition::REAR_LEFT, throttle);
-        motorDuty(MotorPosition::REAR_RIGHT, throttle*factor);
-    }
-    else {
-        motorDuty(MotorPosition::FRONT_LEFT, throttle*factor);
-        motorDuty(MotorPosition::FRONT_RIGHT, throttle);
-        motorDuty(MotorPosition::REAR_LEFT, throttle*factor);
-        motorDuty(MotorPosition::REAR_RIGHT, throttle);
-    }
-}
-
-
 }
\ No newline at end of file
@@ -13,10 +13,6 @@ namespace Robot::Kinematic {
             ControlSchemeRearWheel(const ControlSchemeRearWheel&) = delete; // No copy constructor
             ControlSchemeRearWheel(ControlSchemeRearWheel&&) = delete; // No move constructor
             virtual ~ControlSchemeRearWheel();
-
-        protected:
-            virtual void setMotors(float left, float right, float skew) override;
-            virtual void setMotorDuty(float steering, float throttle, float outer_dist, float inner_dist, float inner_angle) override;
     };
 
 }
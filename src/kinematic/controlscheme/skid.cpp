@@ -32,6 +32,7 @@ ControlSchemeSkid::~ControlSchemeSkid()
 void ControlSchemeSkid::init() 
 {
     resetMotors();
+    applyMotors();
 
     const auto &motors = m_motor_control->getMotors();
     for (auto &motor : motors) {
@@ -41,6 +42,7 @@ void ControlSchemeSkid::init()
 
     }
 
+    setLastSteering(0.0f, 0.0f, 0.0f, 0.0f);
     m_initialized = true;
 }
 
@@ -62,10 +64,7 @@ void ControlSchemeSkid::cleanup()
 
 void ControlSchemeSkid::resetMotors()
 {
-    motorSet(MotorPosition::FRONT_LEFT, Value::fromAngle(WHEEL_STRAIGHT_ANGLE), 0.0f);
-    motorSet(MotorPosition::FRONT_RIGHT,Value::fromAngle(WHEEL_STRAIGHT_ANGLE), 0.0f);
-    motorSet(MotorPosition::REAR_LEFT,  Value::fromAngle(WHEEL_STRAIGHT_ANGLE), 0.0f);
-    motorSet(MotorPosition::REAR_RIGHT, Value::fromAngle(WHEEL_STRAIGHT_ANGLE), 0.0f);
+    mixMotors(MIXER_STRAIGHT, ChassisCommand {});
 }
 
 
@@ -75,9 +74,6 @@ void ControlSchemeSkid::steer(float steering, float throttle, float aux_x, float
     setLastSteering(steering, throttle, aux_x, aux_y);
 
     auto skew = aux_x * WHEEL_MAX_TURN_ANGLE;
-    if (m_orientation_reverse) {
-        skew = -skew;        
-    }
 
     float left, right;
 
@@ -104,10 +100,8 @@ void ControlSchemeSkid::steer(float steering, float throttle, float aux_x, float
 
     //BOOST_LOG_TRIVIAL(info) << " steer " << boost::format("| %+.2f | %+.2f  ||  %+.2f | %+.2f |") % steering % throttle % left % right;
 
-    motorSet(MotorPosition::FRONT_LEFT, Value::fromAngle(WHEEL_STRAIGHT_ANGLE - skew), left);
-    motorSet(MotorPosition::FRONT_RIGHT,Value::fromAngle(WHEEL_STRAIGHT_ANGLE + skew), right);
-    motorSet(MotorPosition::REAR_LEFT,  Value::fromAngle(WHEEL_STRAIGHT_ANGLE + skew), left);
-    motorSet(MotorPosition::REAR_RIGHT, Value::fromAngle(WHEEL_STRAIGHT_ANGLE - skew), right);
+    mixMotors(MIXER_STRAIGHT, ChassisCommand { 0.0f, 0.0f, skew, left, right });
+    applyMotors();
 }
 
 
@@ -34,6 +34,7 @@ void ControlSchemeSpinning::init()
         motor->servo()->setEnabled(true);
     }
 
+    setLastSteering(0.0f, 0.0f, 0.0f, 0.0f);
     m_initialized = true;
 }
 
@@ -48,11 +49,12 @@ void ControlSchemeSpinning::cleanup()
 
 void ControlSchemeSpinning::steer(float steering, float throttle, float aux_x, float aux_y)
 {
-    const auto duty = THROTTLE_SCALE * throttle;
-    const auto &motors = m_motor_control->getMotors();
-    for (auto &motor : motors) {
-        motor->setDuty(duty);
-    }
+    setLastSteering(steering, throttle, aux_x, aux_y);
+
+    // Opposite throttle on the two sides makes it spin
+    auto scaled = THROTTLE_SCALE * throttle;
+    mixMotors(MIXER_SPINNING, ChassisCommand { 0.0f, 0.0f, 0.0f, scaled, -scaled });
+    applyMotors();
 }
 
 
@@ -1,7 +1,11 @@
 #include "kinematic.h"
 
+#include <chrono>
 #include <boost/log/trivial.hpp>
 
+#include <robotlogging.h>
+#include <metrics/trace.h>
+#include <metrics/probes.h>
 #include <robotcontext.h>
 #include <motor/control.h>
 #include <motor/motor.h>
@@ -15,6 +19,7 @@
 #include "controlscheme/skid.h"
 #include "controlscheme/spinning.h"
 #include "controlscheme/balancing.h"
+#include "controlscheme/pathfollowing.h"
 
 
 using namespace std::literals;
@@ -22,6 +27,9 @@ using namespace std::literals;
 
 namespace Robot::Kinematic {
 
+static constexpr auto SWITCH_BUDGET { 5ms };
+static constexpr auto REPLAY_INTERVAL { 10ms };
+
 
 std::ostream &operator<<(std::ostream &os, const DriveMode &drivemode)
 {
@@ -33,11 +41,40 @@ std::ostream &operator<<(std::ostream &os, const DriveMode &drivemode)
     SKID,
     SPINNING,
     BALANCING,
+    PATH,
     */
    return os;
 }
 
 
+std::ostream &operator<<(std::ostream &os, const ThrottleMode &mode)
+{
+    switch (mode) {
+        case ThrottleMode::DUTY:
+            os << "DUTY";
+            break;
+        case ThrottleMode::RPM:
+            os << "RPM";
+            break;
+    }
+    return os;
+}
+
+
+std::ostream &operator<<(std::ostream &os, const ReplaySync &sync)
+{
+    switch (sync) {
+        case ReplaySync::TIME:
+            os << "TIME";
+            break;
+        case ReplaySync::DISTANCE:
+            os << "DISTANCE";
+            break;
+    }
+    return os;
+}
+
+
 std::ostream &operator<<(std::ostream &os, const Orientation &orientation)
 {
     switch (orientation) {
@@ -64,11 +101,21 @@ Kinematic::Kinematic(const std::shared_ptr<Robot::Context> &context) :
     m_initialized { false },
     m_context { context },
     m_drive_mode { DriveMode::NONE },
-    m_orientation { Orientation::NORTH }
+    m_orientation { Orientation::NORTH },
+    m_throttle_mode { ThrottleMode::DUTY },
+    m_steer { 0.0f, 0.0f, 0.0f, 0.0f },
+    m_steer_pending { false },
+    m_steer_coalesced { Metrics::registry().counter("robot_kinematic_steer_coalesced", "Steer commands replaced by a newer one before they were applied") },
+    m_switch_duration { Metrics::registry().histogram("robot_kinematic_switch_duration_seconds", "Time spent switching drive mode") },
+    m_switch_overruns { Metrics::registry().counter("robot_kinematic_switch_overruns", "Drive mode switches exceeding the switch budget") },
+    m_replay_timer { context->io() },
+    m_recording { false },
+    m_replaying { false }
 {
-    #if ROBOT_HAVE_BALANCING
+    #if ROBOT_HAVE_BALANCE
     ControlSchemeBalancing::registerProperties(context);
     #endif
+    ControlSchemePathFollowing::registerProperties(context);
 }
 
 Kinematic::~Kinematic() 
@@ -89,7 +136,20 @@ void Kinematic::init(const std::shared_ptr<Robot::Motor::Control> &motor_control
     m_odometer_base = 0;
     m_motor_update_connection = motor_control->sig_motor.connect([this](auto &motors) { onMotorUpdate(motors); });
 
-    m_control_scheme = std::make_shared<ControlSchemeIdle>(shared_from_this());
+    auto self = shared_from_this();
+    auto scheme = [this](DriveMode mode) -> auto & { return m_control_schemes[static_cast<std::size_t>(mode)]; };
+    scheme(DriveMode::NONE)        = std::make_shared<ControlSchemeIdle>(self);
+    scheme(DriveMode::ALL_WHEEL)   = std::make_shared<ControlSchemeAllWheel>(self);
+    scheme(DriveMode::FRONT_WHEEL) = std::make_shared<ControlSchemeFrontWheel>(self);
+    scheme(DriveMode::REAR_WHEEL)  = std::make_shared<ControlSchemeRearWheel>(self);
+    scheme(DriveMode::SKID)        = std::make_shared<ControlSchemeSkid>(self);
+    scheme(DriveMode::SPINNING)    = std::make_shared<ControlSchemeSpinning>(self);
+    #if ROBOT_HAVE_BALANCE
+    scheme(DriveMode::BALANCING)   = std::make_shared<ControlSchemeBalancing>(self);
+    #endif
+    scheme(DriveMode::PATH)        = std::make_shared<ControlSchemePathFollowing>(self);
+
+    m_control_scheme = scheme(DriveMode::NONE);
     m_drive_mode = DriveMode::NONE;
 
     m_axis_connection        = input_control->signals.steer.connect([this](auto d, auto f, auto ax, auto ay){ onSteer(d, f, ax, ay); });
@@ -109,10 +169,22 @@ void Kinematic::cleanup()
     m_orientation_connection.disconnect();
     m_motor_update_connection.disconnect();
 
+    m_replay_timer.cancel();
+    m_player.reset();
+    m_replaying = false;
+    if (m_recorder) {
+        m_recorder->stop();
+        m_recorder.reset();
+    }
+    m_recording = false;
+
     if (m_control_scheme) {
         m_control_scheme->cleanup();
         m_control_scheme = nullptr;
     }
+    for (auto &scheme : m_control_schemes) {
+        scheme.reset();
+    }
     m_motor_control.reset();
     m_led_control.reset();
     m_telemetry.reset();
@@ -129,40 +201,29 @@ void Kinematic::setDriveMode(DriveMode mode)
     m_drive_mode = mode;
 
     dispatch([this, mode]{
+        const auto start = std::chrono::steady_clock::now();
         m_control_scheme->cleanup();
-        m_control_scheme = nullptr;
         BOOST_LOG_TRIVIAL(info) << "Control Scheme " << static_cast<int>(mode);
 
-        switch (mode) {
-        case DriveMode::ALL_WHEEL:
-            m_control_scheme = std::make_shared<ControlSchemeAllWheel>(shared_from_this());
-            break;
-        case DriveMode::FRONT_WHEEL:
-            m_control_scheme = std::make_shared<ControlSchemeFrontWheel>(shared_from_this());
-            break;
-        case DriveMode::REAR_WHEEL:
-            m_control_scheme = std::make_shared<ControlSchemeRearWheel>(shared_from_this());
-            break;
-        case DriveMode::SKID:
-            m_control_scheme = std::make_shared<ControlSchemeSkid>(shared_from_this());
-            break;
-        case DriveMode::SPINNING:
-            m_control_scheme = std::make_shared<ControlSchemeSpinning>(shared_from_this());
-            break;
-        #if ROBOT_HAVE_BALANCING
-        case DriveMode::BALANCING:
-            m_control_scheme = std::make_shared<ControlSchemeBalancing>(shared_from_this());
-            break;
-        #endif
-        default:
-            m_control_scheme = std::make_shared<ControlSchemeIdle>(shared_from_this());
+        if (const auto &scheme = m_control_schemes[static_cast<std::size_t>(mode)]) {
+            m_control_scheme = scheme;
+        }
+        else {
+            m_control_scheme = m_control_schemes[static_cast<std::size_t>(DriveMode::NONE)];
             m_drive_mode = DriveMode::NONE;
-            break;
         }
 
         m_control_scheme->updateOrientation(m_orientation);
+        m_control_scheme->updateThrottleMode(m_throttle_mode);
         m_control_scheme->init();
 
+        const auto duration = std::chrono::steady_clock::now() - start;
+        m_switch_duration->observe(duration);
+        if (duration>SWITCH_BUDGET) {
+            m_switch_overruns->inc();
+            BOOST_LOG_TRIVIAL(warning) << "Drive mode switch took " << std::chrono::duration_cast<std::chrono::microseconds>(duration).count() << "us";
+        }
+
         notify(NOTIFY_DEFAULT);
     });
 }
@@ -205,6 +266,22 @@ void Kinematic::setOrientation(Orientation orientation)
 }
 
 
+void Kinematic::setThrottleMode(ThrottleMode mode)
+{
+    const guard lock(m_mutex);
+    if (mode==m_throttle_mode)
+        return;
+
+    m_throttle_mode = mode;
+
+    dispatch([this,mode]{
+        BOOST_LOG_TRIVIAL(info) << "Kinematic throttle mode: " << mode;
+        m_control_scheme->updateThrottleMode(mode);
+        notify(NOTIFY_DEFAULT);
+    });
+}
+
+
 void Kinematic::resetOdometer()
 {
     const guard lock(m_mutex);
@@ -219,6 +296,25 @@ void Kinematic::resetOdometer()
 }
 
 
+void Kinematic::setPath(const std::vector<Point> &waypoints, bool spline)
+{
+    // Resampled here so the strand only swaps the pointer
+    auto path = std::make_shared<const Path>(waypoints, spline);
+    BOOST_LOG_TRIVIAL(info) << "Kinematic path: " << waypoints.size() << " waypoints, " << path->length() << "mm";
+    dispatch([this, path]{
+        m_path = path;
+    });
+}
+
+
+void Kinematic::clearPath()
+{
+    dispatch([this]{
+        m_path.reset();
+    });
+}
+
+
 
 void Kinematic::onMotorUpdate(const ::Robot::Motor::MotorList &motors)
 {
@@ -248,11 +344,147 @@ void Kinematic::onMotorUpdate(const ::Robot::Motor::MotorList &motors)
 
 void Kinematic::onSteer(float steering, float throttle, float aux_x, float aux_y) 
 {
-    BOOST_LOG_TRIVIAL(trace) << "Kinematic onSteer " << steering << " " << throttle;
-    dispatch([this,steering,throttle,aux_x,aux_y]{
-        m_control_scheme->steer(steering, throttle, aux_x, aux_y);
+    ROBOT_LOG(trace) << "Kinematic onSteer " << steering << " " << throttle;
+    ROBOT_TRACE_INSTANT("kinematic.steer");
+    ROBOT_PROBE4(kinematic__steer, ROBOT_PROBE_MILLI(steering), ROBOT_PROBE_MILLI(throttle), ROBOT_PROBE_MILLI(aux_x), ROBOT_PROBE_MILLI(aux_y));
+    {
+        const std::lock_guard<std::mutex> lock(m_steer_mutex);
+        m_steer = SteerCommand { steering, throttle, aux_x, aux_y };
+    }
+    // At most one apply is queued, it picks up the latest command when it runs
+    if (m_steer_pending.exchange(true, std::memory_order_acq_rel)) {
+        m_steer_coalesced->inc();
+        return;
+    }
+    dispatch([this]{ applySteer(); });
+}
+
+
+void Kinematic::applySteer()
+{
+    ROBOT_TRACE_SCOPE("kinematic.steer.apply");
+    // Clear before reading, a command arriving after the read queues a new apply
+    m_steer_pending.store(false, std::memory_order_release);
+    if (m_player)
+        return;
+    SteerCommand command;
+    {
+        const std::lock_guard<std::mutex> lock(m_steer_mutex);
+        command = m_steer;
+    }
+    if (m_recorder) {
+        m_recorder->record(TrajectoryRecorder::clock_type::now(), m_odometer, command.steering, command.throttle, command.aux_x, command.aux_y);
+    }
+    m_control_scheme->steer(command.steering, command.throttle, command.aux_x, command.aux_y);
+}
+
+
+
+void Kinematic::startRecording(const std::string &filename)
+{
+    const guard lock(m_mutex);
+    auto recorder = std::make_shared<TrajectoryRecorder>(m_context->io(), filename, m_drive_mode);
+    BOOST_LOG_TRIVIAL(info) << "Kinematic recording " << filename;
+
+    dispatch([this, recorder]{
+        if (m_recorder) {
+            m_recorder->stop();
+        }
+        const auto now = TrajectoryRecorder::clock_type::now();
+        recorder->start(now, m_odometer);
+        // Starts from the command in effect
+        SteerCommand command;
+        {
+            const std::lock_guard<std::mutex> lock(m_steer_mutex);
+            command = m_steer;
+        }
+        recorder->record(now, m_odometer, command.steering, command.throttle, command.aux_x, command.aux_y);
+        m_recorder = recorder;
+        m_recording = true;
+        notify(NOTIFY_DEFAULT);
+    });
+}
+
+
+void Kinematic::stopRecording()
+{
+    dispatch([this]{
+        if (!m_recorder)
+            return;
+        m_recorder->stop();
+        m_recorder.reset();
+        m_recording = false;
+        notify(NOTIFY_DEFAULT);
     });
 }
 
 
+void Kinematic::startReplay(const std::string &filename, ReplaySync sync)
+{
+    auto player = std::make_shared<TrajectoryPlayer>(filename, sync);
+    BOOST_LOG_TRIVIAL(info) << "Kinematic replay " << filename << " " << sync;
+
+    // Queued ahead of the replay start, so the replay begins in the new scheme
+    setDriveMode(player->driveMode());
+    dispatch([this, player]{
+        const auto now = TrajectoryPlayer::clock_type::now();
+        player->start(now, m_odometer);
+        m_player = player;
+        m_replaying = true;
+        m_replay_timer.expires_at(now);
+        replayUpdate();
+        notify(NOTIFY_DEFAULT);
+    });
+}
+
+
+void Kinematic::stopReplay()
+{
+    dispatch([this]{
+        if (!m_player)
+            return;
+        m_replay_timer.cancel();
+        replayEnd();
+    });
+}
+
+
+void Kinematic::replayTimer()
+{
+    m_replay_timer.expires_at(m_replay_timer.expiry() + REPLAY_INTERVAL);
+    m_replay_timer.async_wait(boost::asio::bind_executor(m_strand,
+        [this](boost::system::error_code error) {
+            if (error!=boost::system::errc::success || !m_player) {
+                return;
+            }
+            replayUpdate();
+        }
+    ));
+}
+
+
+void Kinematic::replayUpdate()
+{
+    if (auto sample = m_player->poll(TrajectoryPlayer::clock_type::now(), m_odometer)) {
+        m_control_scheme->steer(sample->steering, sample->throttle, sample->aux_x, sample->aux_y);
+    }
+    if (m_player->done()) {
+        BOOST_LOG_TRIVIAL(info) << "Kinematic replay done";
+        replayEnd();
+        return;
+    }
+    replayTimer();
+}
+
+
+void Kinematic::replayEnd()
+{
+    // Never leave the rover driving on the last recorded command
+    m_player.reset();
+    m_replaying = false;
+    m_control_scheme->steer(0.0f, 0.0f, 0.0f, 0.0f);
+    notify(NOTIFY_DEFAULT);
+}
+
+
 }
\ No newline at end of file
@@ -2,7 +2,11 @@
 #define _ROBOT_KINEMATIC_KINEMATIC_H_
 
 #include <memory>
+#include <string>
 #include <mutex>
+#include <array>
+#include <vector>
+#include <atomic>
 
 #include <robottypes.h>
 #include <common/withstrand.h>
@@ -12,7 +16,10 @@
 #include <telemetry/telemetry.h>
 #include <led/control.h>
 #include <rc/receiver.h>
+#include <metrics/metrics.h>
 #include "types.h"
+#include "path.h"
+#include "trajectory.h"
 
 namespace Robot::Kinematic {
 
@@ -39,9 +46,47 @@ namespace Robot::Kinematic {
             void setOrientation(Orientation orientation);
             Orientation getOrientation() const { return m_orientation; }
 
+            void setThrottleMode(ThrottleMode mode);
+            ThrottleMode getThrottleMode() const { return m_throttle_mode; }
+
             odometer_type getOdometer() const { return m_odometer; }
             void resetOdometer();
 
+            /**
+             * @brief Set the path followed in DriveMode::PATH
+             *
+             * The waypoints are in mm relative to the pose of the rover when it starts
+             * following the path, x forward and y to the left. Following restarts from
+             * the current pose when a new path is set.
+             *
+             * @param waypoints At least two points
+             * @param spline Join the waypoints with a spline instead of straight lines
+             */
+            void setPath(const std::vector<Point> &waypoints, bool spline = false);
+            void clearPath();
+            /// Current path, only to be read on the kinematic strand
+            const std::shared_ptr<const Path> &getPath() const { return m_path; }
+
+            /**
+             * @brief Record the applied steer commands to a file until stopRecording()
+             *
+             * The recording holds the drive mode at the start, the steer commands with
+             * their time and the odometer. Throws if the file can not be created.
+             */
+            void startRecording(const std::string &filename);
+            void stopRecording();
+            bool isRecording() const { return m_recording; }
+
+            /**
+             * @brief Replay a recording in the drive mode it was recorded in
+             *
+             * Steer input is ignored until the replay ends or stopReplay() is called.
+             * Throws if the file is not a recording.
+             */
+            void startReplay(const std::string &filename, ReplaySync sync = ReplaySync::TIME);
+            void stopReplay();
+            bool isReplaying() const { return m_replaying; }
+
 
             const std::shared_ptr<::Robot::Context> &context() const { return m_context; }
             const std::shared_ptr<::Robot::Motor::Control> &motorControl() { return m_motor_control; }
@@ -57,6 +102,8 @@ namespace Robot::Kinematic {
             std::weak_ptr<::Robot::LED::Control> m_led_control;
             std::weak_ptr<::Robot::Telemetry::Telemetry> m_telemetry;
             std::shared_ptr<class ControlScheme> m_control_scheme;
+            // Every scheme is constructed in init(), switching only deactivates one and activates another
+            std::array<std::shared_ptr<class ControlScheme>, static_cast<std::size_t>(DriveMode::PATH)+1> m_control_schemes;
 
             boost::signals2::connection m_motor_update_connection;
             boost::signals2::connection m_axis_connection;
@@ -65,11 +112,38 @@ namespace Robot::Kinematic {
 
             DriveMode    m_drive_mode;
             Orientation  m_orientation;
+            ThrottleMode m_throttle_mode;
             odometer_type m_odometer;
             odometer_type m_odometer_base;
             MotorMap m_motor_map;
+            std::shared_ptr<const Path> m_path;
+
+            struct SteerCommand {
+                float steering;
+                float throttle;
+                float aux_x;
+                float aux_y;
+            };
+            // Latest steer command, newer commands overwrite it before it is applied
+            std::mutex m_steer_mutex;
+            SteerCommand m_steer;
+            std::atomic<bool> m_steer_pending;
+            std::shared_ptr<Metrics::Counter> m_steer_coalesced;
+            std::shared_ptr<Metrics::Histogram> m_switch_duration;
+            std::shared_ptr<Metrics::Counter> m_switch_overruns;
+
+            // Teach and repeat
+            std::shared_ptr<TrajectoryRecorder> m_recorder;
+            std::shared_ptr<TrajectoryPlayer> m_player;
+            boost::asio::steady_timer m_replay_timer;
+            std::atomic<bool> m_recording;
+            std::atomic<bool> m_replaying;
 
             void onSteer(float steering, float throttle, float aux_x, float aux_y);
+            void applySteer();
+            void replayTimer();
+            void replayUpdate();
+            void replayEnd();
 
             void onMotorUpdate(const ::Robot::Motor::MotorList &motors);
 
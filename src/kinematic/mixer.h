@@ -0,0 +1,177 @@
+#ifndef _ROBOT_KINEMATIC_MIXER_H_
+#define _ROBOT_KINEMATIC_MIXER_H_
+
+#include <array>
+#include <cstddef>
+
+#include <robotconfig.h>
+#include <math/matrix.h>
+#include <motor/types.h>
+#include "types.h"
+
+namespace Robot::Kinematic {
+
+    /**
+     * Command of a control scheme in the chassis frame, independent of the orientation.
+     */
+    struct ChassisCommand {
+        float left_angle { 0.0f };      ///< rad, steering of the left wheels
+        float right_angle { 0.0f };     ///< rad, steering of the right wheels
+        float skew { 0.0f };            ///< rad, crab angle
+        float left_throttle { 0.0f };
+        float right_throttle { 0.0f };
+    };
+
+
+    /**
+     * Turns a ChassisCommand into the servo value and throttle of each motor.
+     *
+     * A layout is a table with an angle row and a throttle row per wheel position
+     * (in MotorPosition order, angle rows first) over the command vector
+     * {left_angle, right_angle, skew, left_throttle, right_throttle, 1}, where the
+     * last column holds the constant offset.
+     *
+     * The motor map of each orientation is folded into a copy of the table when the
+     * mixer is constructed, so mixing is a single matrix product and changing the
+     * orientation only selects another table.
+     */
+    class Mixer {
+        public:
+            static constexpr std::size_t INPUTS { 6 };
+            static constexpr std::size_t OUTPUTS { 2*Motor::MOTOR_COUNT };
+            using table_type = Robot::Math::Matrix<OUTPUTS, INPUTS>;
+            using input_type = Robot::Math::Vector<INPUTS>;
+
+            struct Output {
+                std::array<Value, Motor::MOTOR_COUNT> servo;
+                Motor::MotorValues throttle;
+            };
+
+            constexpr explicit Mixer(const table_type &layout) :
+                m_tables {},
+                m_servo_invert {}
+            {
+                constexpr std::array<MotorMap, ORIENTATIONS> maps { MOTOR_MAP_NORTH, MOTOR_MAP_SOUTH, MOTOR_MAP_EAST, MOTOR_MAP_WEST };
+                for (std::size_t o=0; o<ORIENTATIONS; o++) {
+                    // Facing backwards the skew is mirrored
+                    const auto reverse = (o==index(Orientation::SOUTH) || o==index(Orientation::EAST));
+                    for (std::size_t position=0; position<Motor::MOTOR_COUNT; position++) {
+                        const auto &entry = maps[o][position];
+                        const auto duty_sign = entry.invert_duty ? -1.0f : 1.0f;
+                        for (std::size_t c=0; c<INPUTS; c++) {
+                            const auto sign = (reverse && c==SKEW) ? -1.0f : 1.0f;
+                            m_tables[o](entry.index, c) = sign * layout(position, c);
+                            m_tables[o](Motor::MOTOR_COUNT+entry.index, c) = sign * duty_sign * layout(Motor::MOTOR_COUNT+position, c);
+                        }
+                        m_servo_invert[o][entry.index] = entry.invert;
+                    }
+                }
+            }
+
+            /**
+             * @brief Mix a command for the given orientation
+             *
+             * @return Servo values and throttles indexed by motor
+             */
+            Output mix(Orientation orientation, const ChassisCommand &command) const
+            {
+                const auto o = index(orientation);
+                const input_type input { command.left_angle, command.right_angle, command.skew, command.left_throttle, command.right_throttle, 1.0f };
+                const auto mixed = m_tables[o] * input;
+
+                Output output;
+                for (std::size_t i=0; i<Motor::MOTOR_COUNT; i++) {
+                    const auto servo = Value::fromAngle(mixed[i]);
+                    output.servo[i] = m_servo_invert[o][i] ? -servo : servo;
+                    output.throttle[i] = mixed[Motor::MOTOR_COUNT+i];
+                }
+                return output;
+            }
+
+            const table_type &table(Orientation orientation) const { return m_tables[index(orientation)]; }
+
+        private:
+            static constexpr std::size_t ORIENTATIONS { 4 };
+            static constexpr std::size_t SKEW { 2 };
+
+            static constexpr std::size_t index(Orientation orientation) { return static_cast<std::size_t>(orientation); }
+
+            std::array<table_type, ORIENTATIONS> m_tables;
+            std::array<std::array<bool, Motor::MOTOR_COUNT>, ORIENTATIONS> m_servo_invert;
+    };
+
+
+
+    namespace Layout {
+        inline constexpr auto S { Robot::Config::WHEEL_STRAIGHT_ANGLE };
+
+        /// All wheels straight with the skew, used by skid steering and wheel steering going straight
+        inline constexpr Mixer::table_type STRAIGHT {
+        //  left  right  skew   l-thr  r-thr  1
+            0.0f, 0.0f, -1.0f,  0.0f,  0.0f,  S,      // Front left angle
+            0.0f, 0.0f,  1.0f,  0.0f,  0.0f,  S,      // Front right angle
+            0.0f, 0.0f,  1.0f,  0.0f,  0.0f,  S,      // Rear left angle
+            0.0f, 0.0f, -1.0f,  0.0f,  0.0f,  S,      // Rear right angle
+            0.0f, 0.0f,  0.0f,  1.0f,  0.0f,  0.0f,   // Front left throttle
+            0.0f, 0.0f,  0.0f,  0.0f,  1.0f,  0.0f,   // Front right throttle
+            0.0f, 0.0f,  0.0f,  1.0f,  0.0f,  0.0f,   // Rear left throttle
+            0.0f, 0.0f,  0.0f,  0.0f,  1.0f,  0.0f,   // Rear right throttle
+        };
+
+        /// Front and rear wheels steer opposite
+        inline constexpr Mixer::table_type ALL_WHEEL {
+            1.0f, 0.0f, -1.0f,  0.0f,  0.0f,  S,
+            0.0f, 1.0f,  1.0f,  0.0f,  0.0f,  S,
+            1.0f, 0.0f,  1.0f,  0.0f,  0.0f,  S,
+            0.0f, 1.0f, -1.0f,  0.0f,  0.0f,  S,
+            0.0f, 0.0f,  0.0f,  1.0f,  0.0f,  0.0f,
+            0.0f, 0.0f,  0.0f,  0.0f,  1.0f,  0.0f,
+            0.0f, 0.0f,  0.0f,  1.0f,  0.0f,  0.0f,
+            0.0f, 0.0f,  0.0f,  0.0f,  1.0f,  0.0f,
+        };
+
+        inline constexpr Mixer::table_type FRONT_WHEEL {
+            1.0f, 0.0f, -1.0f,  0.0f,  0.0f,  S,
+            0.0f, 1.0f,  1.0f,  0.0f,  0.0f,  S,
+            0.0f, 0.0f,  1.0f,  0.0f,  0.0f,  S,
+            0.0f, 0.0f, -1.0f,  0.0f,  0.0f,  S,
+            0.0f, 0.0f,  0.0f,  1.0f,  0.0f,  0.0f,
+            0.0f, 0.0f,  0.0f,  0.0f,  1.0f,  0.0f,
+            0.0f, 0.0f,  0.0f,  1.0f,  0.0f,  0.0f,
+            0.0f, 0.0f,  0.0f,  0.0f,  1.0f,  0.0f,
+        };
+
+        inline constexpr Mixer::table_type REAR_WHEEL {
+            0.0f, 0.0f,  1.0f,  0.0f,  0.0f,  S,
+            0.0f, 0.0f, -1.0f,  0.0f,  0.0f,  S,
+            1.0f, 0.0f, -1.0f,  0.0f,  0.0f,  S,
+            0.0f, 1.0f,  1.0f,  0.0f,  0.0f,  S,
+            0.0f, 0.0f,  0.0f,  1.0f,  0.0f,  0.0f,
+            0.0f, 0.0f,  0.0f,  0.0f,  1.0f,  0.0f,
+            0.0f, 0.0f,  0.0f,  1.0f,  0.0f,  0.0f,
+            0.0f, 0.0f,  0.0f,  0.0f,  1.0f,  0.0f,
+        };
+
+        /// Servos centered with the wheels on the turning circle around the middle
+        inline constexpr Mixer::table_type SPINNING {
+            0.0f, 0.0f,  0.0f,  0.0f,  0.0f,  0.0f,
+            0.0f, 0.0f,  0.0f,  0.0f,  0.0f,  0.0f,
+            0.0f, 0.0f,  0.0f,  0.0f,  0.0f,  0.0f,
+            0.0f, 0.0f,  0.0f,  0.0f,  0.0f,  0.0f,
+            0.0f, 0.0f,  0.0f,  1.0f,  0.0f,  0.0f,
+            0.0f, 0.0f,  0.0f,  0.0f,  1.0f,  0.0f,
+            0.0f, 0.0f,  0.0f,  1.0f,  0.0f,  0.0f,
+            0.0f, 0.0f,  0.0f,  0.0f,  1.0f,  0.0f,
+        };
+    }
+
+
+    inline constexpr Mixer MIXER_STRAIGHT { Layout::STRAIGHT };
+    inline constexpr Mixer MIXER_ALL_WHEEL { Layout::ALL_WHEEL };
+    inline constexpr Mixer MIXER_FRONT_WHEEL { Layout::FRONT_WHEEL };
+    inline constexpr Mixer MIXER_REAR_WHEEL { Layout::REAR_WHEEL };
+    inline constexpr Mixer MIXER_SPINNING { Layout::SPINNING };
+
+}
+
+#endif
@@ -0,0 +1,186 @@
+#include "path.h"
+
+#include <cmath>
+#include <algorithm>
+#include <stdexcept>
+#include <boost/throw_exception.hpp>
+
+
+namespace Robot::Kinematic {
+
+
+void Pose::advance(float distance, float curvature)
+{
+    const auto turn = distance * curvature;
+    if (std::abs(turn) < 1e-6f) {
+        x += distance * std::cos(heading);
+        y += distance * std::sin(heading);
+    }
+    else {
+        // Exact arc, the chord of a small step would drift on tight turns
+        const auto next = heading + turn;
+        x += (std::sin(next)-std::sin(heading)) / curvature;
+        y += (std::cos(heading)-std::cos(next)) / curvature;
+        heading = std::remainder(next, 2.0f*static_cast<float>(M_PI));
+    }
+}
+
+
+
+static Point lerp(const Point &a, const Point &b, float t)
+{
+    return Point { a.x + t*(b.x-a.x), a.y + t*(b.y-a.y) };
+}
+
+
+static std::vector<Point> catmullRom(const std::vector<Point> &waypoints)
+{
+    std::vector<Point> points;
+    points.reserve((waypoints.size()-1)*Path::SPLINE_STEPS + 1);
+    const auto last = waypoints.size()-1;
+    for (std::size_t i=0; i<last; i++) {
+        // The end waypoints are repeated as their own neighbours
+        const auto &p0 = waypoints[i>0 ? i-1 : 0];
+        const auto &p1 = waypoints[i];
+        const auto &p2 = waypoints[i+1];
+        const auto &p3 = waypoints[std::min(i+2, last)];
+        for (std::size_t step=0; step<Path::SPLINE_STEPS; step++) {
+            const auto t = static_cast<float>(step) / Path::SPLINE_STEPS;
+            const auto t2 = t*t;
+            const auto t3 = t2*t;
+            auto eval = [t, t2, t3](float v0, float v1, float v2, float v3) {
+                return 0.5f * (2.0f*v1 + (v2-v0)*t + (2.0f*v0-5.0f*v1+4.0f*v2-v3)*t2 + (3.0f*v1-v0-3.0f*v2+v3)*t3);
+            };
+            points.push_back(Point { eval(p0.x, p1.x, p2.x, p3.x), eval(p0.y, p1.y, p2.y, p3.y) });
+        }
+    }
+    points.push_back(waypoints.back());
+    return points;
+}
+
+
+
+Path::Path() :
+    m_length { 0.0f }
+{
+}
+
+
+Path::Path(const std::vector<Point> &waypoints, bool spline) :
+    m_length { 0.0f }
+{
+    if (waypoints.size()<2) {
+        BOOST_THROW_EXCEPTION(std::invalid_argument("A path needs at least two waypoints"));
+    }
+
+    const auto polyline = spline ? catmullRom(waypoints) : waypoints;
+
+    // Walk the polyline and drop a sample every SPACING mm
+    m_points.push_back(polyline.front());
+    auto next = SPACING;
+    for (std::size_t i=1; i<polyline.size(); i++) {
+        const auto &a = polyline[i-1];
+        const auto &b = polyline[i];
+        const auto segment = std::hypot(b.x-a.x, b.y-a.y);
+        if (segment<=0.0f)
+            continue;
+        while (m_length+segment >= next) {
+            m_points.push_back(lerp(a, b, (next-m_length)/segment));
+            next += SPACING;
+        }
+        m_length += segment;
+    }
+    if (m_length<=0.0f) {
+        BOOST_THROW_EXCEPTION(std::invalid_argument("Path waypoints are all at the same point"));
+    }
+    if (m_length > (m_points.size()-1)*SPACING) {
+        m_points.push_back(polyline.back());
+    }
+}
+
+
+Point Path::at(float s) const
+{
+    if (m_points.size()<2)
+        return m_points.empty() ? Point { 0.0f, 0.0f } : m_points.front();
+
+    s = std::clamp(s, 0.0f, m_length);
+    const auto i = std::min(static_cast<std::size_t>(s/SPACING), m_points.size()-2);
+    const auto start = i*SPACING;
+    // The last sample may be closer than SPACING
+    const auto segment = std::min(SPACING, m_length-start);
+    const auto t = segment>0.0f ? std::min((s-start)/segment, 1.0f) : 0.0f;
+    return lerp(m_points[i], m_points[i+1], t);
+}
+
+
+
+PurePursuit::PurePursuit(float lookahead) :
+    m_lookahead { lookahead },
+    m_nearest { 0 }
+{
+}
+
+
+void PurePursuit::setPath(std::shared_ptr<const Path> path)
+{
+    m_path = std::move(path);
+    m_nearest = 0;
+}
+
+
+PurePursuit::Command PurePursuit::update(const Pose &pose)
+{
+    if (!m_path || m_path->empty()) {
+        return Command { 0.0f, 0.0f, true };
+    }
+    const auto &path = *m_path;
+
+    auto distance2 = [&pose](const Point &point) {
+        const auto dx = point.x-pose.x;
+        const auto dy = point.y-pose.y;
+        return dx*dx + dy*dy;
+    };
+
+    // Advance to the first local minimum within the window
+    const auto end = std::min(m_nearest+SEARCH_WINDOW, path.size()-1);
+    auto best = distance2(path[m_nearest]);
+    while (m_nearest<end) {
+        const auto next = distance2(path[m_nearest+1]);
+        if (next>best)
+            break;
+        best = next;
+        m_nearest++;
+    }
+
+    const auto cos_heading = std::cos(pose.heading);
+    const auto sin_heading = std::sin(pose.heading);
+    auto to_local = [&](const Point &point, float &x, float &y) {
+        const auto dx = point.x-pose.x;
+        const auto dy = point.y-pose.y;
+        x = cos_heading*dx + sin_heading*dy;
+        y = -sin_heading*dx + cos_heading*dy;
+    };
+
+    const auto progress = std::min(m_nearest*Path::SPACING, path.length());
+    const auto remaining = path.length()-progress;
+
+    if (m_nearest==path.size()-1) {
+        float x, y;
+        to_local(path.back(), x, y);
+        if (x<=0.0f || x*x+y*y < Path::SPACING*Path::SPACING) {
+            return Command { 0.0f, 0.0f, true };
+        }
+    }
+
+    // Arc through the lookahead point tangent to the heading
+    float x, y;
+    to_local(path.at(progress+m_lookahead), x, y);
+    const auto length2 = x*x + y*y;
+    const auto curvature = length2>1e-6f ? 2.0f*y/length2 : 0.0f;
+
+    return Command { curvature, remaining, false };
+}
+
+
+}
@@ -0,0 +1,119 @@
+#ifndef _ROBOT_KINEMATIC_PATH_H_
+#define _ROBOT_KINEMATIC_PATH_H_
+
+#include <cstddef>
+#include <memory>
+#include <vector>
+
+namespace Robot::Kinematic {
+
+    /**
+     * Point in the path frame (mm). The frame is the pose of the rover when path
+     * following started, with x forward and y to the left.
+     */
+    struct Point {
+        float x;
+        float y;
+    };
+
+
+    /**
+     * Position (mm) and heading (rad, counter clockwise from x) in the path frame.
+     */
+    struct Pose {
+        float x { 0.0f };
+        float y { 0.0f };
+        float heading { 0.0f };
+
+        /**
+         * @brief Move along an arc
+         *
+         * @param distance mm, negative moving backwards
+         * @param curvature 1/mm, positive turning left
+         */
+        void advance(float distance, float curvature);
+    };
+
+
+    /**
+     * Path through a list of waypoints, resampled at a fixed arc length.
+     *
+     * The waypoints are joined by straight lines or by a Catmull-Rom spline passing
+     * through them. Sample i lies at arc length i*SPACING (the last sample is the
+     * final waypoint), so a point at a distance along the path is found by
+     * indexing. Building a path allocates, it is done before the path is handed to
+     * the kinematic strand.
+     */
+    class Path {
+        public:
+            static constexpr float SPACING { 10.0f };           ///< mm between samples
+            static constexpr std::size_t SPLINE_STEPS { 16 };   ///< Spline evaluations between two waypoints
+
+            Path();
+            explicit Path(const std::vector<Point> &waypoints, bool spline = false);
+
+            bool empty() const { return m_points.empty(); }
+            std::size_t size() const { return m_points.size(); }
+            float length() const { return m_length; }
+
+            const Point &operator[](std::size_t index) const { return m_points[index]; }
+            const Point &back() const { return m_points.back(); }
+
+            /**
+             * @brief Point at arc length s, clamped to the ends of the path
+             */
+            Point at(float s) const;
+
+        private:
+            std::vector<Point> m_points;
+            float m_length;
+    };
+
+
+    /**
+     * Pure pursuit tracking of a Path.
+     *
+     * The sample nearest to the pose is searched forward from the previous one and
+     * at most SEARCH_WINDOW samples per update, which covers well over the distance
+     * the rover travels between two updates. The lookahead point is then found by
+     * arc length, so an update takes constant time whatever the length of the path.
+     */
+    class PurePursuit {
+        public:
+            static constexpr std::size_t SEARCH_WINDOW { 32 };
+
+            struct Command {
+                float curvature;    ///< 1/mm, positive turning left
+                float remaining;    ///< mm of path left after the nearest sample
+                bool done;          ///< The end of the path has been reached or passed
+            };
+
+            explicit PurePursuit(float lookahead);
+
+            void setLookahead(float lookahead) { m_lookahead = lookahead; }
+            float getLookahead() const { return m_lookahead; }
+
+            /**
+             * @brief Follow a new path from its start
+             */
+            void setPath(std::shared_ptr<const Path> path);
+            const std::shared_ptr<const Path> &getPath() const { return m_path; }
+
+            /**
+             * @brief Restart from the beginning of the path
+             */
+            void reset() { m_nearest = 0; }
+
+            Command update(const Pose &pose);
+
+            std::size_t nearest() const { return m_nearest; }
+
+        private:
+            std::shared_ptr<const Path> m_path;
+            float m_lookahead;
+            std::size_t m_nearest;
+    };
+
+}
+
+#endif
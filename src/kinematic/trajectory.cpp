@@ -0,0 +1,277 @@
+#include "trajectory.h"
+
+#include <cmath>
+#include <algorithm>
+#include <stdexcept>
+#include <boost/log/trivial.hpp>
+#include <boost/throw_exception.hpp>
+
+
+namespace Robot::Kinematic {
+
+static constexpr std::array<std::uint8_t, 4> MAGIC { 'B', 'R', 'T', 'R' };
+static constexpr std::size_t HEADER_SIZE { 8 };
+
+
+static void putVarint(std::vector<std::uint8_t> &out, std::uint32_t value)
+{
+    while (value>=0x80) {
+        out.push_back(static_cast<std::uint8_t>(value | 0x80));
+        value >>= 7;
+    }
+    out.push_back(static_cast<std::uint8_t>(value));
+}
+
+static bool getVarint(std::istream &in, std::uint32_t &value)
+{
+    value = 0;
+    for (auto shift=0; shift<35; shift+=7) {
+        const auto c = in.get();
+        if (c==std::istream::traits_type::eof())
+            return false;
+        value |= static_cast<std::uint32_t>(c & 0x7F) << shift;
+        if (!(c & 0x80))
+            return true;
+    }
+    return false;
+}
+
+static std::uint32_t zigzag(std::int32_t value)
+{
+    return (static_cast<std::uint32_t>(value) << 1) ^ static_cast<std::uint32_t>(value >> 31);
+}
+
+static std::int32_t unzigzag(std::uint32_t value)
+{
+    return static_cast<std::int32_t>(value >> 1) ^ -static_cast<std::int32_t>(value & 1);
+}
+
+static std::array<std::int32_t, 4> quantize(const TrajectorySample &sample)
+{
+    auto q = [](float value) {
+        return static_cast<std::int32_t>(std::lround(std::clamp(value, -1.0f, 1.0f) * TrajectoryEncoder::AXIS_SCALE));
+    };
+    return { q(sample.steering), q(sample.throttle), q(sample.aux_x), q(sample.aux_y) };
+}
+
+
+
+TrajectoryEncoder::TrajectoryEncoder() :
+    m_last { 0, 0, 0.0f, 0.0f, 0.0f, 0.0f },
+    m_last_axis { 0, 0, 0, 0 }
+{
+}
+
+
+void TrajectoryEncoder::header(std::vector<std::uint8_t> &out, DriveMode drive_mode)
+{
+    out.insert(out.end(), MAGIC.begin(), MAGIC.end());
+    out.push_back(VERSION);
+    out.push_back(static_cast<std::uint8_t>(drive_mode));
+    out.push_back(0);
+    out.push_back(0);
+}
+
+
+void TrajectoryEncoder::encode(std::vector<std::uint8_t> &out, const TrajectorySample &sample)
+{
+    putVarint(out, sample.time - m_last.time);
+    putVarint(out, zigzag(sample.odometer - m_last.odometer));
+
+    const auto axis = quantize(sample);
+    std::uint8_t changed = 0;
+    for (std::size_t i=0; i<axis.size(); i++) {
+        if (axis[i]!=m_last_axis[i])
+            changed |= 1u << i;
+    }
+    out.push_back(changed);
+    for (std::size_t i=0; i<axis.size(); i++) {
+        if (changed & (1u << i))
+            putVarint(out, zigzag(axis[i] - m_last_axis[i]));
+    }
+
+    m_last = sample;
+    m_last_axis = axis;
+}
+
+
+
+TrajectoryDecoder::TrajectoryDecoder(std::istream &in) :
+    m_in { in },
+    m_last { 0, 0, 0.0f, 0.0f, 0.0f, 0.0f },
+    m_last_axis { 0, 0, 0, 0 }
+{
+}
+
+
+DriveMode TrajectoryDecoder::header()
+{
+    std::array<char, HEADER_SIZE> header;
+    if (!m_in.read(header.data(), header.size())
+        || !std::equal(MAGIC.begin(), MAGIC.end(), header.begin(), [](auto a, auto b) { return a==static_cast<std::uint8_t>(b); })
+        || static_cast<std::uint8_t>(header[4])!=TrajectoryEncoder::VERSION
+        || static_cast<std::uint8_t>(header[5])>static_cast<std::uint8_t>(DriveMode::PATH)) {
+        BOOST_THROW_EXCEPTION(std::runtime_error("Not a trajectory recording"));
+    }
+    return static_cast<DriveMode>(header[5]);
+}
+
+
+bool TrajectoryDecoder::next(TrajectorySample &sample)
+{
+    std::uint32_t time, odometer;
+    if (!getVarint(m_in, time) || !getVarint(m_in, odometer))
+        return false;
+    const auto changed = m_in.get();
+    if (changed==std::istream::traits_type::eof())
+        return false;
+
+    for (std::size_t i=0; i<m_last_axis.size(); i++) {
+        if (changed & (1u << i)) {
+            std::uint32_t delta;
+            if (!getVarint(m_in, delta))
+                return false;
+            m_last_axis[i] += unzigzag(delta);
+        }
+    }
+
+    m_last.time += time;
+    m_last.odometer += unzigzag(odometer);
+    m_last.steering = m_last_axis[0] / TrajectoryEncoder::AXIS_SCALE;
+    m_last.throttle = m_last_axis[1] / TrajectoryEncoder::AXIS_SCALE;
+    m_last.aux_x = m_last_axis[2] / TrajectoryEncoder::AXIS_SCALE;
+    m_last.aux_y = m_last_axis[3] / TrajectoryEncoder::AXIS_SCALE;
+    sample = m_last;
+    return true;
+}
+
+
+
+TrajectoryRecorder::TrajectoryRecorder(boost::asio::io_context &io, const std::string &filename, DriveMode drive_mode) :
+    WithStrand { io },
+    m_file { std::make_shared<std::ofstream>(filename, std::ios::binary | std::ios::trunc) },
+    m_chunk { std::make_shared<std::vector<std::uint8_t>>() },
+    m_odometer_start { 0 },
+    m_samples { 0 }
+{
+    if (!*m_file) {
+        BOOST_THROW_EXCEPTION(std::runtime_error("Unable to create trajectory file "+filename));
+    }
+    m_chunk->reserve(CHUNK_SIZE+32);
+    TrajectoryEncoder::header(*m_chunk, drive_mode);
+}
+
+
+TrajectoryRecorder::~TrajectoryRecorder()
+{
+    stop();
+}
+
+
+void TrajectoryRecorder::start(clock_type::time_point time, std::int32_t odometer)
+{
+    m_start = time;
+    m_odometer_start = odometer;
+}
+
+
+void TrajectoryRecorder::record(clock_type::time_point time, std::int32_t odometer, float steering, float throttle, float aux_x, float aux_y)
+{
+    if (!m_file)
+        return;
+
+    const auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(time - m_start).count();
+    m_encoder.encode(*m_chunk, TrajectorySample { static_cast<std::uint32_t>(elapsed), odometer - m_odometer_start, steering, throttle, aux_x, aux_y });
+    m_samples++;
+    if (m_chunk->size()>=CHUNK_SIZE) {
+        flush();
+    }
+}
+
+
+void TrajectoryRecorder::stop()
+{
+    if (!m_file)
+        return;
+    flush();
+    post([file=m_file] {
+        file->close();
+    });
+    m_file.reset();
+    BOOST_LOG_TRIVIAL(info) << "Trajectory recorded " << m_samples << " samples";
+}
+
+
+void TrajectoryRecorder::flush()
+{
+    if (m_chunk->empty())
+        return;
+    post([file=m_file, chunk=m_chunk] {
+        file->write(reinterpret_cast<const char*>(chunk->data()), chunk->size());
+        if (!*file) {
+            BOOST_LOG_TRIVIAL(error) << "Error writing trajectory";
+        }
+    });
+    m_chunk = std::make_shared<std::vector<std::uint8_t>>();
+    m_chunk->reserve(CHUNK_SIZE+32);
+}
+
+
+
+TrajectoryPlayer::TrajectoryPlayer(const std::string &filename, ReplaySync sync) :
+    m_file { filename, std::ios::binary },
+    m_decoder { m_file },
+    m_sync { sync },
+    m_drive_mode { DriveMode::NONE },
+    m_done { false },
+    m_odometer_start { 0 },
+    m_applied { 0, 0, 0.0f, 0.0f, 0.0f, 0.0f },
+    m_pending { 0, 0, 0.0f, 0.0f, 0.0f, 0.0f }
+{
+    if (!m_file) {
+        BOOST_THROW_EXCEPTION(std::runtime_error("Unable to open trajectory file "+filename));
+    }
+    m_drive_mode = m_decoder.header();
+    m_done = !m_decoder.next(m_pending);
+}
+
+
+void TrajectoryPlayer::start(clock_type::time_point time, std::int32_t odometer)
+{
+    m_start = time;
+    m_applied_at = time;
+    m_odometer_start = odometer;
+}
+
+
+std::optional<TrajectorySample> TrajectoryPlayer::poll(clock_type::time_point time, std::int32_t odometer)
+{
+    std::optional<TrajectorySample> latest;
+    while (!m_done && due(time, odometer)) {
+        latest = m_pending;
+        m_applied = m_pending;
+        m_applied_at = time;
+        m_done = !m_decoder.next(m_pending);
+    }
+    return latest;
+}
+
+
+bool TrajectoryPlayer::due(clock_type::time_point time, std::int32_t odometer) const
+{
+    if (m_sync==ReplaySync::TIME) {
+        return time - m_start >= std::chrono::milliseconds(m_pending.time);
+    }
+
+    // Compared with the total distance so the error does not add up over the samples
+    const auto travelled = odometer - m_odometer_start;
+    const auto delta = m_pending.odometer - m_applied.odometer;
+    if (delta>0)
+        return travelled >= m_pending.odometer;
+    if (delta<0)
+        return travelled <= m_pending.odometer;
+    return time - m_applied_at >= std::chrono::milliseconds(m_pending.time - m_applied.time);
+}
+
+
+}
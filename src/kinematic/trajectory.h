@@ -0,0 +1,170 @@
+#ifndef _ROBOT_KINEMATIC_TRAJECTORY_H_
+#define _ROBOT_KINEMATIC_TRAJECTORY_H_
+
+#include <array>
+#include <cstdint>
+#include <cstddef>
+#include <chrono>
+#include <memory>
+#include <optional>
+#include <string>
+#include <vector>
+#include <iostream>
+#include <fstream>
+#include <boost/asio.hpp>
+
+#include <common/withstrand.h>
+#include "types.h"
+
+namespace Robot::Kinematic {
+
+    /**
+     * One steer command of a recorded trajectory.
+     */
+    struct TrajectorySample {
+        std::uint32_t time;     ///< ms since the recording started
+        std::int32_t odometer;  ///< mm since the recording started
+        float steering;
+        float throttle;
+        float aux_x;
+        float aux_y;
+    };
+
+
+    /**
+     * Delta encoding of a trajectory stream.
+     *
+     * The stream starts with a header holding the drive mode of the recording.
+     * Each sample is then stored as the time and odometer delta followed by a
+     * byte flagging which of the four axes changed, and the change of those in
+     * steps of 1/AXIS_SCALE. Deltas are zig-zag encoded varints, so a typical
+     * sample takes 4-6 bytes.
+     */
+    class TrajectoryEncoder {
+        public:
+            static constexpr std::uint8_t VERSION { 1 };
+            static constexpr float AXIS_SCALE { 32767.0f };
+
+            TrajectoryEncoder();
+
+            static void header(std::vector<std::uint8_t> &out, DriveMode drive_mode);
+            void encode(std::vector<std::uint8_t> &out, const TrajectorySample &sample);
+
+        private:
+            TrajectorySample m_last;
+            std::array<std::int32_t, 4> m_last_axis;
+    };
+
+
+    /**
+     * Reads a stream written with TrajectoryEncoder one sample at a time.
+     */
+    class TrajectoryDecoder {
+        public:
+            explicit TrajectoryDecoder(std::istream &in);
+
+            /// Drive mode of the recording, throws if the stream has no valid header
+            DriveMode header();
+            /// Next sample, false at the end of the stream
+            bool next(TrajectorySample &sample);
+
+        private:
+            std::istream &m_in;
+            TrajectorySample m_last;
+            std::array<std::int32_t, 4> m_last_axis;
+    };
+
+
+
+    /**
+     * Streams the applied steer commands to a file.
+     *
+     * Samples are encoded into a fixed size chunk on the caller's strand, full
+     * chunks are written to the file on a strand of their own so the kinematic
+     * strand never waits on the file system, and only the current chunk is held
+     * in memory.
+     */
+    class TrajectoryRecorder : public WithStrand {
+        public:
+            using clock_type = std::chrono::steady_clock;
+            static constexpr std::size_t CHUNK_SIZE { 4096 };
+
+            /**
+             * @brief Create the file, throws if it can not be opened
+             */
+            TrajectoryRecorder(boost::asio::io_context &io, const std::string &filename, DriveMode drive_mode);
+            ~TrajectoryRecorder();
+
+            void start(clock_type::time_point time, std::int32_t odometer);
+            void record(clock_type::time_point time, std::int32_t odometer, float steering, float throttle, float aux_x, float aux_y);
+            /**
+             * @brief Write what is left and close the file
+             */
+            void stop();
+
+            std::size_t samples() const { return m_samples; }
+
+        private:
+            std::shared_ptr<std::ofstream> m_file;
+            std::shared_ptr<std::vector<std::uint8_t>> m_chunk;
+            TrajectoryEncoder m_encoder;
+            clock_type::time_point m_start;
+            std::int32_t m_odometer_start;
+            std::size_t m_samples;
+
+            void flush();
+    };
+
+
+
+    /**
+     * Plays back a recorded trajectory from a file.
+     *
+     * With ReplaySync::TIME samples are due at their recorded time. With
+     * ReplaySync::DISTANCE they are due when the rover has travelled as far as
+     * when they were recorded, samples recorded while standing still keep
+     * their time offset to the sample before.
+     */
+    class TrajectoryPlayer {
+        public:
+            using clock_type = std::chrono::steady_clock;
+
+            /**
+             * @brief Open the file and read the header, throws if it is not a trajectory
+             */
+            TrajectoryPlayer(const std::string &filename, ReplaySync sync);
+
+            DriveMode driveMode() const { return m_drive_mode; }
+            ReplaySync sync() const { return m_sync; }
+
+            void start(clock_type::time_point time, std::int32_t odometer);
+
+            /**
+             * @brief Latest sample due at the given time and odometer
+             *
+             * Samples passed over since the last poll are skipped, only the latest is
+             * returned.
+             */
+            std::optional<TrajectorySample> poll(clock_type::time_point time, std::int32_t odometer);
+
+            bool done() const { return m_done; }
+
+        private:
+            std::ifstream m_file;
+            TrajectoryDecoder m_decoder;
+            ReplaySync m_sync;
+            DriveMode m_drive_mode;
+            bool m_done;
+
+            clock_type::time_point m_start;
+            std::int32_t m_odometer_start;
+            clock_type::time_point m_applied_at;
+            TrajectorySample m_applied;
+            TrajectorySample m_pending;
+
+            bool due(clock_type::time_point time, std::int32_t odometer) const;
+    };
+
+}
+
+#endif
@@ -23,6 +23,7 @@ namespace Robot::Kinematic {
         SKID,
         SPINNING,
         BALANCING,
+        PATH,
     };
     std::ostream &operator<<(std::ostream &os, const DriveMode &drivemode);
 
@@ -34,6 +35,18 @@ namespace Robot::Kinematic {
     };
     std::ostream &operator<<(std::ostream &os, const Orientation &orientation);
 
+    enum class ThrottleMode {
+        DUTY,   ///< Throttle is open loop motor duty
+        RPM     ///< Throttle is a fraction of WHEEL_MAX_RPM, held by the motor RPM loop
+    };
+    std::ostream &operator<<(std::ostream &os, const ThrottleMode &mode);
+
+    enum class ReplaySync {
+        TIME,       ///< Commands are replayed at the time they were recorded
+        DISTANCE    ///< Commands are replayed at the distance they were recorded
+    };
+    std::ostream &operator<<(std::ostream &os, const ReplaySync &sync);
+
 
     enum class MotorPosition {
         FRONT_LEFT = 0,
@@ -6,6 +6,9 @@
 #include <boost/log/trivial.hpp>
 #include <boost/format.hpp>
 
+#include <robotlogging.h>
+#include <metrics/trace.h>
+#include <metrics/probes.h>
 #include <robotcontext.h>
 #include <input/control.h>
 #include "animation/headlights.h"
@@ -111,6 +114,8 @@ void Control::clear(const Color &color)
 
 void Control::showPixels()
 {
+    ROBOT_PROBE2(led__show, m_pixels.size(), ROBOT_PROBE_MILLI(m_brightness));
+
     // Apply color correction and brightness
     color_array_type pixels { m_pixels };
     pixels *= (m_brightness*m_brightness); // Use brightness ^2 to make the perceived brightness seem more linear
@@ -300,6 +305,7 @@ void Control::updatePixels()
     if (!m_initialized)
         return;
     //BOOST_LOG_TRIVIAL(trace) << "Control::Show()";
+    ROBOT_TRACE_SCOPE("led.frame");
 
     {
         const guard lock(m_mutex);
@@ -318,7 +324,7 @@ void Control::updatePixels()
 void Control::attachLayer(std::shared_ptr<ColorLayer> layer)
 {
     const guard lock(m_mutex);
-    BOOST_LOG_TRIVIAL(trace) << "Attach Layer " << *layer;
+    ROBOT_LOG(trace) << "Attach Layer " << *layer;
 
     for (auto &l : m_layers) {
         if (l==layer) {
@@ -353,7 +359,7 @@ void Control::detachLayer(std::shared_ptr<ColorLayer> layer)
     bool updated = false;
     m_layers.remove_if([layer, &updated](const auto &l) {
         if (l==layer) {
-            BOOST_LOG_TRIVIAL(trace) << "Detach Layer " << *layer;
+            ROBOT_LOG(trace) << "Detach Layer " << *layer;
             updated |= true;
             layer->disconnect();
             return true;
@@ -0,0 +1,60 @@
+#ifndef _CONSTMATH__H_
+#define _CONSTMATH__H_
+
+namespace Robot::Math::Const {
+
+/*
+ * Trigonometric functions usable in constant expressions, for tables generated
+ * at compile time. They are evaluated with series to double precision and are
+ * not meant for use at run time.
+ */
+
+inline constexpr double PI { 3.14159265358979323846 };
+
+constexpr double abs(double x) { return x<0.0 ? -x : x; }
+
+constexpr double sin(double x)
+{
+    // Reduce to [-pi, pi] where the series converges quickly
+    while (x>PI) x -= 2.0*PI;
+    while (x<-PI) x += 2.0*PI;
+    double term = x;
+    double sum = x;
+    for (int n=1; abs(term)>1e-17; n++) {
+        term *= -x*x / ((2*n)*(2*n+1));
+        sum += term;
+    }
+    return sum;
+}
+
+constexpr double cos(double x)
+{
+    return sin(x + PI/2.0);
+}
+
+constexpr double tan(double x)
+{
+    return sin(x) / cos(x);
+}
+
+constexpr double atan(double x)
+{
+    if (x<0.0)
+        return -atan(-x);
+    if (x>1.0)
+        return PI/2.0 - atan(1.0/x);
+    // tan(pi/8), keeps the argument of the series below 0.42
+    if (x>0.41421356237309503)
+        return PI/4.0 + atan((x-1.0)/(x+1.0));
+    double power = x;
+    double sum = x;
+    for (int n=1; power>1e-17; n++) {
+        power *= x*x;
+        sum += ((n%2) ? -power : power) / (2*n+1);
+    }
+    return sum;
+}
+
+}
+
+#endif
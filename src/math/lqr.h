@@ -0,0 +1,62 @@
+#ifndef _LQR__H_
+#define _LQR__H_
+
+#include <cstddef>
+#include <algorithm>
+
+#include "matrix.h"
+
+namespace Robot::Math {
+
+/**
+ * @brief Zero order hold discretization of x' = Ax + Bu
+ *
+ * exp(A*dt) and its integral are evaluated with a truncated Taylor series,
+ * which is accurate for the short sample times of the control loops.
+ */
+template<std::size_t N, std::size_t M, typename T>
+void discretize(const Matrix<N, N, T> &A, const Matrix<N, M, T> &B, T dt, Matrix<N, N, T> &Ad, Matrix<N, M, T> &Bd, unsigned terms = 12)
+{
+    auto term = Matrix<N, N, T>::identity();
+    auto integral = Matrix<N, N, T>::identity() * dt;
+    Ad = Matrix<N, N, T>::identity();
+    for (unsigned k=1; k<=terms; k++) {
+        term = term * A * (dt/static_cast<T>(k));
+        Ad += term;
+        integral += term * (dt/static_cast<T>(k+1));
+    }
+    Bd = integral * B;
+}
+
+
+/**
+ * @brief Infinite horizon discrete LQR gain
+ *
+ * Iterates the Riccati difference equation until the cost matrix settles and
+ * returns the gain K of the control law u = -Kx.
+ *
+ * @return false if the iteration did not converge, K then holds the last iterate
+ */
+template<std::size_t N, std::size_t M, typename T>
+bool dlqr(const Matrix<N, N, T> &Ad, const Matrix<N, M, T> &Bd, const Matrix<N, N, T> &Q, const Matrix<M, M, T> &R, Matrix<M, N, T> &K, unsigned max_iterations = 100000, T tolerance = T(1e-9))
+{
+    const auto At = Ad.transpose();
+    const auto Bt = Bd.transpose();
+    auto P = Q;
+    for (unsigned i=0; i<max_iterations; i++) {
+        Matrix<M, M, T> S_inv;
+        if (!(R + Bt*P*Bd).inverse(S_inv))
+            return false;
+        K = S_inv * Bt * P * Ad;
+        auto next = Q + At*P*Ad - At*P*Bd*K;
+        auto change = (next-P).maxAbs();
+        P = next;
+        if (change<=tolerance*std::max(T(1), P.maxAbs()))
+            return true;
+    }
+    return false;
+}
+
+}
+
+#endif
@@ -0,0 +1,185 @@
+#ifndef _MATRIX__H_
+#define _MATRIX__H_
+
+#include <array>
+#include <cmath>
+#include <algorithm>
+#include <cstddef>
+#include <utility>
+#include <initializer_list>
+
+namespace Robot::Math {
+
+/**
+ * Fixed size, row major matrix for the small state space models of the control loops.
+ *
+ * Storage is held inline and no operation allocates, so it can be used at the
+ * loop rate. Dimensions are checked at compile time.
+ */
+template<std::size_t R, std::size_t C, typename T = float>
+class Matrix {
+  public:
+    using value_type = T;
+    static constexpr std::size_t ROWS { R };
+    static constexpr std::size_t COLS { C };
+
+    constexpr Matrix() : m_data {} {}
+
+    /// Row major values, missing values are zero
+    constexpr Matrix(std::initializer_list<T> values) : m_data {}
+    {
+        std::size_t i = 0;
+        for (auto value : values) {
+            if (i>=R*C)
+                break;
+            m_data[i++] = value;
+        }
+    }
+
+    static constexpr Matrix zero() { return Matrix {}; }
+    static constexpr Matrix identity()
+    {
+        static_assert(R==C, "Identity of a non square matrix");
+        Matrix res;
+        for (std::size_t i=0; i<R; i++) {
+            res(i, i) = T(1);
+        }
+        return res;
+    }
+
+    constexpr T &operator()(std::size_t row, std::size_t col) { return m_data[row*C+col]; }
+    constexpr const T &operator()(std::size_t row, std::size_t col) const { return m_data[row*C+col]; }
+
+    /// Element of a row or column vector
+    constexpr T &operator[](std::size_t index) { return m_data[index]; }
+    constexpr const T &operator[](std::size_t index) const { return m_data[index]; }
+
+    constexpr Matrix<C, R, T> transpose() const
+    {
+        Matrix<C, R, T> res;
+        for (std::size_t r=0; r<R; r++) {
+            for (std::size_t c=0; c<C; c++) {
+                res(c, r) = (*this)(r, c);
+            }
+        }
+        return res;
+    }
+
+    template<typename U>
+    constexpr Matrix<R, C, U> cast() const
+    {
+        Matrix<R, C, U> res;
+        for (std::size_t i=0; i<R*C; i++) {
+            res[i] = static_cast<U>(m_data[i]);
+        }
+        return res;
+    }
+
+    /// Largest absolute element
+    T maxAbs() const
+    {
+        T res { 0 };
+        for (auto value : m_data) {
+            res = std::max(res, std::abs(value));
+        }
+        return res;
+    }
+
+    /**
+     * @brief Inverse by Gauss-Jordan elimination with partial pivoting
+     *
+     * @return false if the matrix is singular, result is then undefined
+     */
+    bool inverse(Matrix &result) const
+    {
+        static_assert(R==C, "Inverse of a non square matrix");
+        Matrix a = *this;
+        result = identity();
+        for (std::size_t col=0; col<C; col++) {
+            auto pivot = col;
+            for (std::size_t r=col+1; r<R; r++) {
+                if (std::abs(a(r, col))>std::abs(a(pivot, col)))
+                    pivot = r;
+            }
+            if (a(pivot, col)==T(0))
+                return false;
+            if (pivot!=col) {
+                for (std::size_t c=0; c<C; c++) {
+                    std::swap(a(pivot, c), a(col, c));
+                    std::swap(result(pivot, c), result(col, c));
+                }
+            }
+            const auto scale = T(1) / a(col, col);
+            for (std::size_t c=0; c<C; c++) {
+                a(col, c) *= scale;
+                result(col, c) *= scale;
+            }
+            for (std::size_t r=0; r<R; r++) {
+                if (r==col)
+                    continue;
+                const auto factor = a(r, col);
+                for (std::size_t c=0; c<C; c++) {
+                    a(r, c) -= factor * a(col, c);
+                    result(r, c) -= factor * result(col, c);
+                }
+            }
+        }
+        return true;
+    }
+
+    constexpr Matrix &operator+=(const Matrix &other)
+    {
+        for (std::size_t i=0; i<R*C; i++) {
+            m_data[i] += other.m_data[i];
+        }
+        return *this;
+    }
+    constexpr Matrix &operator-=(const Matrix &other)
+    {
+        for (std::size_t i=0; i<R*C; i++) {
+            m_data[i] -= other.m_data[i];
+        }
+        return *this;
+    }
+    constexpr Matrix &operator*=(T scale)
+    {
+        for (auto &value : m_data) {
+            value *= scale;
+        }
+        return *this;
+    }
+
+    friend constexpr Matrix operator+(Matrix lhs, const Matrix &rhs) { return lhs += rhs; }
+    friend constexpr Matrix operator-(Matrix lhs, const Matrix &rhs) { return lhs -= rhs; }
+    friend constexpr Matrix operator-(Matrix value) { return value *= T(-1); }
+    friend constexpr Matrix operator*(Matrix lhs, T scale) { return lhs *= scale; }
+    friend constexpr Matrix operator*(T scale, Matrix rhs) { return rhs *= scale; }
+
+  private:
+    std::array<T, R*C> m_data;
+};
+
+
+template<std::size_t N, typename T = float>
+using Vector = Matrix<N, 1, T>;
+
+
+template<std::size_t R, std::size_t K, std::size_t C, typename T>
+constexpr Matrix<R, C, T> operator*(const Matrix<R, K, T> &lhs, const Matrix<K, C, T> &rhs)
+{
+    Matrix<R, C, T> res;
+    for (std::size_t r=0; r<R; r++) {
+        for (std::size_t c=0; c<C; c++) {
+            T sum { 0 };
+            for (std::size_t k=0; k<K; k++) {
+                sum += lhs(r, k) * rhs(k, c);
+            }
+            res(r, c) = sum;
+        }
+    }
+    return res;
+}
+
+}
+
+#endif
@@ -0,0 +1,67 @@
+#include "motionprofile.h"
+
+#include <cmath>
+#include <algorithm>
+
+namespace Robot::Math {
+
+MotionProfile::MotionProfile(float max_acceleration, float max_jerk) :
+    m_max_acceleration { max_acceleration },
+    m_max_jerk { max_jerk },
+    m_target { 0.0f },
+    m_velocity { 0.0f },
+    m_acceleration { 0.0f }
+{
+}
+
+
+void MotionProfile::setLimits(float max_acceleration, float max_jerk)
+{
+    m_max_acceleration = max_acceleration;
+    m_max_jerk = max_jerk;
+}
+
+
+void MotionProfile::reset(float velocity)
+{
+    m_target = velocity;
+    m_velocity = velocity;
+    m_acceleration = 0.0f;
+}
+
+
+float MotionProfile::update(sample_time_type dt)
+{
+    const auto dt_s = dt.count();
+    const auto error = m_target - m_velocity;
+
+    if (m_max_acceleration<=0.0f || dt_s<=0.0f) {
+        m_velocity = m_target;
+        m_acceleration = 0.0f;
+        return m_velocity;
+    }
+
+    if (m_max_jerk<=0.0f) {
+        // Trapezoidal profile
+        m_acceleration = std::clamp(error/dt_s, -m_max_acceleration, m_max_acceleration);
+    }
+    else {
+        // Aim for the acceleration that can still be ramped down to zero with the
+        // jerk limit by the time the target is reached: a^2/(2*J) = |error|
+        auto desired = std::copysign(std::min(m_max_acceleration, std::sqrt(2.0f*m_max_jerk*std::abs(error))), error);
+        auto step = m_max_jerk*dt_s;
+        m_acceleration += std::clamp(desired-m_acceleration, -step, step);
+    }
+
+    m_velocity += m_acceleration*dt_s;
+
+    // Land exactly on the target instead of overshooting by a fraction of a step
+    if ((error>=0.0f && m_velocity>=m_target) || (error<=0.0f && m_velocity<=m_target)) {
+        m_velocity = m_target;
+        m_acceleration = 0.0f;
+    }
+
+    return m_velocity;
+}
+
+}
@@ -0,0 +1,56 @@
+#ifndef _MOTIONPROFILE__H_
+#define _MOTIONPROFILE__H_
+
+#include <chrono>
+
+namespace Robot::Math {
+
+/**
+ * Online S-curve velocity profile.
+ *
+ * Moves a reference velocity towards the target with bounded acceleration and
+ * bounded jerk. The acceleration is ramped down in time to reach the target
+ * without overshoot, also when the target changes in the middle of a ramp.
+ * All state is held in place, update() does not allocate.
+ */
+class MotionProfile {
+  public:
+    using sample_time_type = std::chrono::duration<float>;
+
+    /**
+     * @brief Construct a new MotionProfile object
+     *
+     * @param max_acceleration Maximum acceleration (units/s), zero disables the profile
+     * @param max_jerk Maximum jerk (units/s^2), zero allows acceleration steps
+     */
+    MotionProfile(float max_acceleration, float max_jerk);
+
+    void setLimits(float max_acceleration, float max_jerk);
+    float getMaxAcceleration() const { return m_max_acceleration; }
+    float getMaxJerk() const { return m_max_jerk; }
+
+    void setTarget(float target) { m_target = target; }
+    float getTarget() const { return m_target; }
+
+    /// Advance the profile one sample and return the reference velocity
+    float update(sample_time_type dt);
+
+    float getVelocity() const { return m_velocity; }          ///< Current reference
+    float getAcceleration() const { return m_acceleration; }  ///< Current reference acceleration
+    bool done() const { return m_velocity==m_target && m_acceleration==0.0f; }
+
+    /// Restart the profile from the given velocity at rest
+    void reset(float velocity = 0.0f);
+
+  private:
+    float m_max_acceleration;
+    float m_max_jerk;
+    float m_target;
+    float m_velocity;
+    float m_acceleration;
+
+};
+
+}
+
+#endif
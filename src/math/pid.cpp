@@ -7,7 +7,7 @@ namespace Robot::Math {
 
 PID::PID(float kp, float ki, float kd, sample_time_type Ts, float ema_alpha) : 
     m_Ts(Ts), 
-    m_min_output { std::numeric_limits<float>::min() },
+    m_min_output { std::numeric_limits<float>::lowest() },
     m_max_output { std::numeric_limits<float>::max() },
     m_kp { 0.0f },
     m_ki_Ts { 0.0f },
@@ -58,7 +58,7 @@ float PID::update(float input)
         output = m_max_output;
     }
     else if (output < m_min_output) {
-        output = -m_min_output;
+        output = m_min_output;
     }
     else {
         m_integral = new_integral;
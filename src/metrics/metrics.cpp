@@ -0,0 +1,180 @@
+#include "metrics.h"
+
+#include <cstdio>
+#include <algorithm>
+#include <stdexcept>
+#include <boost/throw_exception.hpp>
+
+namespace Robot::Metrics {
+
+
+static void appendNumber(std::string &out, double value)
+{
+    char buf[32];
+    auto len = std::snprintf(buf, sizeof(buf), "%.9g", value);
+    out.append(buf, len);
+}
+
+static void appendNumber(std::string &out, std::uint64_t value)
+{
+    out.append(std::to_string(value));
+}
+
+static void appendHeader(std::string &out, const Metric &metric, const char *type)
+{
+    out.append("# TYPE ").append(metric.name()).append(" ").append(type).append("\n");
+    if (!metric.help().empty()) {
+        out.append("# HELP ").append(metric.name()).append(" ").append(metric.help()).append("\n");
+    }
+}
+
+
+
+void Counter::render(std::string &out) const
+{
+    appendHeader(out, *this, "counter");
+    out.append(name()).append("_total ");
+    appendNumber(out, value());
+    out.append("\n");
+}
+
+
+void Gauge::render(std::string &out) const
+{
+    appendHeader(out, *this, "gauge");
+    out.append(name()).append(" ");
+    appendNumber(out, value());
+    out.append("\n");
+}
+
+
+
+Histogram::Histogram(const std::string &name, const std::string &help, const bucket_list &buckets) :
+    Metric { Type::HISTOGRAM, name, help },
+    m_bounds { buckets },
+    m_buckets { std::make_unique<std::atomic<count_type>[]>(buckets.size()+1) },
+    m_count { 0u },
+    m_sum { 0.0 }
+{
+    if (!std::is_sorted(m_bounds.begin(), m_bounds.end())) {
+        BOOST_THROW_EXCEPTION(std::invalid_argument("Histogram buckets must be sorted: "+name));
+    }
+    for (auto i=0u; i<=m_bounds.size(); i++) {
+        m_buckets[i].store(0u, std::memory_order_relaxed);
+    }
+}
+
+
+void Histogram::observe(value_type value)
+{
+    auto idx = std::lower_bound(m_bounds.begin(), m_bounds.end(), value) - m_bounds.begin();
+    m_buckets[idx].fetch_add(1u, std::memory_order_relaxed);
+    m_count.fetch_add(1u, std::memory_order_relaxed);
+    auto sum = m_sum.load(std::memory_order_relaxed);
+    while (!m_sum.compare_exchange_weak(sum, sum+value, std::memory_order_relaxed)) {}
+}
+
+
+void Histogram::render(std::string &out) const
+{
+    appendHeader(out, *this, "histogram");
+
+    // Buckets are stored individually and rendered cumulative
+    count_type cumulative = 0u;
+    for (auto i=0u; i<m_bounds.size(); i++) {
+        cumulative += m_buckets[i].load(std::memory_order_relaxed);
+        out.append(name()).append("_bucket{le=\"");
+        appendNumber(out, m_bounds[i]);
+        out.append("\"} ");
+        appendNumber(out, cumulative);
+        out.append("\n");
+    }
+    cumulative += m_buckets[m_bounds.size()].load(std::memory_order_relaxed);
+    out.append(name()).append("_bucket{le=\"+Inf\"} ");
+    appendNumber(out, cumulative);
+    out.append("\n");
+
+    // Count is derived from the buckets so it stays consistent with +Inf
+    out.append(name()).append("_count ");
+    appendNumber(out, cumulative);
+    out.append("\n");
+    out.append(name()).append("_sum ");
+    appendNumber(out, sum());
+    out.append("\n");
+}
+
+
+const Histogram::bucket_list &Histogram::latencyBuckets()
+{
+    static const bucket_list buckets {
+        0.00005, 0.0001, 0.00025, 0.0005,
+        0.001, 0.0025, 0.005,
+        0.01, 0.02, 0.05, 0.1
+    };
+    return buckets;
+}
+
+
+
+template<typename T, typename ... Args>
+std::shared_ptr<T> Registry::get(Metric::Type type, const std::string &name, Args&& ... args)
+{
+    const std::lock_guard<std::mutex> lock(m_mutex);
+    for (auto &metric : m_metrics) {
+        if (metric->name()==name) {
+            if (metric->type()!=type) {
+                BOOST_THROW_EXCEPTION(std::invalid_argument("Metric registered with another type: "+name));
+            }
+            return std::static_pointer_cast<T>(metric);
+        }
+    }
+    auto metric = std::make_shared<T>(name, std::forward<Args>(args)...);
+    m_metrics.push_back(metric);
+    return metric;
+}
+
+
+std::shared_ptr<Counter> Registry::counter(const std::string &name, const std::string &help)
+{
+    return get<Counter>(Metric::Type::COUNTER, name, help);
+}
+
+
+std::shared_ptr<Gauge> Registry::gauge(const std::string &name, const std::string &help)
+{
+    return get<Gauge>(Metric::Type::GAUGE, name, help);
+}
+
+
+std::shared_ptr<Histogram> Registry::histogram(const std::string &name, const std::string &help, const Histogram::bucket_list &buckets)
+{
+    return get<Histogram>(Metric::Type::HISTOGRAM, name, help, buckets);
+}
+
+
+Registry::metric_list Registry::metrics() const
+{
+    const std::lock_guard<std::mutex> lock(m_mutex);
+    return m_metrics;
+}
+
+
+std::string Registry::render() const
+{
+    std::string out;
+    for (auto &metric : metrics()) {
+        metric->render(out);
+    }
+    out.append("# EOF\n");
+    return out;
+}
+
+
+Registry &registry()
+{
+    static Registry instance;
+    return instance;
+}
+
+
+}
@@ -0,0 +1,176 @@
+#ifndef _ROBOT_METRICS_METRICS_H_
+#define _ROBOT_METRICS_METRICS_H_
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+#include <initializer_list>
+
+namespace Robot::Metrics {
+
+    /**
+     * @brief Base of all metrics
+     *
+     * Updating a metric is a few relaxed atomic operations, rendering only
+     * reads the atomics so the control path is never blocked by a scrape.
+     */
+    class Metric {
+        public:
+            enum class Type {
+                COUNTER,
+                GAUGE,
+                HISTOGRAM,
+            };
+
+            Metric(Type type, const std::string &name, const std::string &help) :
+                m_type { type },
+                m_name { name },
+                m_help { help }
+            {}
+            Metric(const Metric&) = delete; // No copy constructor
+            Metric(Metric&&) = delete; // No move constructor
+            virtual ~Metric() = default;
+
+            Type type() const { return m_type; }
+            const std::string &name() const { return m_name; }
+            const std::string &help() const { return m_help; }
+
+            /**
+             * @brief Append the OpenMetrics family (TYPE, HELP and samples) to out
+             */
+            virtual void render(std::string &out) const = 0;
+
+        private:
+            const Type m_type;
+            const std::string m_name;
+            const std::string m_help;
+    };
+
+
+    class Counter : public Metric {
+        public:
+            using value_type = std::uint64_t;
+
+            Counter(const std::string &name, const std::string &help) : Metric { Type::COUNTER, name, help }, m_value { 0u } {}
+
+            void inc(value_type n = 1u) { m_value.fetch_add(n, std::memory_order_relaxed); }
+            value_type value() const { return m_value.load(std::memory_order_relaxed); }
+
+            void render(std::string &out) const override;
+
+        private:
+            std::atomic<value_type> m_value;
+    };
+
+
+    class Gauge : public Metric {
+        public:
+            using value_type = double;
+
+            Gauge(const std::string &name, const std::string &help) : Metric { Type::GAUGE, name, help }, m_value { 0.0 } {}
+
+            void set(value_type value) { m_value.store(value, std::memory_order_relaxed); }
+            void add(value_type value)
+            {
+                auto current = m_value.load(std::memory_order_relaxed);
+                while (!m_value.compare_exchange_weak(current, current+value, std::memory_order_relaxed)) {}
+            }
+            value_type value() const { return m_value.load(std::memory_order_relaxed); }
+
+            void render(std::string &out) const override;
+
+        private:
+            std::atomic<value_type> m_value;
+    };
+
+
+    class Histogram : public Metric {
+        public:
+            using value_type = double;
+            using count_type = std::uint64_t;
+            using bucket_list = std::vector<value_type>;
+
+            /**
+             * @brief Construct histogram
+             *
+             * @param name Metric name
+             * @param help Description
+             * @param buckets Upper bounds of the buckets in increasing order, +Inf is implicit
+             */
+            Histogram(const std::string &name, const std::string &help, const bucket_list &buckets);
+
+            void observe(value_type value);
+
+            template<typename Rep, typename Period>
+            void observe(const std::chrono::duration<Rep, Period> &duration)
+            {
+                observe(std::chrono::duration<value_type>(duration).count());
+            }
+
+            count_type count() const { return m_count.load(std::memory_order_relaxed); }
+            value_type sum() const { return m_sum.load(std::memory_order_relaxed); }
+
+            void render(std::string &out) const override;
+
+            /**
+             * @brief Bucket bounds suitable for control loop latencies (50us .. 100ms)
+             */
+            static const bucket_list &latencyBuckets();
+
+        private:
+            const bucket_list m_bounds;
+            std::unique_ptr<std::atomic<count_type>[]> m_buckets;
+            std::atomic<count_type> m_count;
+            std::atomic<value_type> m_sum;
+    };
+
+
+    class Registry {
+        public:
+            using metric_list = std::vector<std::shared_ptr<Metric>>;
+
+            Registry() = default;
+            Registry(const Registry&) = delete; // No copy constructor
+            Registry(Registry&&) = delete; // No move constructor
+
+            /**
+             * @brief Get or create a metric
+             *
+             * Metrics are identified by name, registering the same name twice returns
+             * the existing metric. Throws if the name is used with a different type.
+             */
+            std::shared_ptr<Counter> counter(const std::string &name, const std::string &help);
+            std::shared_ptr<Gauge> gauge(const std::string &name, const std::string &help);
+            std::shared_ptr<Histogram> histogram(const std::string &name, const std::string &help, const Histogram::bucket_list &buckets = Histogram::latencyBuckets());
+
+            /**
+             * @brief Snapshot of the registered metrics
+             */
+            metric_list metrics() const;
+
+            /**
+             * @brief Render all metrics as a complete OpenMetrics exposition
+             */
+            std::string render() const;
+
+        private:
+            mutable std::mutex m_mutex;
+            metric_list m_metrics;
+
+            template<typename T, typename ... Args>
+            std::shared_ptr<T> get(Metric::Type type, const std::string &name, Args&& ... args);
+    };
+
+
+    /**
+     * @brief The process wide metrics registry
+     */
+    Registry &registry();
+
+}
+
+#endif
@@ -0,0 +1,194 @@
+#include "perfcounters.h"
+
+#include <mutex>
+#include <cstring>
+#include <cerrno>
+#include <unistd.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <linux/perf_event.h>
+#include <boost/log/trivial.hpp>
+
+namespace Robot::Metrics {
+
+static constexpr auto COUNTER_COUNT { 4u };
+
+std::atomic<bool> PerfLoop::s_enabled { false };
+
+static std::mutex g_loops_mutex;
+static std::vector<std::shared_ptr<PerfLoop>> g_loops;
+
+
+/**
+ * Counter group of the calling thread, opened on first use.
+ */
+class ThreadGroup {
+    public:
+        ThreadGroup() :
+            m_failed { false }
+        {
+            for (auto &fd : m_fds) {
+                fd = -1;
+            }
+        }
+        ~ThreadGroup()
+        {
+            close();
+        }
+
+        bool read(std::uint64_t (&values)[COUNTER_COUNT])
+        {
+            if (m_fds[0]<0 && !open()) {
+                return false;
+            }
+            // PERF_FORMAT_GROUP: { nr, values[nr] }
+            std::uint64_t data[1+COUNTER_COUNT];
+            if (::read(m_fds[0], data, sizeof(data))!=sizeof(data) || data[0]!=COUNTER_COUNT) {
+                return false;
+            }
+            std::memcpy(values, &data[1], sizeof(values));
+            return true;
+        }
+
+    private:
+        int m_fds[COUNTER_COUNT];
+        bool m_failed;
+
+        static int openCounter(std::uint32_t type, std::uint64_t config, int group)
+        {
+            perf_event_attr attr;
+            std::memset(&attr, 0, sizeof(attr));
+            attr.size = sizeof(attr);
+            attr.type = type;
+            attr.config = config;
+            attr.read_format = PERF_FORMAT_GROUP;
+            attr.disabled = group<0 ? 1 : 0;
+            attr.exclude_hv = 1;
+            // Only the scheduler sees context switches, user space counting is enough for the rest
+            attr.exclude_kernel = type==PERF_TYPE_HARDWARE ? 1 : 0;
+            return static_cast<int>(syscall(SYS_perf_event_open, &attr, 0, -1, group, 0));
+        }
+
+        bool open()
+        {
+            if (m_failed) {
+                return false;
+            }
+
+            m_fds[0] = openCounter(PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES, -1);
+            m_fds[1] = m_fds[0]<0 ? -1 : openCounter(PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS, m_fds[0]);
+            m_fds[2] = m_fds[1]<0 ? -1 : openCounter(PERF_TYPE_HARDWARE, PERF_COUNT_HW_CACHE_MISSES, m_fds[0]);
+            m_fds[3] = m_fds[2]<0 ? -1 : openCounter(PERF_TYPE_SOFTWARE, PERF_COUNT_SW_CONTEXT_SWITCHES, m_fds[0]);
+            if (m_fds[3]<0) {
+                static std::once_flag warned;
+                std::call_once(warned, []{
+                    BOOST_LOG_TRIVIAL(warning) << "Performance counters unavailable: " << std::strerror(errno);
+                });
+                close();
+                m_failed = true;
+                return false;
+            }
+
+            ioctl(m_fds[0], PERF_EVENT_IOC_RESET, PERF_IOC_FLAG_GROUP);
+            ioctl(m_fds[0], PERF_EVENT_IOC_ENABLE, PERF_IOC_FLAG_GROUP);
+            return true;
+        }
+
+        void close()
+        {
+            for (auto &fd : m_fds) {
+                if (fd>=0) {
+                    ::close(fd);
+                }
+                fd = -1;
+            }
+        }
+};
+
+
+static ThreadGroup &threadGroup()
+{
+    thread_local ThreadGroup group;
+    return group;
+}
+
+
+
+PerfLoop::Scope::Scope(PerfLoop &loop) :
+    m_loop { nullptr }
+{
+    if (enabled() && threadGroup().read(m_start)) {
+        m_loop = &loop;
+    }
+}
+
+
+PerfLoop::Scope::~Scope()
+{
+    if (!m_loop) {
+        return;
+    }
+    std::uint64_t end[COUNTER_COUNT];
+    if (!threadGroup().read(end)) {
+        return;
+    }
+    m_loop->m_ticks.fetch_add(1u, std::memory_order_relaxed);
+    m_loop->m_cycles.fetch_add(end[0]-m_start[0], std::memory_order_relaxed);
+    m_loop->m_instructions.fetch_add(end[1]-m_start[1], std::memory_order_relaxed);
+    m_loop->m_cache_misses.fetch_add(end[2]-m_start[2], std::memory_order_relaxed);
+    m_loop->m_context_switches.fetch_add(end[3]-m_start[3], std::memory_order_relaxed);
+}
+
+
+
+PerfLoop::PerfLoop(const std::string &name) :
+    m_name { name },
+    m_ticks { 0u },
+    m_cycles { 0u },
+    m_instructions { 0u },
+    m_cache_misses { 0u },
+    m_context_switches { 0u }
+{
+}
+
+
+PerfLoop::Totals PerfLoop::take()
+{
+    return Totals {
+        m_ticks.exchange(0u, std::memory_order_relaxed),
+        m_cycles.exchange(0u, std::memory_order_relaxed),
+        m_instructions.exchange(0u, std::memory_order_relaxed),
+        m_cache_misses.exchange(0u, std::memory_order_relaxed),
+        m_context_switches.exchange(0u, std::memory_order_relaxed),
+    };
+}
+
+
+void PerfLoop::setEnabled(bool enabled)
+{
+    s_enabled = enabled;
+}
+
+
+std::shared_ptr<PerfLoop> PerfLoop::get(const std::string &name)
+{
+    const std::lock_guard<std::mutex> lock(g_loops_mutex);
+    for (auto &loop : g_loops) {
+        if (loop->name()==name) {
+            return loop;
+        }
+    }
+    auto loop = std::make_shared<PerfLoop>(name);
+    g_loops.push_back(loop);
+    return loop;
+}
+
+
+std::vector<std::shared_ptr<PerfLoop>> PerfLoop::loops()
+{
+    const std::lock_guard<std::mutex> lock(g_loops_mutex);
+    return g_loops;
+}
+
+
+}
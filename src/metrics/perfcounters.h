@@ -0,0 +1,84 @@
+#ifndef _ROBOT_METRICS_PERFCOUNTERS_H_
+#define _ROBOT_METRICS_PERFCOUNTERS_H_
+
+#include <atomic>
+#include <memory>
+#include <string>
+#include <vector>
+#include <cstdint>
+
+namespace Robot::Metrics {
+
+    /**
+     * @brief Hardware performance counter aggregates of one control loop
+     *
+     * Each thread running a loop opens its own perf_event_open group (cycles,
+     * instructions, cache misses and context switches) on first use and the
+     * whole group is read with a single read() before and after every tick.
+     *
+     * Sampling is off by default, while it is off a tick only costs a relaxed
+     * atomic load. It is switched on with PerfLoop::setEnabled(), which the
+     * "perf" telemetry source does while it is active.
+     */
+    class PerfLoop {
+        public:
+            struct Totals {
+                std::uint64_t ticks;
+                std::uint64_t cycles;
+                std::uint64_t instructions;
+                std::uint64_t cache_misses;
+                std::uint64_t context_switches;
+            };
+
+            /**
+             * @brief RAII sample of one loop tick
+             */
+            class Scope {
+                public:
+                    explicit Scope(PerfLoop &loop);
+                    Scope(const Scope&) = delete; // No copy constructor
+                    Scope(Scope&&) = delete; // No move constructor
+                    ~Scope();
+                private:
+                    PerfLoop *m_loop;
+                    std::uint64_t m_start[4];
+            };
+
+            explicit PerfLoop(const std::string &name);
+            PerfLoop(const PerfLoop&) = delete; // No copy constructor
+            PerfLoop(PerfLoop&&) = delete; // No move constructor
+
+            const std::string &name() const { return m_name; }
+
+            /**
+             * @brief Return the totals since the last call and reset them
+             */
+            Totals take();
+
+            static bool enabled() { return s_enabled.load(std::memory_order_relaxed); }
+            static void setEnabled(bool enabled);
+
+            /**
+             * @brief Get or create the loop with the given name
+             */
+            static std::shared_ptr<PerfLoop> get(const std::string &name);
+
+            /**
+             * @brief Snapshot of all loops created so far
+             */
+            static std::vector<std::shared_ptr<PerfLoop>> loops();
+
+        private:
+            static std::atomic<bool> s_enabled;
+
+            const std::string m_name;
+            std::atomic<std::uint64_t> m_ticks;
+            std::atomic<std::uint64_t> m_cycles;
+            std::atomic<std::uint64_t> m_instructions;
+            std::atomic<std::uint64_t> m_cache_misses;
+            std::atomic<std::uint64_t> m_context_switches;
+    };
+
+}
+
+#endif
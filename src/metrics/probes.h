@@ -0,0 +1,41 @@
+#ifndef _ROBOT_METRICS_PROBES_H_
+#define _ROBOT_METRICS_PROBES_H_
+
+#include <config.h>
+
+/**
+ * User space statically defined tracepoints (USDT) in the "beaglerover" provider.
+ *
+ * A probe compiles to a single nop plus an ELF note, so it is free until a
+ * tracer attaches, ex:
+ *
+ *   bpftrace -e 'usdt:/usr/lib/python3/dist-packages/beaglerover.so:beaglerover:motor__update__exit { printf("%d %d\n", arg0, arg1); }'
+ *   perf probe -x beaglerover.so sdt_beaglerover:kinematic__steer
+ *
+ * Arguments must be integers, bpftrace has no floating point support, so
+ * float values are passed scaled with ROBOT_PROBE_MILLI. When sys/sdt.h is
+ * not available at build time the probes expand to nothing and their
+ * arguments are not evaluated.
+ */
+#define ROBOT_PROBE_MILLI(value) static_cast<int>((value)*1000.0f)
+
+#ifdef HAVE_SYS_SDT_H
+#include <sys/sdt.h>
+
+#define ROBOT_PROBE(name) DTRACE_PROBE(beaglerover, name)
+#define ROBOT_PROBE1(name, a1) DTRACE_PROBE1(beaglerover, name, a1)
+#define ROBOT_PROBE2(name, a1, a2) DTRACE_PROBE2(beaglerover, name, a1, a2)
+#define ROBOT_PROBE3(name, a1, a2, a3) DTRACE_PROBE3(beaglerover, name, a1, a2, a3)
+#define ROBOT_PROBE4(name, a1, a2, a3, a4) DTRACE_PROBE4(beaglerover, name, a1, a2, a3, a4)
+
+#else
+
+#define ROBOT_PROBE(name) do {} while (0)
+#define ROBOT_PROBE1(name, a1) do {} while (0)
+#define ROBOT_PROBE2(name, a1, a2) do {} while (0)
+#define ROBOT_PROBE3(name, a1, a2, a3) do {} while (0)
+#define ROBOT_PROBE4(name, a1, a2, a3, a4) do {} while (0)
+
+#endif
+
+#endif
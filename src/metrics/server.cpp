@@ -0,0 +1,209 @@
+#include "server.h"
+
+#include <boost/log/trivial.hpp>
+
+#include <robotcontext.h>
+#include "metrics.h"
+
+namespace Robot::Metrics {
+
+static constexpr auto DEFAULT_ENABLED { true };
+static const std::string DEFAULT_ADDRESS { "0.0.0.0" };
+static constexpr auto DEFAULT_PORT { 9100 };
+
+static constexpr auto REQUEST_MAX { 4096u };
+static const std::string REQUEST_END { "\r\n\r\n" };
+static const std::string METRICS_PATH { "/metrics" };
+
+static const std::string RESPONSE_OK {
+    "HTTP/1.1 200 OK\r\n"
+    "Content-Type: application/openmetrics-text; version=1.0.0; charset=utf-8\r\n"
+    "Connection: close\r\n"
+    "\r\n"
+};
+static const std::string RESPONSE_NOT_FOUND {
+    "HTTP/1.1 404 Not Found\r\n"
+    "Content-Type: text/plain\r\n"
+    "Connection: close\r\n"
+    "\r\n"
+    "Not found\n"
+};
+static const std::string RESPONSE_BAD_REQUEST {
+    "HTTP/1.1 400 Bad Request\r\n"
+    "Connection: close\r\n"
+    "\r\n"
+};
+static const std::string EXPOSITION_END { "# EOF\n" };
+
+
+class Server::Session : public std::enable_shared_from_this<Session> {
+    public:
+        explicit Session(boost::asio::ip::tcp::socket &&socket) :
+            m_socket { std::move(socket) },
+            m_request { REQUEST_MAX },
+            m_next { 0u }
+        {
+        }
+
+        void start()
+        {
+            boost::asio::async_read_until(m_socket, m_request, REQUEST_END,
+                [self=shared_from_this()](boost::system::error_code error, std::size_t) {
+                    if (error) {
+                        self->close();
+                        return;
+                    }
+                    self->onRequest();
+                }
+            );
+        }
+
+    private:
+        boost::asio::ip::tcp::socket m_socket;
+        boost::asio::streambuf m_request;
+        Registry::metric_list m_metrics;
+        Registry::metric_list::size_type m_next;
+        std::string m_buffer;
+
+        void onRequest()
+        {
+            std::istream is { &m_request };
+            std::string method, target;
+            is >> method >> target;
+            if (method!="GET") {
+                send(RESPONSE_BAD_REQUEST, true);
+                return;
+            }
+            if (target!=METRICS_PATH && target.compare(0, METRICS_PATH.size()+1, METRICS_PATH+"?")!=0) {
+                send(RESPONSE_NOT_FOUND, true);
+                return;
+            }
+            m_metrics = registry().metrics();
+            m_next = 0u;
+            send(RESPONSE_OK, false);
+        }
+
+        /**
+         * Write one chunk and continue with the next metric family when done.
+         */
+        void send(const std::string &data, bool last)
+        {
+            m_buffer = data;
+            boost::asio::async_write(m_socket, boost::asio::buffer(m_buffer),
+                [self=shared_from_this(), last](boost::system::error_code error, std::size_t) {
+                    if (error || last) {
+                        self->close();
+                        return;
+                    }
+                    self->next();
+                }
+            );
+        }
+
+        void next()
+        {
+            if (m_next>=m_metrics.size()) {
+                send(EXPOSITION_END, true);
+                return;
+            }
+            std::string chunk;
+            m_metrics[m_next++]->render(chunk);
+            send(chunk, false);
+        }
+
+        void close()
+        {
+            boost::system::error_code ec;
+            m_socket.shutdown(boost::asio::ip::tcp::socket::shutdown_both, ec);
+            m_socket.close(ec);
+        }
+};
+
+
+
+Server::Server(const std::shared_ptr<Robot::Context> &context) :
+    m_context { context },
+    m_initialized { false },
+    m_acceptor { context->io() }
+{
+    PropertyMap values;
+    values.put(PROPERTY_ENABLED, DEFAULT_ENABLED);
+    values.put(PROPERTY_ADDRESS, DEFAULT_ADDRESS);
+    values.put(PROPERTY_PORT, DEFAULT_PORT);
+    context->registerProperties(PROPERTY_GROUP, values);
+}
+
+
+Server::~Server()
+{
+    cleanup();
+}
+
+
+void Server::init()
+{
+    const guard lock(m_mutex);
+
+    const auto &properties = m_context->properties(PROPERTY_GROUP);
+    if (!properties.get(PROPERTY_ENABLED, DEFAULT_ENABLED)) {
+        BOOST_LOG_TRIVIAL(info) << "Metrics server disabled";
+        return;
+    }
+
+    auto address = boost::asio::ip::make_address(properties.get(PROPERTY_ADDRESS, DEFAULT_ADDRESS));
+    boost::asio::ip::tcp::endpoint endpoint { address, static_cast<unsigned short>(properties.get(PROPERTY_PORT, DEFAULT_PORT)) };
+
+    m_acceptor.open(endpoint.protocol());
+    m_acceptor.set_option(boost::asio::ip::tcp::acceptor::reuse_address(true));
+    m_acceptor.bind(endpoint);
+    m_acceptor.listen();
+
+    BOOST_LOG_TRIVIAL(info) << "Metrics server listening on " << m_acceptor.local_endpoint();
+
+    m_initialized = true;
+    accept();
+}
+
+
+void Server::cleanup()
+{
+    const guard lock(m_mutex);
+    if (!m_initialized)
+        return;
+    m_initialized = false;
+
+    boost::system::error_code ec;
+    m_acceptor.close(ec);
+}
+
+
+unsigned short Server::port() const
+{
+    const guard lock(m_mutex);
+    if (!m_acceptor.is_open()) {
+        return 0;
+    }
+    return m_acceptor.local_endpoint().port();
+}
+
+
+void Server::accept()
+{
+    m_acceptor.async_accept(
+        [this](boost::system::error_code error, boost::asio::ip::tcp::socket socket) {
+            if (error==boost::asio::error::operation_aborted || !m_acceptor.is_open()) {
+                return;
+            }
+            if (error) {
+                BOOST_LOG_TRIVIAL(warning) << "Metrics accept failed: " << error.message();
+            }
+            else {
+                std::make_shared<Session>(std::move(socket))->start();
+            }
+            accept();
+        }
+    );
+}
+
+
+}
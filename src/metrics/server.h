@@ -0,0 +1,51 @@
+#ifndef _ROBOT_METRICS_SERVER_H_
+#define _ROBOT_METRICS_SERVER_H_
+
+#include <memory>
+#include <string>
+#include <boost/asio.hpp>
+
+#include <robottypes.h>
+#include <common/withmutex.h>
+
+namespace Robot::Metrics {
+
+    /**
+     * @brief Minimal HTTP listener serving the metrics registry in OpenMetrics text format
+     *
+     * Only "GET /metrics" is served. Each metric family is rendered and written
+     * separately, so a scrape never holds anything the control path uses.
+     */
+    class Server : public std::enable_shared_from_this<Server>, public WithMutexStd {
+        public:
+            inline static const std::string PROPERTY_GROUP { "metrics" };
+            inline static const std::string PROPERTY_ENABLED { "enabled" };
+            inline static const std::string PROPERTY_ADDRESS { "address" };
+            inline static const std::string PROPERTY_PORT { "port" };
+
+            explicit Server(const std::shared_ptr<::Robot::Context> &context);
+            Server(const Server&) = delete; // No copy constructor
+            Server(Server&&) = delete; // No move constructor
+            virtual ~Server();
+
+            void init();
+            void cleanup();
+
+            /**
+             * @brief Port the listener is bound to, useful when configured with port 0
+             */
+            unsigned short port() const;
+
+        private:
+            class Session;
+
+            std::shared_ptr<::Robot::Context> m_context;
+            bool m_initialized;
+            boost::asio::ip::tcp::acceptor m_acceptor;
+
+            void accept();
+    };
+
+}
+
+#endif
@@ -0,0 +1,212 @@
+#include "trace.h"
+
+#include <array>
+#include <mutex>
+#include <chrono>
+#include <memory>
+#include <vector>
+#include <cstdio>
+#include <cstdint>
+#include <unistd.h>
+#include <pthread.h>
+#include <sys/syscall.h>
+
+namespace Robot::Metrics::Trace {
+
+static constexpr auto RING_SIZE { 4096u }; // Records per thread
+static constexpr auto THREAD_NAME_MAX { 16u }; // Including terminator, see pthread_getname_np
+
+std::atomic<bool> g_enabled { false };
+static std::atomic<std::int64_t> g_start { 0 };
+
+
+static inline std::int64_t now()
+{
+    using namespace std::chrono;
+    return duration_cast<nanoseconds>(steady_clock::now().time_since_epoch()).count();
+}
+
+
+struct Record {
+    std::int64_t timestamp;
+    const char *name;
+    char phase;
+};
+
+
+/**
+ * Ring owned and written by a single thread. The dumping thread copies the
+ * records and afterwards discards the ones that may have been overwritten
+ * while copying.
+ */
+class Ring {
+    public:
+        Ring() :
+            m_tid { static_cast<pid_t>(syscall(SYS_gettid)) },
+            m_head { 0u }
+        {
+            m_thread_name[0] = '\0';
+            pthread_getname_np(pthread_self(), m_thread_name, sizeof(m_thread_name));
+        }
+
+        void record(char phase, const char *name)
+        {
+            auto head = m_head.load(std::memory_order_relaxed);
+            auto &rec = m_records[head % RING_SIZE];
+            rec.timestamp = now();
+            rec.name = name;
+            rec.phase = phase;
+            m_head.store(head+1, std::memory_order_release);
+        }
+
+        void copy(std::vector<Record> &out, std::int64_t since) const
+        {
+            auto head = m_head.load(std::memory_order_acquire);
+            auto first = head>RING_SIZE ? head-RING_SIZE : 0u;
+            std::vector<Record> records;
+            records.reserve(head-first);
+            for (auto i=first; i<head; i++) {
+                records.push_back(m_records[i % RING_SIZE]);
+            }
+
+            // Skip anything the owner may have overwritten while we were copying
+            auto after = m_head.load(std::memory_order_acquire);
+            auto valid = after>RING_SIZE ? after-RING_SIZE : 0u;
+            for (auto i=first; i<head; i++) {
+                const auto &rec = records[i-first];
+                if (i>=valid && rec.timestamp>=since) {
+                    out.push_back(rec);
+                }
+            }
+        }
+
+        pid_t tid() const { return m_tid; }
+        const char *threadName() const { return m_thread_name; }
+
+    private:
+        const pid_t m_tid;
+        char m_thread_name[THREAD_NAME_MAX];
+        std::atomic<std::uint64_t> m_head;
+        std::array<Record, RING_SIZE> m_records;
+};
+
+
+static std::mutex g_rings_mutex;
+static std::vector<std::shared_ptr<Ring>> g_rings;
+
+static Ring &threadRing()
+{
+    // Rings outlive their thread so a dump still shows threads that have exited
+    thread_local std::shared_ptr<Ring> ring = []{
+        auto ring = std::make_shared<Ring>();
+        const std::lock_guard<std::mutex> lock(g_rings_mutex);
+        g_rings.push_back(ring);
+        return ring;
+    }();
+    return *ring;
+}
+
+
+
+void start()
+{
+    g_start = now();
+    g_enabled = true;
+}
+
+
+void stop()
+{
+    g_enabled = false;
+}
+
+
+void begin(const char *name)
+{
+    threadRing().record('B', name);
+}
+
+
+void end(const char *name)
+{
+    threadRing().record('E', name);
+}
+
+
+void instant(const char *name)
+{
+    threadRing().record('i', name);
+}
+
+
+static void appendEscaped(std::string &out, const char *str)
+{
+    for (; *str; str++) {
+        auto c = *str;
+        if (c=='"' || c=='\\') {
+            out.push_back('\\');
+            out.push_back(c);
+        }
+        else if (static_cast<unsigned char>(c)<0x20) {
+            out.push_back(' ');
+        }
+        else {
+            out.push_back(c);
+        }
+    }
+}
+
+
+std::string dump()
+{
+    std::vector<std::shared_ptr<Ring>> rings;
+    {
+        const std::lock_guard<std::mutex> lock(g_rings_mutex);
+        rings = g_rings;
+    }
+
+    const auto pid = getpid();
+    const auto since = g_start.load();
+    std::string out;
+    std::vector<Record> records;
+    char buf[128];
+
+    out.append("{\"displayTimeUnit\":\"ns\",\"traceEvents\":[\n");
+    bool first = true;
+    auto separator = [&out, &first]() {
+        if (!first) {
+            out.append(",\n");
+        }
+        first = false;
+    };
+
+    for (const auto &ring : rings) {
+        records.clear();
+        ring->copy(records, since);
+        if (records.empty()) {
+            continue;
+        }
+
+        separator();
+        std::snprintf(buf, sizeof(buf), "{\"ph\":\"M\",\"name\":\"thread_name\",\"pid\":%d,\"tid\":%d,\"args\":{\"name\":\"", pid, ring->tid());
+        out.append(buf);
+        appendEscaped(out, ring->threadName());
+        out.append("\"}}");
+
+        for (const auto &rec : records) {
+            separator();
+            // Chrome trace timestamps are in microseconds
+            std::snprintf(buf, sizeof(buf), "{\"ph\":\"%c\",\"pid\":%d,\"tid\":%d,\"ts\":%.3f,%s\"name\":\"",
+                rec.phase, pid, ring->tid(), (rec.timestamp-since)/1000.0, rec.phase=='i' ? "\"s\":\"t\"," : "");
+            out.append(buf);
+            appendEscaped(out, rec.name);
+            out.append("\"}");
+        }
+    }
+    out.append("\n]}\n");
+
+    return out;
+}
+
+
+}
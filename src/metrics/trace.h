@@ -0,0 +1,83 @@
+#ifndef _ROBOT_METRICS_TRACE_H_
+#define _ROBOT_METRICS_TRACE_H_
+
+#include <atomic>
+#include <string>
+
+/**
+ * Trace the enclosing scope as a begin/end pair. The name must be a string
+ * literal (or otherwise outlive the trace), only the pointer is recorded.
+ */
+#define ROBOT_TRACE_SCOPE(name) \
+    const ::Robot::Metrics::Trace::Scope ROBOT_TRACE_CONCAT(_robot_trace_scope_, __LINE__) { name }
+
+/**
+ * Record a single point in time. Same lifetime rules as ROBOT_TRACE_SCOPE.
+ */
+#define ROBOT_TRACE_INSTANT(name) \
+    if (!::Robot::Metrics::Trace::enabled()) {} else ::Robot::Metrics::Trace::instant(name)
+
+#define ROBOT_TRACE_CONCAT(a, b) ROBOT_TRACE_CONCAT_(a, b)
+#define ROBOT_TRACE_CONCAT_(a, b) a##b
+
+namespace Robot::Metrics::Trace {
+
+    /**
+     * Every thread records into its own fixed size ring, oldest records are
+     * overwritten so the rings always hold the most recent history. Recording
+     * is a clock read and three stores, and when tracing is stopped only the
+     * relaxed load in enabled() remains.
+     */
+
+    extern std::atomic<bool> g_enabled;
+
+    inline bool enabled()
+    {
+        return g_enabled.load(std::memory_order_relaxed);
+    }
+
+    /**
+     * @brief Start recording, records from before start() are not dumped
+     */
+    void start();
+
+    /**
+     * @brief Stop recording, the rings are kept until the next start()
+     */
+    void stop();
+
+    /**
+     * @brief Render the recorded events as Chrome trace event JSON
+     *
+     * The result can be loaded directly in Perfetto (ui.perfetto.dev) or chrome://tracing.
+     */
+    std::string dump();
+
+    void begin(const char *name);
+    void end(const char *name);
+    void instant(const char *name);
+
+    class Scope {
+        public:
+            explicit Scope(const char *name) :
+                m_name { enabled() ? name : nullptr }
+            {
+                if (m_name) {
+                    begin(m_name);
+                }
+            }
+            Scope(const Scope&) = delete; // No copy constructor
+            Scope(Scope&&) = delete; // No move constructor
+            ~Scope()
+            {
+                if (m_name) {
+                    end(m_name);
+                }
+            }
+        private:
+            const char *m_name;
+    };
+
+}
+
+#endif
@@ -0,0 +1,176 @@
+#include "autotune.h"
+
+#include <cmath>
+#include <limits>
+#include <algorithm>
+#include <boost/format.hpp>
+#include <boost/log/trivial.hpp>
+
+#include <robotlogging.h>
+
+namespace Robot::Motor {
+
+// Ziegler–Nichols classic PID: Kp = 0.6 Ku, Ti = Tu/2, Td = Tu/8
+static constexpr float ZN_P { 0.6f };
+static constexpr float ZN_TI { 0.5f };
+static constexpr float ZN_TD { 0.125f };
+
+// Duty/s the bias is raised with until the wheel first reaches the setpoint
+static constexpr float BIAS_RAMP { 0.5f };
+
+
+Autotune::Autotune() :
+    m_setpoint { 0.0f },
+    m_amplitude { 0.0f },
+    m_status { State::IDLE, 0u, 0.0f, 0.0f, { 0.0f, 0.0f, 0.0f, 0.0f, 0.0f } },
+    m_high { true },
+    m_started { false },
+    m_time { 0.0f },
+    m_last_switch { 0.0f },
+    m_high_time { 0.0f },
+    m_max { 0.0f },
+    m_min { 0.0f },
+    m_period_sum { 0.0f },
+    m_swing_sum { 0.0f }
+{
+}
+
+
+void Autotune::start(float setpoint, float amplitude)
+{
+    m_setpoint = setpoint;
+    m_amplitude = std::abs(amplitude);
+    // Start centered on the amplitude and ramp the bias until the wheel reaches the
+    // setpoint. The bias correction takes it from there.
+    m_status = { State::RUNNING, 0u, std::copysign(m_amplitude, setpoint), 0.0f, { 0.0f, 0.0f, 0.0f, 0.0f, 0.0f } };
+    m_high = setpoint>=0.0f;
+    m_started = false;
+    m_time = duration_type::zero();
+    m_last_switch = duration_type::zero();
+    m_high_time = duration_type::zero();
+    m_max = std::numeric_limits<float>::lowest();
+    m_min = std::numeric_limits<float>::max();
+    m_period_sum = 0.0f;
+    m_swing_sum = 0.0f;
+}
+
+
+void Autotune::cancel()
+{
+    if (m_status.state==State::RUNNING) {
+        m_status.state = State::IDLE;
+    }
+}
+
+
+float Autotune::update(float rpm, duration_type dt)
+{
+    if (m_status.state!=State::RUNNING)
+        return 0.0f;
+
+    m_time += dt;
+    m_max = std::max(m_max, rpm);
+    m_min = std::min(m_min, rpm);
+
+    if (!m_started && m_high==(m_setpoint>=0.0f)) {
+        auto limit = std::max(0.0f, 1.0f-m_amplitude);
+        m_status.bias = std::clamp(m_status.bias + std::copysign(BIAS_RAMP*dt.count(), m_setpoint), -limit, limit);
+    }
+
+    if (m_high && rpm>m_setpoint+HYSTERESIS) {
+        m_high = false;
+        m_high_time = m_time - m_last_switch;
+        m_last_switch = m_time;
+    }
+    else if (!m_high && rpm<m_setpoint-HYSTERESIS) {
+        // A cycle is complete on every switch from low to high
+        m_high = true;
+        auto low_time = m_time - m_last_switch;
+        m_last_switch = m_time;
+        if (m_started) {
+            cycle(m_high_time, low_time);
+        }
+        m_started = true;
+        m_max = std::numeric_limits<float>::lowest();
+        m_min = std::numeric_limits<float>::max();
+    }
+    else if (m_time-m_last_switch > TIMEOUT) {
+        fail("relay does not switch, increase the amplitude");
+    }
+
+    if (m_status.state!=State::RUNNING)
+        return 0.0f;
+    return std::clamp(m_status.bias + (m_high ? m_amplitude : -m_amplitude), -1.0f, 1.0f);
+}
+
+
+void Autotune::cycle(duration_type high, duration_type low)
+{
+    auto period = (high+low).count();
+    auto swing = (m_max-m_min)/2.0f;
+
+    // Shift the bias towards the mean duty needed to hold the setpoint
+    auto limit = std::max(0.0f, 1.0f-m_amplitude);
+    m_status.bias = std::clamp(m_status.bias + m_amplitude*(high-low).count()/period, -limit, limit);
+    m_status.swing = swing;
+    m_status.cycles++;
+
+    ROBOT_LOG(trace) << boost::format("Autotune cycle %d: period %.3fs swing %.1f bias %.3f") % m_status.cycles % period % swing % m_status.bias;
+
+    if (m_status.cycles>WARMUP_CYCLES) {
+        m_period_sum += period;
+        m_swing_sum += swing;
+        if (m_status.cycles>=WARMUP_CYCLES+MEASURE_CYCLES) {
+            finish();
+        }
+    }
+}
+
+
+void Autotune::finish()
+{
+    auto tu = m_period_sum / MEASURE_CYCLES;
+    auto swing = m_swing_sum / MEASURE_CYCLES;
+    if (swing<=HYSTERESIS) {
+        fail("no measurable oscillation");
+        return;
+    }
+
+    // Describing function of a relay with hysteresis
+    auto ku = 4.0f*m_amplitude / (static_cast<float>(M_PI)*std::sqrt(swing*swing - HYSTERESIS*HYSTERESIS));
+    auto &result = m_status.result;
+    result.ku = ku;
+    result.tu = tu;
+    result.p = ZN_P * ku;
+    result.i = result.p / (ZN_TI * tu);
+    result.d = result.p * ZN_TD * tu;
+    m_status.state = State::DONE;
+
+    BOOST_LOG_TRIVIAL(info) << boost::format("Autotune done: Ku=%g Tu=%.3fs -> P=%g I=%g D=%g") % ku % tu % result.p % result.i % result.d;
+}
+
+
+void Autotune::fail(const char *reason)
+{
+    BOOST_LOG_TRIVIAL(warning) << "Autotune failed: " << reason;
+    m_status.state = State::FAILED;
+}
+
+
+
+std::ostream &operator<<(std::ostream &os, const Autotune::State &state)
+{
+    switch (state) {
+        case Autotune::State::IDLE:
+            return os << "IDLE";
+        case Autotune::State::RUNNING:
+            return os << "RUNNING";
+        case Autotune::State::DONE:
+            return os << "DONE";
+        case Autotune::State::FAILED:
+            return os << "FAILED";
+    }
+    return os;
+}
+
+}
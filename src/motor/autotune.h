@@ -0,0 +1,100 @@
+#ifndef _ROBOT_MOTOR_AUTOTUNE_H_
+#define _ROBOT_MOTOR_AUTOTUNE_H_
+
+#include <chrono>
+#include <cstdint>
+#include <iostream>
+
+#include <robottypes.h>
+
+namespace Robot::Motor {
+
+    /**
+     * Relay feedback (Åström–Hägglund) experiment for the motor RPM loop.
+     *
+     * The wheel is driven with a relay of fixed amplitude around a bias duty, so
+     * the speed oscillates around the setpoint. The bias is corrected after every
+     * cycle until both halves of the oscillation are equally long. The ultimate
+     * gain and period are then measured from the relay amplitude and the RPM swing,
+     * and the PID gains are derived with the Ziegler–Nichols rules.
+     *
+     * The experiment assumes a lifted wheel, gains found under load will differ.
+     */
+    class Autotune {
+        public:
+            using duration_type = std::chrono::duration<float>;
+
+            static constexpr uint WARMUP_CYCLES { 3 };      ///< Cycles used to settle the bias
+            static constexpr uint MEASURE_CYCLES { 5 };     ///< Cycles averaged for the estimates
+            static constexpr float HYSTERESIS { 3.0f };     ///< RPM noise band around the setpoint
+            static constexpr duration_type TIMEOUT { std::chrono::seconds(5) };  ///< Longest half cycle
+
+            enum class State : std::uint8_t {
+                IDLE,
+                RUNNING,
+                DONE,
+                FAILED
+            };
+
+            struct Result {
+                float ku;   // Ultimate gain (duty/RPM)
+                float tu;   // Ultimate period (s)
+                float p;
+                float i;
+                float d;
+            };
+
+            struct Status {
+                State state;
+                uint cycles;    // Completed relay cycles, including warm up
+                float bias;     // Duty the relay is centered on
+                float swing;    // RPM peak amplitude of the last cycle
+                Result result;
+            };
+
+            Autotune();
+
+            /**
+             * @brief Start a new experiment
+             *
+             * @param setpoint RPM to oscillate around
+             * @param amplitude Relay amplitude in duty, must be well above the motor dead zone
+             */
+            void start(float setpoint, float amplitude);
+            void cancel();
+
+            /**
+             * @brief Feed a speed measurement and get the next duty
+             */
+            float update(float rpm, duration_type dt);
+
+            State state() const { return m_status.state; }
+            const Status &status() const { return m_status; }
+            float setpoint() const { return m_setpoint; }
+
+        private:
+            float m_setpoint;
+            float m_amplitude;
+            Status m_status;
+
+            bool m_high;
+            bool m_started;         // First switch seen, half cycle times are valid from here
+            duration_type m_time;
+            duration_type m_last_switch;
+            duration_type m_high_time;
+            float m_max;
+            float m_min;
+
+            float m_period_sum;
+            float m_swing_sum;
+
+            void cycle(duration_type high, duration_type low);
+            void finish();
+            void fail(const char *reason);
+    };
+
+    std::ostream &operator<<(std::ostream &os, const Autotune::State &state);
+
+}
+
+#endif
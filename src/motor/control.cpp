@@ -5,6 +5,8 @@
 #include <boost/format.hpp>
 #include <boost/log/trivial.hpp>
 
+#include <robotlogging.h>
+#include <metrics/trace.h>
 #include <robotcontext.h>
 #include "types.h"
 #include "motor.h"
@@ -27,8 +29,21 @@ Control::Control(const std::shared_ptr<Robot::Context> &context) :
     m_motor_strand { context->io() },
     m_servo_strand { context->io() },
     m_motor_timer { context->io() },
-    m_servo_timer { context->io() }
+    m_servo_timer { context->io() },
+    m_generation { 0u },
+    m_traction_control { MOTOR_TRACTION_CONTROL },
+    m_motor_tick_duration { Metrics::registry().histogram("robot_motor_tick_duration_seconds", "Time spent updating the motors") },
+    m_motor_tick_lateness { Metrics::registry().histogram("robot_motor_tick_lateness_seconds", "Delay from motor timer expiry until the tick ran") },
+    m_motor_tick_overruns { Metrics::registry().counter("robot_motor_tick_overruns", "Motor ticks starting more than one interval late") },
+    m_servo_tick_duration { Metrics::registry().histogram("robot_servo_tick_duration_seconds", "Time spent updating the servos") },
+    m_servo_tick_lateness { Metrics::registry().histogram("robot_servo_tick_lateness_seconds", "Delay from servo timer expiry until the tick ran") },
+    m_servo_tick_overruns { Metrics::registry().counter("robot_servo_tick_overruns", "Servo ticks starting more than one interval late") },
+    m_slip_events { Metrics::registry().counter("robot_motor_slip_events", "Wheels detected slipping") },
+    m_stall_events { Metrics::registry().counter("robot_motor_stall_events", "Wheels detected stalled") },
+    m_motor_perf { Metrics::PerfLoop::get("motor") },
+    m_servo_perf { Metrics::PerfLoop::get("servo") }
 {
+    Motor::registerProperties(context);
     for (uint i=0; i<MOTOR_COUNT; i++) {
         m_servos[i] = std::make_unique<Servo>(i, context, m_servo_strand);
         m_motors[i] = std::make_unique<Motor>(i, context, m_motor_strand, m_servos[i].get());
@@ -59,6 +74,8 @@ void Control::init()
     for (auto &motor : m_motors) {
         motor->init();
     }
+    m_traction.reset();
+    m_traction_control = m_context->properties(Motor::PROPERTY_GROUP).get(Motor::PROPERTY_TRACTION_CONTROL, MOTOR_TRACTION_CONTROL);
 
     if (m_context->motorPower()) {
         onMotorPower(true);
@@ -93,10 +110,58 @@ void Control::cleanup()
 
 
 
+void Control::setTractionControl(bool enabled)
+{
+    BOOST_LOG_TRIVIAL(info) << *this << " Traction control " << (enabled ? "enabled" : "disabled");
+    m_traction_control.store(enabled, std::memory_order_relaxed);
+}
+
+
+
+std::uint32_t Control::commit(const Transaction &transaction)
+{
+    // The ticks hold their mutex while updating, so neither runs in the middle of the set
+    const std::scoped_lock lock(m_motor_mutex, m_servo_mutex);
+    for (auto i=0u; i<MOTOR_COUNT; i++) {
+        switch (transaction.m_throttle_mode[i]) {
+            case Transaction::Throttle::KEEP:
+                break;
+            case Transaction::Throttle::DUTY:
+                m_motors[i]->setDuty(transaction.m_throttle[i]);
+                break;
+            case Transaction::Throttle::RPM:
+                m_motors[i]->setTargetRPM(transaction.m_throttle[i]);
+                break;
+        }
+        if (transaction.m_servo_set[i]) {
+            m_servos[i]->setValue(transaction.m_servo[i]);
+        }
+    }
+    return m_generation.fetch_add(1u, std::memory_order_acq_rel) + 1u;
+}
+
+
+void Control::setDuty(const MotorValues &duty)
+{
+    Transaction transaction;
+    transaction.setDuty(duty);
+    commit(transaction);
+}
+
+
+void Control::setTargetRPM(const MotorValues &rpm)
+{
+    Transaction transaction;
+    transaction.setTargetRPM(rpm);
+    commit(transaction);
+}
+
+
+
 void Control::onMotorPower(bool enabled) 
 {
     const guard lock(m_mutex);
-    BOOST_LOG_TRIVIAL(trace) << "MotorControl::onMotorPower " << enabled;
+    ROBOT_LOG(trace) << "MotorControl::onMotorPower " << enabled;
     if (!m_initialized)
         return;
 
@@ -116,7 +181,7 @@ void Control::onMotorPower(bool enabled)
 void Control::onServoPower(bool enabled)
 {
     const guard lock(m_mutex);
-    BOOST_LOG_TRIVIAL(trace) << "MotorControl::onServoPower " << enabled;
+    ROBOT_LOG(trace) << "MotorControl::onServoPower " << enabled;
     if (!m_initialized)
         return;
 
@@ -137,23 +202,71 @@ void Control::onServoPower(bool enabled)
 
 void Control::motorTimer() 
 {
+    ROBOT_TRACE_SCOPE("motor.tick");
     const guard lock(m_motor_mutex);
     //BOOST_LOG_TRIVIAL(trace) << __FUNCTION__;
 
+    auto start = timer_type::clock_type::now();
+    auto lateness = start - m_motor_timer.expiry();
+    m_motor_tick_lateness->observe(lateness);
+    if (lateness>MOTOR_TIMER_INTERVAL) {
+        m_motor_tick_overruns->inc();
+    }
+
     // Update motors
-    for (auto &motor : m_motors) {
-        motor->update();
+    {
+        const Metrics::PerfLoop::Scope perf { *m_motor_perf };
+        for (auto &motor : m_motors) {
+            motor->update();
+        }
+        updateTraction();
+        sig_motor(m_motors);
     }
-    sig_motor(m_motors);
+
+    m_motor_tick_duration->observe(timer_type::clock_type::now() - start);
 
     motorTimerSetup();
 }
 
+void Control::updateTraction()
+{
+    MotorValues expected;
+    MotorValues rpm;
+    for (auto i=0u; i<MOTOR_COUNT; i++) {
+        expected[i] = m_motors[i]->getExpectedRPM();
+        rpm[i] = m_motors[i]->getRPM();
+    }
+
+    // Limits take effect with the duty written in the next tick
+    const auto changed = m_traction.update(expected, rpm);
+    const auto limit = m_traction_control.load(std::memory_order_relaxed);
+    for (auto i=0u; i<MOTOR_COUNT; i++) {
+        auto &motor = m_motors[i];
+        motor->m_traction_limit = limit ? m_traction.limit(i) : 1.0f;
+        if (!changed || m_traction.state(i)==motor->m_traction)
+            continue;
+        motor->m_traction = m_traction.state(i);
+        switch (motor->m_traction) {
+            case Traction::State::SLIP:
+                m_slip_events->inc();
+                BOOST_LOG_TRIVIAL(warning) << *motor << " Slipping at " << rpm[i] << " RPM, expected " << expected[i]*m_traction.reference();
+                break;
+            case Traction::State::STALL:
+                m_stall_events->inc();
+                BOOST_LOG_TRIVIAL(warning) << *motor << " Stalled at " << rpm[i] << " RPM, expected " << expected[i];
+                break;
+            case Traction::State::GRIP:
+                BOOST_LOG_TRIVIAL(info) << *motor << " Traction regained";
+                break;
+        }
+    }
+}
+
 void Control::motorTimerSetup() {
     m_motor_timer.expires_at(m_motor_timer.expiry() + MOTOR_TIMER_INTERVAL);
     m_motor_timer.async_wait(boost::asio::bind_executor(m_servo_strand, 
         [this] (boost::system::error_code error) {
-            if (error!=boost::system::errc::success) {
+            if (error!=boost::system::errc::success || !m_initialized) {
                 return;
             }
             motorTimer(); 
@@ -166,11 +279,25 @@ void Control::motorTimerSetup() {
 
 void Control::servoTimer() 
 {
+    ROBOT_TRACE_SCOPE("servo.tick");
     const guard lock(m_servo_mutex);
-    for (auto &servo : m_servos) {
-        servo->update();
+
+    auto start = timer_type::clock_type::now();
+    auto lateness = start - m_servo_timer.expiry();
+    m_servo_tick_lateness->observe(lateness);
+    if (lateness>SERVO_TIMER_INTERVAL) {
+        m_servo_tick_overruns->inc();
     }
-    sig_servo(m_servos);
+
+    {
+        const Metrics::PerfLoop::Scope perf { *m_servo_perf };
+        for (auto &servo : m_servos) {
+            servo->update();
+        }
+        sig_servo(m_servos);
+    }
+
+    m_servo_tick_duration->observe(timer_type::clock_type::now() - start);
 
     servoTimerSetup();
 }
@@ -179,7 +306,7 @@ void Control::servoTimerSetup() {
     m_servo_timer.expires_at(m_servo_timer.expiry() + SERVO_TIMER_INTERVAL);
     m_servo_timer.async_wait(boost::asio::bind_executor(m_servo_strand, 
         [this] (boost::system::error_code error) {
-            if (error!=boost::system::errc::success) {
+            if (error!=boost::system::errc::success || !m_initialized) {
                 return;
             }
             servoTimer(); 
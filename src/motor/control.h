@@ -4,7 +4,9 @@
 #include <memory>
 #include <array>
 #include <mutex>
+#include <atomic>
 #include <chrono>
+#include <cstdint>
 #include <iostream>
 #include <boost/asio.hpp>
 #include <boost/signals2.hpp>
@@ -13,7 +15,11 @@
 #include <robottypes.h>
 #include <common/withnotify.h>
 #include <common/withmutex.h>
+#include <metrics/metrics.h>
+#include <metrics/perfcounters.h>
 #include "types.h"
+#include "transaction.h"
+#include "traction.h"
 
 namespace Robot::Motor {
 
@@ -41,6 +47,36 @@ namespace Robot::Motor {
             const ServoList &getServos() const { return m_servos; }
             const ServoList::value_type &getServo(ServoList::size_type position) { return m_servos[position]; }
 
+            /**
+             * @brief Apply a staged command set to the motors and servos
+             *
+             * The motor and servo ticks are held off while the set is applied, so a
+             * tick sees either none or all of it.
+             *
+             * @return Generation of the applied command set
+             */
+            std::uint32_t commit(const Transaction &transaction);
+            /// Generation of the last committed command set
+            std::uint32_t getGeneration() const { return m_generation.load(std::memory_order_acquire); }
+
+            /**
+             * @brief Set the duty of all motors, applied together in the same motor tick
+             */
+            void setDuty(const MotorValues &duty);
+            /**
+             * @brief Set the target RPM of all motors, applied together in the same motor tick
+             */
+            void setTargetRPM(const MotorValues &rpm);
+
+            /**
+             * @brief Limit the duty of slipping wheels in DUTY mode
+             *
+             * Slip and stall are detected every motor tick either way, when disabled
+             * they are only reported.
+             */
+            void setTractionControl(bool enabled);
+            bool getTractionControl() const { return m_traction_control.load(std::memory_order_relaxed); }
+
             motor_mutex_type &motorMutex() const { return m_motor_mutex; }
             motor_mutex_type &servoMutex() const { return m_motor_mutex; }
 
@@ -62,12 +98,27 @@ namespace Robot::Motor {
             mutable servo_mutex_type m_servo_mutex;
             MotorList m_motors;
             ServoList m_servos;
+            std::atomic<std::uint32_t> m_generation;
+            Traction m_traction;
+            std::atomic<bool> m_traction_control;
+
+            std::shared_ptr<Metrics::Histogram> m_motor_tick_duration;
+            std::shared_ptr<Metrics::Histogram> m_motor_tick_lateness;
+            std::shared_ptr<Metrics::Counter> m_motor_tick_overruns;
+            std::shared_ptr<Metrics::Histogram> m_servo_tick_duration;
+            std::shared_ptr<Metrics::Histogram> m_servo_tick_lateness;
+            std::shared_ptr<Metrics::Counter> m_servo_tick_overruns;
+            std::shared_ptr<Metrics::Counter> m_slip_events;
+            std::shared_ptr<Metrics::Counter> m_stall_events;
+            std::shared_ptr<Metrics::PerfLoop> m_motor_perf;
+            std::shared_ptr<Metrics::PerfLoop> m_servo_perf;
 
             void onMotorPower(bool enabled);
             void onServoPower(bool enabled);
 
             void motorTimerSetup();
             inline void motorTimer();
+            inline void updateTraction();
 
             void servoTimerSetup();
             inline void servoTimer();
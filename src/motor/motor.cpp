@@ -6,7 +6,10 @@
 #include <boost/log/trivial.hpp>
 
 #include <robotconfig.h>
+#include <robotlogging.h>
+#include <metrics/probes.h>
 #include <robotcontext.h>
+#include <simulation/plant.h>
 #include "servo.h"
 
 using namespace std::literals;
@@ -14,19 +17,10 @@ using namespace Robot::Config;
 
 namespace Robot::Motor {
 
-static constexpr auto MOTOR_DEADZONE { 0.05 };
-static constexpr auto DUTY_MIN_CHANGE { 0.02 };
-
-static constexpr auto PID_P { 0.0012f };
-static constexpr auto PID_I { 0.0004f };
-static constexpr auto PID_D { 0.0001f };
-static constexpr auto PID_EMA_ALPHA { 0.9f };
 static constexpr Robot::Math::PID::sample_time_type PID_INTERVAL { MOTOR_TIMER_INTERVAL };
 
 static constexpr auto MINUTE { std::chrono::duration_cast<std::chrono::microseconds>(1min) };
 
-static constexpr auto SIMULATED_RPM_MAX { 180.0 };
-
 Motor::Motor(uint index, const std::shared_ptr<Robot::Context> &context, const strand_type &strand, class Servo *servo) :
     WithStrand { strand },
     m_context { context },
@@ -41,7 +35,14 @@ Motor::Motor(uint index, const std::shared_ptr<Robot::Context> &context, const s
     m_duty_set { 0.0f },
     m_target_rpm { 0.0f },
     m_rpm { 0.0f },
-    m_pid { PID_P, PID_I, PID_D, PID_INTERVAL, PID_EMA_ALPHA }
+    m_pid { MOTOR_PID_P, MOTOR_PID_I, MOTOR_PID_D, PID_INTERVAL, MOTOR_PID_EMA_ALPHA },
+    m_profile { MOTOR_ACCEL_MAX, MOTOR_JERK_MAX },
+    m_ff_kv { MOTOR_FF_KV },
+    m_ff_ks { MOTOR_FF_KS },
+    m_direct { false },
+    m_direct_duty { 0.0f },
+    m_traction { Traction::State::GRIP },
+    m_traction_limit { 1.0f }
 {
     m_pid.setLimits(-1.0f, 1.0f);
 }
@@ -54,21 +55,49 @@ Motor::~Motor()
 }
 
 
+void Motor::registerProperties(const std::shared_ptr<Robot::Context> &context)
+{
+    PropertyMap values;
+    values.put(PROPERTY_PID_P, MOTOR_PID_P);
+    values.put(PROPERTY_PID_I, MOTOR_PID_I);
+    values.put(PROPERTY_PID_D, MOTOR_PID_D);
+    values.put(PROPERTY_FF_KV, MOTOR_FF_KV);
+    values.put(PROPERTY_FF_KS, MOTOR_FF_KS);
+    values.put(PROPERTY_ACCEL_MAX, MOTOR_ACCEL_MAX);
+    values.put(PROPERTY_JERK_MAX, MOTOR_JERK_MAX);
+    values.put(PROPERTY_TRACTION_CONTROL, MOTOR_TRACTION_CONTROL);
+    context->registerProperties(PROPERTY_GROUP, values);
+}
+
+
 void Motor::init() 
 {
     #if ROBOT_PLATFORM == ROBOT_PLATFORM_BEAGLEBONE
     rc_ext_encoder_read(encoderChannel());
     #else
-    m_last_enc_value = 0;
+    m_plant = m_context->plant();
+    m_last_enc_value = m_plant ? m_plant->encoder(m_index) : 0;
     #endif
     m_odometer_base = m_last_enc_value;
     m_last_update = clock_type::now();
+
+    const auto &properties = m_context->properties(PROPERTY_GROUP);
+    m_pid.set(properties.get(PROPERTY_PID_P, MOTOR_PID_P), properties.get(PROPERTY_PID_I, MOTOR_PID_I), properties.get(PROPERTY_PID_D, MOTOR_PID_D));
+    m_ff_kv = properties.get(PROPERTY_FF_KV, MOTOR_FF_KV);
+    m_ff_ks = properties.get(PROPERTY_FF_KS, MOTOR_FF_KS);
+    m_profile.setLimits(properties.get(PROPERTY_ACCEL_MAX, MOTOR_ACCEL_MAX), properties.get(PROPERTY_JERK_MAX, MOTOR_JERK_MAX));
+    m_profile.reset();
     m_rpm = 0;
     m_duty = 0.0;
     m_target_rpm = 0.0;
+    m_traction = Traction::State::GRIP;
+    m_traction_limit = 1.0f;
 
     #if ROBOT_PLATFORM == ROBOT_PLATFORM_BEAGLEBONE
     rc_motor_free_spin(motorChannel());
+    #else
+    if (m_plant)
+        m_plant->motorFreeSpin(m_index);
     #endif
     m_mode = Mode::FREE_SPIN;
 
@@ -89,9 +118,14 @@ void Motor::brake()
 {
     const guard lock(m_mutex);
     if (m_mode != Mode::BRAKE) {
+        m_autotune.cancel();
         m_mode = Mode::BRAKE;
+        updateDirect();
         #if ROBOT_PLATFORM == ROBOT_PLATFORM_BEAGLEBONE
         rc_motor_brake(motorChannel());
+        #else
+        if (m_plant)
+            m_plant->motorBrake(m_index);
         #endif
         notify(NOTIFY_DEFAULT);
     }
@@ -101,9 +135,14 @@ void Motor::freeSpin()
 {
     const guard lock(m_mutex);
     if (m_mode != Mode::FREE_SPIN) {
+        m_autotune.cancel();
         m_mode = Mode::FREE_SPIN;
+        updateDirect();
         #if ROBOT_PLATFORM == ROBOT_PLATFORM_BEAGLEBONE
         rc_motor_free_spin(motorChannel());
+        #else
+        if (m_plant)
+            m_plant->motorFreeSpin(m_index);
         #endif
         notify(NOTIFY_DEFAULT);
     }
@@ -119,8 +158,10 @@ void Motor::setDuty(float duty)
 {
     const guard lock(m_mutex);
     if (duty != m_duty || m_mode != Mode::DUTY) {
-        BOOST_LOG_TRIVIAL(trace) << *this << " setDuty(" << duty << ")";
+        ROBOT_LOG(trace) << *this << " setDuty(" << duty << ")";
+        m_autotune.cancel();
         m_mode = Mode::DUTY;
+        updateDirect();
         m_duty = duty;
         notify(NOTIFY_DEFAULT);
     }
@@ -131,34 +172,109 @@ void Motor::setTargetRPM(float rpm)
     const guard lock(m_mutex);
     if (m_mode!=Mode::RPM || m_target_rpm != rpm) {
         if (m_mode!=Mode::RPM) {
+            // Ramp from the current wheel speed
+            m_autotune.cancel();
             m_pid.reset();
+            m_profile.reset(m_rpm);
             m_mode = Mode::RPM;
+            updateDirect();
         }
         m_target_rpm = rpm;
-        m_pid.setSetpoint(rpm);
+        m_profile.setTarget(rpm);
+        notify(NOTIFY_DEFAULT);
+    }
+}
+
+
+void Motor::setDirect()
+{
+    const guard lock(m_mutex);
+    if (m_mode != Mode::DIRECT) {
+        ROBOT_LOG(trace) << *this << " setDirect()";
+        m_autotune.cancel();
+        m_mode = Mode::DIRECT;
+        m_duty = m_duty_set;
+        m_direct_duty.store(m_duty_set, std::memory_order_relaxed);
+        updateDirect();
+        notify(NOTIFY_DEFAULT);
+    }
+}
+
+
+bool Motor::writeDirect(float duty)
+{
+    if (!m_direct.load(std::memory_order_acquire))
+        return false;
+    m_direct_duty.store(duty, std::memory_order_relaxed);
+    writeDuty(fabs(duty)<MOTOR_DEADZONE ? 0.0f : duty);
+    return true;
+}
+
+
+void Motor::startAutotune(float rpm, float amplitude)
+{
+    const guard lock(m_mutex);
+    BOOST_LOG_TRIVIAL(info) << *this << " startAutotune(" << rpm << ", " << amplitude << ")";
+    m_autotune.start(rpm, amplitude);
+    m_mode = Mode::AUTOTUNE;
+    updateDirect();
+    m_target_rpm = rpm;
+    notify(NOTIFY_DEFAULT);
+}
+
+
+void Motor::cancelAutotune()
+{
+    const guard lock(m_mutex);
+    if (m_mode==Mode::AUTOTUNE) {
+        m_autotune.cancel();
+        m_mode = Mode::DUTY;
+        m_duty = 0.0f;
         notify(NOTIFY_DEFAULT);
     }
 }
 
 
+Autotune::Status Motor::getAutotune() const
+{
+    const guard lock(m_mutex);
+    return m_autotune.status();
+}
+
+
+void Motor::autotuneDone()
+{
+    const auto &status = m_autotune.status();
+    if (status.state==Autotune::State::DONE) {
+        const auto &result = status.result;
+        m_pid.set(result.p, result.i, result.d);
+        m_profile.reset(m_rpm);
+        m_profile.setTarget(m_target_rpm);
+        m_mode = Mode::RPM;
+    }
+    else {
+        m_mode = Mode::DUTY;
+        m_duty = 0.0f;
+    }
+    defer([this]{ notify(NOTIFY_DEFAULT); });
+}
+
+
 void Motor::setEnabled(bool enabled) 
 {
     const guard lock(m_mutex);
     if (enabled!=m_enabled) {
         m_enabled = enabled;
-        BOOST_LOG_TRIVIAL(trace) << *this << " Enable " << enabled;
+        updateDirect();
+        ROBOT_LOG(trace) << *this << " Enable " << enabled;
         m_context->motorPower(m_enabled);
         if (m_enabled) {
             m_duty_set = m_duty;
-            #if ROBOT_PLATFORM == ROBOT_PLATFORM_BEAGLEBONE
-            rc_motor_set(motorChannel(), m_duty_set);
-            #endif
+            writeDuty(m_duty_set);
         }
         else {
             m_duty_set = 0.0;
-            #if ROBOT_PLATFORM == ROBOT_PLATFORM_BEAGLEBONE
-            rc_motor_set(motorChannel(), m_duty_set);
-            #endif
+            writeDuty(m_duty_set);
         }
         notify(NOTIFY_DEFAULT);
     }
@@ -189,6 +305,8 @@ void Motor::update()
     if (!m_enabled)
         return;
 
+    ROBOT_PROBE1(motor__update__entry, m_index);
+
     bool changed = false;
     auto now = clock_type::now();
     auto diff = duration_cast<microseconds>(now-m_last_update);
@@ -198,7 +316,7 @@ void Motor::update()
     #if ROBOT_PLATFORM == ROBOT_PLATFORM_BEAGLEBONE
     int32_t value = rc_ext_encoder_read(encoderChannel());
     #else
-    int32_t value = m_last_enc_value + (m_duty/20.0*WHEEL_ENCODER_CPR*WHEEL_GEARING);
+    int32_t value = m_plant ? m_plant->encoder(m_index) : m_last_enc_value;
     #endif
     auto value_diff = value-m_last_enc_value;
     float rpm = (float)(value_diff*MINUTE.count())/((float)(WHEEL_ENCODER_CPR*WHEEL_GEARING)*diff.count());
@@ -210,23 +328,38 @@ void Motor::update()
     m_rpm = new_rpm;
     m_last_enc_value = value;
 
-    // Update PID
+    // Update PID, feed forward along the motion profile and only correct the residual
     if (m_mode == Mode::RPM) {
-        m_duty = m_pid.update(m_rpm);
+        auto reference = m_profile.update(diff);
+        auto feed_forward = feedForward(reference);
+        m_pid.setSetpoint(reference);
+        m_pid.setLimits(-1.0f-feed_forward, 1.0f-feed_forward);
+        m_duty = feed_forward + m_pid.update(m_rpm);
     }
-
-    // Update motor duty cycle
-    if (fabs(m_duty-m_duty_set)>DUTY_MIN_CHANGE) {
-        BOOST_LOG_TRIVIAL(trace) << *this << " Duty " << m_duty_set << " -> " << m_duty;
-        #if ROBOT_PLATFORM == ROBOT_PLATFORM_BEAGLEBONE
-        if (fabs(m_duty)<MOTOR_DEADZONE) {
-            rc_motor_set(motorChannel(), 0.0);
+    else if (m_mode == Mode::AUTOTUNE) {
+        m_duty = m_autotune.update(m_rpm, diff);
+        if (m_autotune.state()!=Autotune::State::RUNNING) {
+            autotuneDone();
         }
-        else {
-            rc_motor_set(motorChannel(), m_duty);
+    }
+
+    // The direct writer owns the driver, only keep track of what it wrote
+    if (m_mode == Mode::DIRECT) {
+        m_duty = m_duty_set = m_direct_duty.load(std::memory_order_relaxed);
+    }
+    // Update motor duty cycle, scaled down by the traction monitor while slipping
+    else {
+        const auto duty = m_mode==Mode::DUTY ? m_duty*m_traction_limit : m_duty;
+        if (fabs(duty-m_duty_set)>MOTOR_DUTY_MIN_CHANGE) {
+            ROBOT_LOG(trace) << *this << " Duty " << m_duty_set << " -> " << duty;
+            if (fabs(duty)<MOTOR_DEADZONE) {
+                writeDuty(0.0);
+            }
+            else {
+                writeDuty(duty);
+            }
+            m_duty_set = duty;
         }
-        #endif
-        m_duty_set = m_duty;
     }
 
     if (changed) {
@@ -234,6 +367,8 @@ void Motor::update()
     }
 
     m_last_update = now;
+
+    ROBOT_PROBE4(motor__update__exit, m_index, ROBOT_PROBE_MILLI(m_rpm), ROBOT_PROBE_MILLI(m_duty_set), ROBOT_PROBE_MILLI(m_mode==Mode::RPM ? m_duty : 0.0f));
 }
 
 
@@ -247,5 +382,43 @@ inline uint Motor::motorChannel() const {
     return m_index+1;
 }
 
+inline float Motor::feedForward(float rpm) const {
+    if (rpm==0.0f)
+        return 0.0f;
+    return m_ff_kv*rpm + std::copysign(m_ff_ks, rpm);
+}
+
+float Motor::getExpectedRPM() const
+{
+    if (!m_enabled)
+        return 0.0f;
+    switch (m_mode) {
+        case Mode::DUTY: {
+            // Steady state speed of the commanded duty, the inverse of the feed forward
+            const auto duty = std::abs(m_duty);
+            if (duty<MOTOR_DEADZONE || duty<=m_ff_ks || m_ff_kv<=0.0f)
+                return 0.0f;
+            return std::copysign((duty-m_ff_ks)/m_ff_kv, m_duty);
+        }
+        case Mode::RPM:
+            return m_profile.getVelocity();
+        default:
+            return 0.0f;
+    }
+}
+
+inline void Motor::updateDirect() {
+    m_direct.store(m_enabled && m_mode==Mode::DIRECT, std::memory_order_release);
+}
+
+inline void Motor::writeDuty(float duty) {
+    #if ROBOT_PLATFORM == ROBOT_PLATFORM_BEAGLEBONE
+    rc_motor_set(motorChannel(), duty);
+    #else
+    if (m_plant)
+        m_plant->motorSet(m_index, duty);
+    #endif
+}
+
 
 }
@@ -2,8 +2,10 @@
 #define _ROBOT_MOTOR_H_
 
 #include <memory>
+#include <string>
 #include <chrono>
 #include <mutex>
+#include <atomic>
 #include <iostream>
 #include <boost/asio.hpp>
 #include <boost/signals2.hpp>
@@ -11,10 +13,17 @@
 #include <robotconfig.h>
 #include <robottypes.h>
 #include <math/pid.h>
+#include <math/motionprofile.h>
 #include <common/withstrand.h>
 #include <common/withmutex.h>
 #include <common/withnotify.h>
 #include "types.h"
+#include "autotune.h"
+#include "traction.h"
+
+namespace Robot::Simulation {
+    class Plant;
+}
 
 namespace Robot::Motor {
 
@@ -22,6 +31,16 @@ namespace Robot::Motor {
         public:
             static constexpr notify_type NOTIFY_TELEMETRY { 1 };
 
+            inline static const std::string PROPERTY_GROUP { "motor" };
+            inline static const std::string PROPERTY_PID_P { "pid_p" };
+            inline static const std::string PROPERTY_PID_I { "pid_i" };
+            inline static const std::string PROPERTY_PID_D { "pid_d" };
+            inline static const std::string PROPERTY_FF_KV { "ff_kv" };
+            inline static const std::string PROPERTY_FF_KS { "ff_ks" };
+            inline static const std::string PROPERTY_ACCEL_MAX { "accel_max" };
+            inline static const std::string PROPERTY_JERK_MAX { "jerk_max" };
+            inline static const std::string PROPERTY_TRACTION_CONTROL { "traction_control" };
+
             using clock_type = std::chrono::high_resolution_clock;
 
             using odometer_type = std::int32_t;
@@ -31,7 +50,9 @@ namespace Robot::Motor {
                 DUTY,
                 RPM,
                 FREE_SPIN,
-                BRAKE
+                BRAKE,
+                AUTOTUNE,
+                DIRECT
             };
 
             Motor(uint index, const std::shared_ptr<::Robot::Context> &context, const strand_type &strand, class Servo *servo);
@@ -50,18 +71,70 @@ namespace Robot::Motor {
             void setValue(const Value value);
             void setDuty(float duty);
             float getDuty() const { return m_duty; }
+            /**
+             * @brief Duty cycle last written to the motor driver by the motor tick
+             */
+            float getOutputDuty() const { return m_duty_set; }
             void setTargetRPM(float rpm);
             float getTargetRPM() const { return m_target_rpm; }
+            /**
+             * @brief RPM the loop is currently tracking on its way to the target
+             */
+            float getReferenceRPM() const { return m_profile.getVelocity(); }
+
+            /**
+             * @brief Run a relay auto-tune experiment around the RPM setpoint
+             *
+             * The wheel must be lifted. When the experiment completes the derived
+             * gains are applied and the motor continues in RPM mode at the setpoint.
+             */
+            /**
+             * @brief Hand the duty cycle to a single real-time writer
+             *
+             * In DIRECT mode the motor tick only measures the wheel speed, the duty is
+             * written by writeDirect(). Any other mode setter ends DIRECT mode.
+             */
+            void setDirect();
+            /**
+             * @brief Write the duty cycle straight to the motor driver
+             *
+             * Lock-free, the motor mutex is not taken and the motor tick is not waited
+             * for. Only one thread may call it. Ignored, returning false, unless the
+             * motor is enabled and in DIRECT mode.
+             */
+            bool writeDirect(float duty);
+
+            void startAutotune(float rpm, float amplitude = MOTOR_AUTOTUNE_AMPLITUDE);
+            void cancelAutotune();
+            Autotune::Status getAutotune() const;
 
             Mode getMode() const { return m_mode; }
             float getRPM() const { return m_rpm; }
 
+            /**
+             * @brief RPM the wheel should run at for its command on firm ground
+             *
+             * The steady state speed of the duty in DUTY mode and the profile
+             * reference in RPM mode, 0 in the other modes.
+             */
+            float getExpectedRPM() const;
+            /**
+             * @brief Traction of the wheel as seen by the traction monitor in Control
+             */
+            Traction::State getTraction() const { return m_traction; }
+            /**
+             * @brief Factor the duty is scaled with while the wheel slips in DUTY mode
+             */
+            float getTractionLimit() const { return m_traction_limit; }
+
             void resetOdometer();
             odometer_type getOdometer() const;
             encoder_type getEncoderValue() const { return m_last_enc_value-m_odometer_base; }
 
             class Servo *servo() const { return m_servo; }
 
+            static void registerProperties(const std::shared_ptr<::Robot::Context> &context);
+
         protected:
             void init();
             void cleanup();
@@ -74,6 +147,9 @@ namespace Robot::Motor {
             bool m_initialized;
             const uint m_index;
             class Servo *m_servo;
+            #if ROBOT_PLATFORM == ROBOT_PLATFORM_PC
+            std::shared_ptr<::Robot::Simulation::Plant> m_plant;
+            #endif
 
             bool m_enabled;
             Mode m_mode;
@@ -89,9 +165,21 @@ namespace Robot::Motor {
             float m_rpm;
 
             Robot::Math::PID m_pid;
+            Robot::Math::MotionProfile m_profile;
+            float m_ff_kv;
+            float m_ff_ks;
+            Autotune m_autotune;
+            std::atomic<bool> m_direct; // Enabled and in DIRECT mode
+            std::atomic<float> m_direct_duty;
+            Traction::State m_traction;
+            float m_traction_limit;
 
             inline uint encoderChannel() const;
             inline uint motorChannel() const;
+            inline void writeDuty(float duty);
+            inline float feedForward(float rpm) const;
+            inline void updateDirect();
+            void autotuneDone();
 
             friend std::ostream &operator<<(std::ostream &os, const Motor &self)
             {
@@ -7,7 +7,9 @@
 #include <boost/log/trivial.hpp>
 
 #include <robotconfig.h>
+#include <robotlogging.h>
 #include <robotcontext.h>
+#include <simulation/plant.h>
 #include "control.h"
 
 using namespace std::literals;
@@ -46,6 +48,9 @@ Servo::~Servo()
 
 void Servo::init() 
 {
+    #if ROBOT_PLATFORM == ROBOT_PLATFORM_PC
+    m_plant = m_context->plant();
+    #endif
     m_value = Value::CENTER;
     m_initialized = true;
 }
@@ -65,7 +70,7 @@ void Servo::setEnabled(bool enabled)
     const guard lock(m_mutex);
     if (enabled!=m_enabled) {
         m_enabled = enabled;
-        BOOST_LOG_TRIVIAL(trace) << *this << " Enable " << enabled;
+        ROBOT_LOG(trace) << *this << " Enable " << enabled;
         m_context->servoPower(m_enabled);
     }
 }
@@ -74,7 +79,7 @@ void Servo::setEnabled(bool enabled)
 void Servo::setValue(const Value value)
 {
     const guard lock(m_mutex);
-    BOOST_LOG_TRIVIAL(trace) << *this << " Value " << value << " ( angle=" << value.asAngleDegrees() << " )";
+    ROBOT_LOG(trace) << *this << " Value " << value << " ( angle=" << value.asAngleDegrees() << " )";
     auto v = value.clamp(m_limit_min, m_limit_max);
     if (m_value != v) {
         m_value = v;
@@ -119,6 +124,9 @@ void Servo::update()
         //BOOST_LOG_TRIVIAL(info) << "Pulse";
         #if ROBOT_PLATFORM == ROBOT_PLATFORM_BEAGLEBONE
         rc_servo_send_pulse_us(servoChannel(), m_value.asServoPulse()+m_trim);
+        #else
+        if (m_plant)
+            m_plant->servoSendPulse(m_index, m_value.asServoPulse()+m_trim);
         #endif
     }
 }
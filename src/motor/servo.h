@@ -5,12 +5,17 @@
 #include <memory>
 #include <mutex>
 #include <iostream>
+#include <robotconfig.h>
 #include <robottypes.h>
 #include <common/withstrand.h>
 #include <common/withmutex.h>
 #include <common/withnotify.h>
 #include "types.h"
 
+namespace Robot::Simulation {
+    class Plant;
+}
+
 namespace Robot::Motor {
 
     class Servo : public WithMutexStd, public WithNotifyInt, public WithStrand {
@@ -47,6 +52,9 @@ namespace Robot::Motor {
             std::shared_ptr<::Robot::Context> m_context;
             bool m_initialized;
             const uint m_index;
+            #if ROBOT_PLATFORM == ROBOT_PLATFORM_PC
+            std::shared_ptr<::Robot::Simulation::Plant> m_plant;
+            #endif
             bool m_enabled;
             Value m_value;
 
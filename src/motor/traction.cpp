@@ -0,0 +1,109 @@
+#include "traction.h"
+
+#include <cmath>
+#include <algorithm>
+
+namespace Robot::Motor {
+
+
+Traction::Traction()
+{
+    reset();
+}
+
+
+void Traction::reset()
+{
+    m_states.fill(State::GRIP);
+    m_limits.fill(1.0f);
+    m_slip_ticks.fill(0u);
+    m_stall_ticks.fill(0u);
+    m_reference = 0.0f;
+}
+
+
+bool Traction::update(const MotorValues &expected, const MotorValues &rpm)
+{
+    std::array<bool, MOTOR_COUNT> driven;
+    MotorValues ratio;
+    MotorValues sorted;
+    std::size_t count = 0;
+    for (std::size_t i=0; i<MOTOR_COUNT; i++) {
+        driven[i] = std::abs(expected[i])>=EXPECTED_MIN;
+        ratio[i] = driven[i] ? rpm[i]/expected[i] : 0.0f;
+        if (driven[i]) {
+            sorted[count++] = ratio[i];
+        }
+    }
+
+    // Lower median, with a wheel spinning up the reference stays on a gripping one
+    std::sort(sorted.begin(), sorted.begin()+count);
+    m_reference = count>0 ? sorted[(count-1)/2] : 0.0f;
+
+    // A single driven wheel has nothing to be compared with
+    const auto comparable = count>1 && m_reference>STALL_RATIO;
+
+    bool changed = false;
+    for (std::size_t i=0; i<MOTOR_COUNT; i++) {
+        auto state = State::GRIP;
+        auto slipping = false;
+        if (driven[i]) {
+            const auto stalled = ratio[i]<STALL_RATIO;
+            slipping = comparable
+                && ratio[i] > m_reference*(1.0f+SLIP_RATIO)
+                && (ratio[i]-m_reference)*std::abs(expected[i]) > SLIP_RPM;
+            // Once slipping the wheel has to get back within half the margin
+            const auto released = !comparable || ratio[i] <= m_reference*(1.0f+SLIP_RATIO/2.0f);
+            m_stall_ticks[i] = stalled ? m_stall_ticks[i]+1 : 0u;
+            if (slipping) {
+                m_slip_ticks[i]++;
+            }
+            else if (m_states[i]!=State::SLIP || released) {
+                m_slip_ticks[i] = 0u;
+            }
+            if (m_stall_ticks[i]>=STALL_TICKS) {
+                state = State::STALL;
+            }
+            else if (m_slip_ticks[i]>=SLIP_TICKS) {
+                state = State::SLIP;
+            }
+        }
+        else {
+            m_stall_ticks[i] = 0u;
+            m_slip_ticks[i] = 0u;
+        }
+
+        // The limit is lowered until the wheel stops spinning up and held while it slips
+        if (state==State::SLIP) {
+            if (slipping) {
+                m_limits[i] = std::max(m_limits[i]-LIMIT_STEP, LIMIT_MIN);
+            }
+        }
+        else {
+            m_limits[i] = std::min(m_limits[i]+LIMIT_RECOVER, 1.0f);
+        }
+
+        if (state!=m_states[i]) {
+            m_states[i] = state;
+            changed = true;
+        }
+    }
+    return changed;
+}
+
+
+
+std::ostream &operator<<(std::ostream &os, const Traction::State &state)
+{
+    switch (state) {
+        case Traction::State::GRIP:
+            return os << "GRIP";
+        case Traction::State::SLIP:
+            return os << "SLIP";
+        case Traction::State::STALL:
+            return os << "STALL";
+    }
+    return os;
+}
+
+}
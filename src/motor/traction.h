@@ -0,0 +1,78 @@
+#ifndef _ROBOT_MOTOR_TRACTION_H_
+#define _ROBOT_MOTOR_TRACTION_H_
+
+#include <array>
+#include <cstdint>
+#include <iostream>
+
+#include <robottypes.h>
+#include "types.h"
+
+namespace Robot::Motor {
+
+    /**
+     * Wheel slip and stall detection across all motors.
+     *
+     * Each tick the measured RPM of every wheel is divided by the RPM expected
+     * from its command. The command set comes from the active control scheme's
+     * kinematic mix, so on firm ground these ratios are the same for all driven
+     * wheels, give or take a common load factor. The lower median of the ratios
+     * is used as the reference for that load factor, so a single wheel spinning
+     * up does not shift it. A wheel running well above the reference is
+     * slipping, a wheel commanded to turn but barely moving is stalled.
+     *
+     * A slipping wheel gets its duty limit lowered every tick until it grips
+     * again, after which the limit recovers slowly.
+     */
+    class Traction {
+        public:
+            static constexpr float EXPECTED_MIN { 10.0f };  ///< RPM, wheels expected slower are not compared
+            static constexpr float SLIP_RATIO { 0.3f };     ///< Fraction above the reference counted as slip
+            static constexpr float SLIP_RPM { 15.0f };      ///< RPM above the reference counted as slip
+            static constexpr uint SLIP_TICKS { 3 };         ///< Ticks in a row before a slip is reported
+            static constexpr float STALL_RATIO { 0.2f };    ///< Fraction of the expected RPM counted as stalled
+            static constexpr uint STALL_TICKS { 25 };       ///< Ticks in a row before a stall is reported
+            static constexpr float LIMIT_MIN { 0.3f };      ///< Lowest duty limit on a slipping wheel
+            static constexpr float LIMIT_STEP { 0.1f };     ///< Limit decrease per tick while slipping
+            static constexpr float LIMIT_RECOVER { 0.02f }; ///< Limit increase per tick while gripping
+
+            enum class State : std::uint8_t {
+                GRIP,
+                SLIP,
+                STALL
+            };
+            using StateList = std::array<State, MOTOR_COUNT>;
+
+            Traction();
+
+            void reset();
+
+            /**
+             * @brief Evaluate one motor tick
+             *
+             * @param expected RPM expected from the command of each wheel, 0 for wheels not driven
+             * @param rpm Measured RPM of each wheel
+             * @return true if any wheel changed state
+             */
+            bool update(const MotorValues &expected, const MotorValues &rpm);
+
+            const StateList &states() const { return m_states; }
+            State state(std::size_t index) const { return m_states[index]; }
+            /// Factor the duty of the wheel is scaled with
+            float limit(std::size_t index) const { return m_limits[index]; }
+            /// Measured to expected RPM of the wheels with grip
+            float reference() const { return m_reference; }
+
+        private:
+            StateList m_states;
+            MotorValues m_limits;
+            std::array<uint, MOTOR_COUNT> m_slip_ticks;
+            std::array<uint, MOTOR_COUNT> m_stall_ticks;
+            float m_reference;
+    };
+
+    std::ostream &operator<<(std::ostream &os, const Traction::State &state);
+
+}
+
+#endif
@@ -0,0 +1,84 @@
+#ifndef _ROBOT_MOTOR_TRANSACTION_H_
+#define _ROBOT_MOTOR_TRANSACTION_H_
+
+#include <array>
+#include <cstddef>
+#include <algorithm>
+
+#include "types.h"
+
+namespace Robot::Motor {
+
+    /**
+     * Command set for all motors and servos.
+     *
+     * Values are staged here without touching the actuators and applied as a whole
+     * by Control::commit(). Motors and servos without a staged value keep their
+     * current command.
+     */
+    class Transaction {
+        public:
+            enum class Throttle {
+                KEEP,
+                DUTY,
+                RPM,
+            };
+
+            Transaction()
+            {
+                clear();
+            }
+
+            void clear()
+            {
+                m_throttle_mode.fill(Throttle::KEEP);
+                m_throttle.fill(0.0f);
+                m_servo_set.fill(false);
+            }
+
+            void setDuty(std::size_t index, float duty)
+            {
+                m_throttle_mode[index] = Throttle::DUTY;
+                m_throttle[index] = duty;
+            }
+            void setDuty(const MotorValues &duty)
+            {
+                m_throttle_mode.fill(Throttle::DUTY);
+                m_throttle = duty;
+            }
+
+            void setTargetRPM(std::size_t index, float rpm)
+            {
+                m_throttle_mode[index] = Throttle::RPM;
+                m_throttle[index] = rpm;
+            }
+            void setTargetRPM(const MotorValues &rpm)
+            {
+                m_throttle_mode.fill(Throttle::RPM);
+                m_throttle = rpm;
+            }
+
+            void setServo(std::size_t index, Value value)
+            {
+                m_servo_set[index] = true;
+                m_servo[index] = value;
+            }
+
+            bool empty() const
+            {
+                return std::all_of(m_throttle_mode.begin(), m_throttle_mode.end(), [](auto mode) { return mode==Throttle::KEEP; })
+                    && std::none_of(m_servo_set.begin(), m_servo_set.end(), [](auto set) { return set; });
+            }
+
+        private:
+            std::array<Throttle, MOTOR_COUNT> m_throttle_mode;
+            MotorValues m_throttle;
+            std::array<bool, MOTOR_COUNT> m_servo_set;
+            std::array<Value, MOTOR_COUNT> m_servo;
+
+            friend class Control;
+    };
+
+}
+
+#endif
@@ -15,10 +15,25 @@ namespace Robot::Motor {
     
     using MotorList = std::array<std::unique_ptr<Motor>, MOTOR_COUNT>;
     using ServoList = std::array<std::unique_ptr<Servo>, MOTOR_COUNT>;
+    using MotorValues = std::array<float, MOTOR_COUNT>;
 
     using clock_type = std::chrono::high_resolution_clock;
     inline constexpr auto MOTOR_TIMER_INTERVAL { std::chrono::milliseconds(20) };
     inline constexpr auto SERVO_TIMER_INTERVAL { std::chrono::milliseconds(20) };
+
+    // Motor output shaping, default RPM loop gains and RPM mode motion profile
+    inline constexpr auto MOTOR_DEADZONE { 0.05f };
+    inline constexpr auto MOTOR_DUTY_MIN_CHANGE { 0.02f };
+    inline constexpr auto MOTOR_PID_P { 0.0012f };
+    inline constexpr auto MOTOR_PID_I { 0.0004f };
+    inline constexpr auto MOTOR_PID_D { 0.0001f };
+    inline constexpr auto MOTOR_PID_EMA_ALPHA { 0.9f };
+    inline constexpr auto MOTOR_FF_KV { 0.0055f };       // Duty per RPM
+    inline constexpr auto MOTOR_FF_KS { 0.025f };        // Duty to overcome static friction
+    inline constexpr auto MOTOR_ACCEL_MAX { 600.0f };    // RPM/s
+    inline constexpr auto MOTOR_JERK_MAX { 6000.0f };    // RPM/s^2
+    inline constexpr auto MOTOR_AUTOTUNE_AMPLITUDE { 0.15f };
+    inline constexpr auto MOTOR_TRACTION_CONTROL { true };  // Limit the duty of slipping wheels
 }
 
 #endif
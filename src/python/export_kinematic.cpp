@@ -13,6 +13,18 @@ namespace py = boost::python;
 
 namespace Robot::Python {
 
+static void kinematic_set_path(Robot::Kinematic::Kinematic &kinematic, const py::object &waypoints, bool spline)
+{
+    std::vector<Robot::Kinematic::Point> points;
+    const auto len = py::len(waypoints);
+    points.reserve(len);
+    for (ssize_t i = 0; i < len; i++) {
+        const py::object point = waypoints[i];
+        points.push_back({ py::extract<float>(point[0]), py::extract<float>(point[1]) });
+    }
+    kinematic.setPath(points, spline);
+}
+
 void export_kinematic() 
 {
     using namespace Kinematic;
@@ -26,6 +38,7 @@ void export_kinematic()
         .value("SKID", DriveMode::SKID)
         .value("SPINNING", DriveMode::SPINNING)
         .value("BALANCING", DriveMode::BALANCING)
+        .value("PATH", DriveMode::PATH)
         ;
     py::enum_<Orientation>("Orientation")
         .value("NORTH", Orientation::NORTH)
@@ -33,12 +46,29 @@ void export_kinematic()
         .value("EAST", Orientation::EAST)
         .value("WEST", Orientation::WEST)
         ;
+    py::enum_<ThrottleMode>("ThrottleMode")
+        .value("DUTY", ThrottleMode::DUTY)
+        .value("RPM", ThrottleMode::RPM)
+        ;
+    py::enum_<ReplaySync>("ReplaySync")
+        .value("TIME", ReplaySync::TIME)
+        .value("DISTANCE", ReplaySync::DISTANCE)
+        ;
 
     py::class_<Kinematic, std::shared_ptr<Kinematic>, py::bases<WithNotifyInt, WithMutexStd>, boost::noncopyable>("Kinematic", py::no_init)
         .add_property("drive_mode", &Kinematic::getDriveMode, &Kinematic::setDriveMode)
         .add_property("orientation", &Kinematic::getOrientation, &Kinematic::setOrientation)
+        .add_property("throttle_mode", &Kinematic::getThrottleMode, &Kinematic::setThrottleMode)
         .add_property("odometer", &Kinematic::getOdometer)
         .def("reset_odometer", &Kinematic::resetOdometer)
+        .def("set_path", &kinematic_set_path, (py::arg("waypoints"), py::arg("spline")=false))
+        .def("clear_path", &Kinematic::clearPath)
+        .add_property("recording", &Kinematic::isRecording)
+        .def("start_recording", &Kinematic::startRecording)
+        .def("stop_recording", &Kinematic::stopRecording)
+        .add_property("replaying", &Kinematic::isReplaying)
+        .def("start_replay", &Kinematic::startReplay, (py::arg("filename"), py::arg("sync")=ReplaySync::TIME))
+        .def("stop_replay", &Kinematic::stopReplay)
         ;
 }
 
@@ -15,6 +15,7 @@
 #include <common/notifysubscription.h>
 #include <common/withmutex.h>
 #include <robotdebug.h>
+#include <metrics/trace.h>
 #include <config.h>
 
 namespace py = boost::python;
@@ -34,6 +35,10 @@ void export_misc()
     py::def("robot_version", +[]() { return Robot::Config::VERSION; });
     py::def("robot_version_full", +[]() { return Robot::Config::VERSION_FULL; });
 
+    py::def("trace_start", &Robot::Metrics::Trace::start);
+    py::def("trace_stop", &Robot::Metrics::Trace::stop);
+    py::def("trace_dump", &Robot::Metrics::Trace::dump);
+
     py::class_<WithNotifyInt, boost::noncopyable>("Subscribable", py::no_init)
         .add_static_property("NOTIFY_DEFAULT", py::make_getter(WithNotifyInt::NOTIFY_DEFAULT))
         .def("subscribe", +[](WithNotifyInt &self) { return notify_subscribe(self); })
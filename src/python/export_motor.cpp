@@ -28,6 +28,8 @@ void export_motor()
         .value("RPM", Motor::Mode::RPM)
         .value("FREE_SPIN", Motor::Mode::FREE_SPIN)
         .value("BRAKE", Motor::Mode::BRAKE)
+        .value("AUTOTUNE", Motor::Mode::AUTOTUNE)
+        .value("DIRECT", Motor::Mode::DIRECT)
         ;
 
     py::class_<Motor, py::bases<WithNotifyInt, WithMutexStd>, boost::noncopyable>("Motor", py::no_init)
@@ -37,6 +39,9 @@ void export_motor()
         .add_property("duty", &Motor::getDuty, &Motor::setDuty)
         .add_property("target_rpm", &Motor::getTargetRPM, &Motor::setTargetRPM)
         .add_property("rpm", &Motor::getRPM)
+        .add_property("expected_rpm", &Motor::getExpectedRPM)
+        .add_property("traction", +[](const Motor &self) { return (boost::format("%s") % self.getTraction()).str(); })
+        .add_property("traction_limit", &Motor::getTractionLimit)
         .add_property("mode", &Motor::getMode)
         .add_property("odometer", &Motor::getOdometer)
         .add_property("encoder", &Motor::getEncoderValue)
@@ -44,6 +49,22 @@ void export_motor()
         .def("brake", &Motor::brake)
         .def("free_spin", &Motor::freeSpin)
         .def("reset_odometer", &Motor::resetOdometer)
+        .def("start_autotune", &Motor::startAutotune, (py::arg("rpm"), py::arg("amplitude")=Robot::Motor::MOTOR_AUTOTUNE_AMPLITUDE))
+        .def("cancel_autotune", &Motor::cancelAutotune)
+        .add_property("autotune", +[](const Motor &self) {
+            auto status = self.getAutotune();
+            py::dict res;
+            res["state"] = (boost::format("%s") % status.state).str();
+            res["cycles"] = status.cycles;
+            res["bias"] = status.bias;
+            res["swing"] = status.swing;
+            res["ku"] = status.result.ku;
+            res["tu"] = status.result.tu;
+            res["pid_p"] = status.result.p;
+            res["pid_i"] = status.result.i;
+            res["pid_d"] = status.result.d;
+            return res;
+        })
         .def("__str__", +[](const Motor &m) { return (boost::format("<Motor (%d)>") % m.getIndex()).str(); })
         ;
 
@@ -72,6 +93,8 @@ void export_motor()
 
     py::class_<Control, py::bases<WithNotifyInt, WithMutexStd>, std::shared_ptr<Control>, boost::noncopyable>("MotorControl", py::no_init)
         .add_property("motors", py::make_function(&Control::getMotors, py::return_internal_reference<>() ))
+        .add_property("generation", &Control::getGeneration)
+        .add_property("traction_control", &Control::getTractionControl, &Control::setTractionControl)
         .def("__str__", +[](const Control &self) { return "<MotorControl>"; })
         ;
 
@@ -68,12 +68,24 @@ static py::tuple to_3d_array(std::int64_t timestamp, const T &history, const py:
 
 void export_telemetry() 
 {
-    using Robot::Telemetry::Telemetry, Robot::Telemetry::HistoryMotorDuty;
+    using Robot::Telemetry::Telemetry, Robot::Telemetry::HistoryMotorDuty, Robot::Telemetry::Activation;
 
+    py::class_<Activation, std::shared_ptr<Activation>, boost::noncopyable>("TelemetryActivation", py::no_init)
+        .add_property("name", py::make_function(&Activation::name, py::return_value_policy<py::copy_const_reference>()))
+        .def("release", &Activation::release)
+        .def("__enter__", +[](const py::object &self) { return self; })
+        .def("__exit__", +[](Activation &self, const py::object &exc_type, const py::object &exc_val, const py::object &exc_tb) {
+            self.release();
+        })
+        ;
   
     py::class_<Telemetry, std::shared_ptr<Telemetry>, py::bases<WithNotifyInt, WithMutexStd>, boost::noncopyable>("Telemetry", py::no_init)
         .add_static_property("NOTIFY_IMU", py::make_getter(Telemetry::NOTIFY_IMU))
         .add_static_property("NOTIFY_ODOMETER", py::make_getter(Telemetry::NOTIFY_ODOMETER))
+        .add_static_property("NOTIFY_SYSTEM", py::make_getter(Telemetry::NOTIFY_SYSTEM))
+        .add_static_property("NOTIFY_PERF", py::make_getter(Telemetry::NOTIFY_PERF))
+        .add_static_property("NOTIFY_AUTOTUNE", py::make_getter(Telemetry::NOTIFY_AUTOTUNE))
+        .add_static_property("NOTIFY_TRACTION", py::make_getter(Telemetry::NOTIFY_TRACTION))
         .add_property("imu", +[](Telemetry &self){ 
             Telemetry::guard(self.mutex());
             py::dict vals;
@@ -86,6 +98,32 @@ void export_telemetry()
             map2dict(vals, self.odometerValues());
             return vals; 
         })
+        .add_property("system", +[](Telemetry &self){ 
+            Telemetry::guard(self.mutex());
+            py::dict vals;
+            map2dict(vals, self.systemValues());
+            return vals; 
+        })
+        .add_property("perf", +[](Telemetry &self){ 
+            Telemetry::guard(self.mutex());
+            py::dict vals;
+            map2dict(vals, self.perfValues());
+            return vals; 
+        })
+        .add_property("autotune", +[](Telemetry &self){ 
+            Telemetry::guard(self.mutex());
+            py::dict vals;
+            map2dict(vals, self.autotuneValues());
+            return vals; 
+        })
+        .add_property("traction", +[](Telemetry &self){ 
+            Telemetry::guard(self.mutex());
+            py::dict vals;
+            map2dict(vals, self.tractionValues());
+            return vals; 
+        })
+        .def("acquire", &Telemetry::acquire)
+        .def("active", &Telemetry::active)
         .add_property("history_time_ms", &Telemetry::historyLastMS)
         .add_property("history_interval_ms", &Telemetry::historyIntervalMS)
         .add_property("history_imu", +[](const py::object &obj){ 
@@ -100,6 +138,10 @@ void export_telemetry()
             const std::shared_ptr<Telemetry> self = py::extract<const std::shared_ptr<Telemetry>>(obj);
             return to_3d_array(self->historyLastMS(), self->historyMotorRPM(), obj, np::dtype::get_builtin<float>());
         })
+        .add_property("history_system", +[](const py::object &obj){ 
+            const std::shared_ptr<Telemetry> self = py::extract<const std::shared_ptr<Telemetry>>(obj);
+            return to_3d_array(self->historyLastMS(), self->historySystem(), obj, np::dtype::get_builtin<float>());
+        })
         ;
 
 }
@@ -1,5 +1,6 @@
 #include "receiver.h"
 
+#include <array>
 #include <algorithm>
 #include <random>
 #include <boost/assert.hpp>
@@ -9,6 +10,8 @@
 #include <robotconfig.h>
 #include <robotcontext.h>
 #include <telemetry/telemetry.h>
+#include <metrics/trace.h>
+#include <metrics/probes.h>
 
 using namespace std::literals;
 
@@ -144,6 +147,8 @@ void Receiver::timer()
     uint32_t counter = m_fbus->counter;
     
     if (counter != m_last_counter) {
+        ROBOT_TRACE_SCOPE("rc.frame");
+        ROBOT_PROBE3(rc__frame, counter, m_fbus->n_channels, m_fbus->rssi);
         bool sig_flags = false;
         bool sig_rssi = false;
 
@@ -211,12 +216,15 @@ void Receiver::timer()
 #else
 void Receiver::timer() 
 {
+    ROBOT_TRACE_SCOPE("rc.frame");
     const guard lock(m_mutex);
 
     if (!m_initialized) {
         return;
     }
 
+    ROBOT_PROBE3(rc__frame, m_last_counter, m_channels.count(), m_rssi);
+
     bool sig_flags = false;
     bool sig_rssi = false;
 
@@ -297,16 +305,26 @@ void Receiver::timerSetup() {
 
 void Receiver::onTelemetryEvent(const Robot::Telemetry::Event &event) 
 {
-    if (const auto ev = dynamic_cast<const Robot::Telemetry::EventBattery*>(&event)) {
-        auto n_cells = ev->cell_voltage.size();
+    using Robot::Telemetry::EventBattery;
+    if (const auto ev = Robot::Telemetry::event_cast<EventBattery>(event)) {
+        // Pack two cells per frame and send all frames in a single handler
+        std::array<std::uint32_t, (EventBattery::CELLS_MAX+1)/2> frames;
+        uint32_t n_cells = ev->cell_count;
+        uint n_frames = 0u;
         for (size_t i=0; i<n_cells; i+=2) {
             uint32_t cv1 = ev->cell_voltage[i]*500;
             uint32_t cv2 = 0;
             if (i+1<n_cells) {
-                cv2 = ev->cell_voltage[i]*500;
+                cv2 = ev->cell_voltage[i+1]*500;
             }
-            uint32_t data = ((uint32_t) cv1 & 0x0fff) << 20 | ((uint32_t) cv2 & 0x0fff) << 8 | n_cells << 4 | ev->battery_id;
-            defer([this, i, data] { sendTelemetry(TELEMETRY_BATTERY + i/2, data); });
+            frames[n_frames++] = ((uint32_t) cv1 & 0x0fff) << 20 | ((uint32_t) cv2 & 0x0fff) << 8 | n_cells << 4 | ev->battery_id;
+        }
+        if (n_frames>0) {
+            defer([this, frames, n_frames] { 
+                for (auto i=0u; i<n_frames; i++) {
+                    sendTelemetry(TELEMETRY_BATTERY + i, frames[i]); 
+                }
+            });
         }
     }
 }
@@ -15,9 +15,13 @@
 #include <telemetry/sources/motors.h>
 #include <telemetry/sources/robotcontrolbattery.h>
 #include <telemetry/sources/robotcontrolmpu.h>
+#include <telemetry/sources/systemhealth.h>
+#include <telemetry/sources/perfcounters.h>
+#include <telemetry/sources/simulatedmpu.h>
 #include <kinematic/kinematic.h>
 #include <system/network.h>
 #include <system/power.h>
+#include <metrics/server.h>
 #include <hardware/beaglebone/prudebug.h>
 
 using namespace std::literals;
@@ -43,7 +47,8 @@ Robot::Robot() :
     m_kinematic { std::make_shared<Kinematic::Kinematic>(m_context) },
     m_input { std::make_shared<Input::Control>(m_context) },
     m_network { std::make_shared<System::Network>(m_context) },
-    m_power { std::make_shared<System::Power>(m_context) }
+    m_power { std::make_shared<System::Power>(m_context) },
+    m_metrics_server { std::make_shared<Metrics::Server>(m_context) }
 {
     //BOOST_LOG_TRIVIAL(trace) << __FUNCTION__;
 }
@@ -69,12 +74,17 @@ void Robot::init()
 
     // Wire up telemetry sources
     m_telemetry->addSource(std::make_shared<Telemetry::Motors>(m_motor_control));
+    m_telemetry->addSource(std::make_shared<Telemetry::SystemHealth>(m_context));
+    m_telemetry->addSource(std::make_shared<Telemetry::PerfCounters>(m_context));
     #if ROBOT_HAVE_ROBOTCONTROL_BATTERY
     m_telemetry->addSource(std::make_shared<Telemetry::RobotControlBattery>(m_context));
     #endif
     #if ROBOT_HAVE_ROBOTCONTROL_MPU
     m_telemetry->addSource(std::make_shared<Telemetry::RobotControlMPU>(m_context));
     #endif
+    #if ROBOT_PLATFORM == ROBOT_PLATFORM_PC
+    m_telemetry->addSource(std::make_shared<Telemetry::SimulatedMPU>(m_context));
+    #endif
 
 
     // Initialize all components
@@ -89,6 +99,7 @@ void Robot::init()
     m_kinematic->init(m_motor_control, m_led_control, m_telemetry, m_input);
     m_network->init();
     m_power->init(m_telemetry);
+    m_metrics_server->init();
     #if ROBOT_PLATFORM == ROBOT_PLATFORM_BEAGLEBONE
     m_pru_debug->init();
     #endif
@@ -111,6 +122,7 @@ void Robot::cleanup()
     #if ROBOT_PLATFORM == ROBOT_PLATFORM_BEAGLEBONE
     m_pru_debug->cleanup();
     #endif
+    m_metrics_server->cleanup();
     m_power->cleanup();
     m_network->cleanup();
     m_kinematic->cleanup();
@@ -37,6 +37,7 @@ namespace Robot {
             const std::shared_ptr<class Input::Control> &input() const { return m_input; }
             const std::shared_ptr<class System::Network> &network() const { return m_network; }
             const std::shared_ptr<class System::Power> &power() const { return m_power; }
+            const std::shared_ptr<class Metrics::Server> &metricsServer() const { return m_metrics_server; }
 
         private:
             static class Robot *m_instance;
@@ -57,6 +58,7 @@ namespace Robot {
             std::shared_ptr<class Input::Control> m_input;
             std::shared_ptr<class System::Network> m_network;
             std::shared_ptr<class System::Power> m_power;
+            std::shared_ptr<class Metrics::Server> m_metrics_server;
 
             friend std::ostream &operator<<(std::ostream &os, const Robot &self)
             {
@@ -2,6 +2,8 @@
 
 #include <iostream>
 #include <functional>
+#include <unistd.h>
+#include <sys/syscall.h>
 #include <boost/bind.hpp>
 #include <boost/log/trivial.hpp> 
 
@@ -10,6 +12,7 @@
 #include <hardware/proxypower.h>
 #include <hardware/beaglebone/servopower.h>
 #include <hardware/beaglebone/motorpower.h>
+#include <simulation/plant.h>
 
 
 using namespace std::literals;
@@ -22,7 +25,10 @@ static constexpr auto CONTEXT_THREAD_NICE { -20 };
 static constexpr auto TIMER_INTERVAL { 1s };
 
 static constexpr auto THREADS_MIN { 1u };
-static constexpr auto THREADS_MAX { 8u };
+
+#if ROBOT_PLATFORM == ROBOT_PLATFORM_PC
+static constexpr auto PLANT_TIMER_INTERVAL { 5ms };
+#endif
 
 
 Context::Context() : 
@@ -30,6 +36,9 @@ Context::Context() :
     m_started { false },
     m_timer { m_io },
     m_heartbeat { 0u },
+    #if ROBOT_PLATFORM == ROBOT_PLATFORM_PC
+    m_plant_timer { m_io },
+    #endif
     m_motor_power_enabled { false },
     m_servo_power_enabled { false },
     m_led_power_enabled { false },
@@ -151,10 +160,13 @@ void Context::initPlatform()
     m_motor_power = std::make_shared<Robot::Hardware::NoopPower>();
     m_led_power = std::make_shared<Robot::Hardware::NoopPower>();
     m_rc_power = std::make_shared<Robot::Hardware::NoopPower>();
+
+    m_plant = std::make_shared<Robot::Simulation::Plant>();
 }
 
 void Context::cleanupPlatform() 
 {
+    m_plant = nullptr;
     m_servo_power = nullptr;
     m_motor_power = nullptr;
     m_led_power = nullptr;
@@ -177,12 +189,28 @@ void Context::start()
     m_timer.expires_after(0s);
     timerSetup();
 
+    #if ROBOT_PLATFORM == ROBOT_PLATFORM_PC
+    if (m_plant) {
+        m_plant_last = std::chrono::steady_clock::now();
+        m_plant_timer.expires_after(0s);
+        plantTimerSetup();
+    }
+    #endif
+
     // Determine pool size
     uint n_threads = std::max<uint>(THREADS_MIN, std::min<uint>(THREADS_MAX, std::thread::hardware_concurrency()));
 
     BOOST_LOG_TRIVIAL(info) << "Starting thread pool (" << n_threads << ")";
+    {
+        const std::lock_guard<std::mutex> lock(m_thread_ids_mutex);
+        m_thread_ids.assign(n_threads, 0);
+    }
     for (auto i=0u; i<n_threads; i++) {
         m_thread_pool.push_back(std::make_unique<std::thread>([this,i] {
+            {
+                const std::lock_guard<std::mutex> lock(m_thread_ids_mutex);
+                m_thread_ids[i] = static_cast<pid_t>(syscall(SYS_gettid));
+            }
             auto val = nice(CONTEXT_THREAD_NICE);
             if (val != CONTEXT_THREAD_NICE) {
                 #if ROBOT_PLATFORM != ROBOT_PLATFORM_PC
@@ -206,6 +234,9 @@ void Context::stop()
         return;
     
     m_timer.cancel();
+    #if ROBOT_PLATFORM == ROBOT_PLATFORM_PC
+    m_plant_timer.cancel();
+    #endif
 
     BOOST_LOG_TRIVIAL(info) << "Stopping thread pool";
     m_io.stop();
@@ -214,12 +245,25 @@ void Context::stop()
         //BOOST_LOG_TRIVIAL(info) << "Thread stopped";
     }
     m_thread_pool.clear();
+    {
+        const std::lock_guard<std::mutex> lock(m_thread_ids_mutex);
+        m_thread_ids.clear();
+    }
     BOOST_LOG_TRIVIAL(info) << "Thread pool stopped";
 
     m_started = false;
 }
 
 
+std::vector<pid_t> Context::threadIds() const
+{
+    const std::lock_guard<std::mutex> lock(m_thread_ids_mutex);
+    std::vector<pid_t> res;
+    std::copy_if(m_thread_ids.begin(), m_thread_ids.end(), std::back_inserter(res), [](auto tid) { return tid!=0; });
+    return res;
+}
+
+
 void Context::setPowerEnabled(std::shared_ptr<::Robot::Hardware::AbstractPower> &power, power_signal_type &sig_power, bool enabled, bool &state, const char *name)
 {
     auto cnt = power->setEnabled(enabled);
@@ -282,7 +326,9 @@ void Context::timerSetup()
 {
     m_timer.expires_at(m_timer.expiry() + TIMER_INTERVAL);
     m_timer.async_wait([this](boost::system::error_code error) {
-        if (error!=boost::system::errc::success) {
+        // A tick already queued when the context was stopped must not re-arm
+        // the timer, or the cleanup drain runs until it times out
+        if (error!=boost::system::errc::success || !m_started) {
             return;
         }
         ++m_heartbeat;
@@ -291,5 +337,23 @@ void Context::timerSetup()
 }
 
 
+#if ROBOT_PLATFORM == ROBOT_PLATFORM_PC
+void Context::plantTimerSetup() 
+{
+    m_plant_timer.expires_at(m_plant_timer.expiry() + PLANT_TIMER_INTERVAL);
+    m_plant_timer.async_wait([this](boost::system::error_code error) {
+        if (error!=boost::system::errc::success || !m_plant) {
+            return;
+        }
+        // Advance by the elapsed wall time, the plant integrates it in fixed steps
+        auto now = std::chrono::steady_clock::now();
+        m_plant->advance(now-m_plant_last);
+        m_plant_last = now;
+        plantTimerSetup();
+    });
+}
+#endif
 
-}
\ No newline at end of file
+
+
+}
@@ -5,6 +5,7 @@
 #include <memory>
 #include <thread>
 #include <vector>
+#include <sys/types.h>
 #include <boost/asio.hpp>
 #include <boost/signals2.hpp>
 
@@ -14,12 +15,18 @@
 #include <common/properties.h>
 #include <hardware/types.h>
 
+namespace Robot::Simulation {
+    class Plant;
+}
+
 namespace Robot {
 
     class Context : public std::enable_shared_from_this<Context>, public WithMutexRecursive {
         public:
             using power_signal_type = boost::signals2::signal<void(bool)>;
 
+            static constexpr uint THREADS_MAX { 8u };
+
             Context();
             Context(const Context&) = delete; // No copy constructor
             Context(Context&&) = delete; // No move constructor
@@ -43,8 +50,24 @@ namespace Robot {
 
             uint heartbeat() const { return m_heartbeat; }
 
+            /**
+             * @brief Kernel thread ids of the running thread pool
+             * 
+             * @return std::vector<pid_t> List of thread ids, empty when the pool is stopped
+             */
+            std::vector<pid_t> threadIds() const;
+
             boost::asio::io_context &io() { return m_io; }
 
+            #if ROBOT_PLATFORM == ROBOT_PLATFORM_PC
+            /**
+             * @brief Physical model standing in for motors, servos and IMU
+             * 
+             * The plant is created by init() and stepped in real time while the context is started.
+             */
+            std::shared_ptr<::Robot::Simulation::Plant> plant() const { return m_plant; }
+            #endif
+
 
             const Properties &properties() const { return m_properties; }
             Properties &properties() { return m_properties; }
@@ -63,12 +86,22 @@ namespace Robot {
             bool m_started;
             boost::asio::io_context m_io;
             std::vector<std::unique_ptr<std::thread>> m_thread_pool;
+            mutable std::mutex m_thread_ids_mutex;
+            std::vector<pid_t> m_thread_ids;
             
             boost::asio::steady_timer m_timer;
             uint m_heartbeat;
 
             void timerSetup();
 
+            #if ROBOT_PLATFORM == ROBOT_PLATFORM_PC
+            std::shared_ptr<::Robot::Simulation::Plant> m_plant;
+            boost::asio::steady_timer m_plant_timer;
+            std::chrono::steady_clock::time_point m_plant_last;
+
+            void plantTimerSetup();
+            #endif
+
             Properties m_properties;
 
             bool m_motor_power_enabled;
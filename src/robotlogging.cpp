@@ -1,32 +1,256 @@
 #include "robotlogging.h"
 
 #include <mutex>
+#include <array>
+#include <thread>
+#include <vector>
+#include <memory>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <condition_variable>
 #include <boost/log/trivial.hpp>
 #include <boost/log/core.hpp>
 #include <boost/log/expressions.hpp>
-#include <boost/log/sinks/sync_frontend.hpp>
-#include <boost/log/sinks/text_ostream_backend.hpp>
+#include <boost/log/sinks/basic_sink_backend.hpp>
+#include <boost/log/sinks/unlocked_frontend.hpp>
 #include <boost/log/sources/logger.hpp>
 #include <boost/log/sources/record_ostream.hpp>
 #include <boost/log/support/date_time.hpp>
+#include <boost/log/utility/formatting_ostream.hpp>
 #include <boost/log/utility/setup/common_attributes.hpp>
-#include <boost/log/utility/setup/console.hpp>
+
+using namespace std::literals;
 
 namespace Robot::Logging {
 
+namespace logging = boost::log;
+namespace sinks = boost::log::sinks;
+
+static constexpr auto RING_SIZE { 256u }; // Entries per thread
+static constexpr auto ENTRY_SIZE { 256u }; // Max length of a formatted message
+static constexpr auto DRAIN_INTERVAL { 10ms };
+
+std::atomic<int> g_level { logging::trivial::trace };
+
+
+/**
+ * Single producer / single consumer ring of formatted messages owned by one thread.
+ */
+class Ring {
+    public:
+        Ring() : 
+            m_head { 0u },
+            m_tail { 0u },
+            orphaned { false }
+        {
+        }
+
+        bool push(const std::string &text)
+        {
+            auto head = m_head.load(std::memory_order_relaxed);
+            auto next = (head+1) % RING_SIZE;
+            if (next==m_tail.load(std::memory_order_acquire)) {
+                return false;
+            }
+            auto &entry = m_entries[head];
+            entry.length = std::min<std::size_t>(text.size(), sizeof(entry.text));
+            std::memcpy(entry.text, text.data(), entry.length);
+            if (entry.length==sizeof(entry.text)) {
+                entry.text[entry.length-1] = '\n'; // Truncated
+            }
+            m_head.store(next, std::memory_order_release);
+            return true;
+        }
+
+        bool empty() const
+        {
+            return m_head.load(std::memory_order_acquire)==m_tail.load(std::memory_order_relaxed);
+        }
+
+        void drain(std::string &out)
+        {
+            auto tail = m_tail.load(std::memory_order_relaxed);
+            auto head = m_head.load(std::memory_order_acquire);
+            while (tail!=head) {
+                const auto &entry = m_entries[tail];
+                out.append(entry.text, entry.length);
+                tail = (tail+1) % RING_SIZE;
+            }
+            m_tail.store(tail, std::memory_order_release);
+        }
+
+    private:
+        struct Entry {
+            std::uint16_t length;
+            char text[ENTRY_SIZE-sizeof(std::uint16_t)];
+        };
+
+        std::array<Entry, RING_SIZE> m_entries;
+        std::atomic<std::size_t> m_head;
+        std::atomic<std::size_t> m_tail;
+
+    public:
+        std::atomic<bool> orphaned; // Owning thread has exited
+};
+
+
+/**
+ * Background thread writing the thread rings to stderr in batches.
+ */
+class Writer {
+    public:
+        Writer() :
+            m_sleeping { false },
+            m_dropped { 0u },
+            m_thread { [this]{ run(); } }
+        {
+        }
+
+        std::shared_ptr<Ring> createRing()
+        {
+            auto ring = std::make_shared<Ring>();
+            const std::lock_guard<std::mutex> lock(m_rings_mutex);
+            m_rings.push_back(ring);
+            return ring;
+        }
+
+        void dropped() 
+        {
+            m_dropped.fetch_add(1u, std::memory_order_relaxed);
+        }
+
+        void wake()
+        {
+            if (m_sleeping.load(std::memory_order_relaxed)) {
+                m_cond.notify_one();
+            }
+        }
+
+        /**
+         * Write everything queued so far. Safe to call from any thread.
+         */
+        void drain()
+        {
+            const std::lock_guard<std::mutex> lock(m_drain_mutex);
+            m_batch.clear();
+            {
+                const std::lock_guard<std::mutex> lock(m_rings_mutex);
+                for (auto it = m_rings.begin(); it!=m_rings.end(); ) {
+                    auto &ring = *it;
+                    ring->drain(m_batch);
+                    if (ring->orphaned && ring->empty()) {
+                        it = m_rings.erase(it);
+                    }
+                    else {
+                        ++it;
+                    }
+                }
+            }
+            if (auto dropped = m_dropped.exchange(0u, std::memory_order_relaxed)) {
+                m_batch.append("[logging] ").append(std::to_string(dropped)).append(" messages dropped\n");
+            }
+            if (!m_batch.empty()) {
+                std::fwrite(m_batch.data(), 1, m_batch.size(), stderr);
+                std::fflush(stderr);
+            }
+        }
+
+    private:
+        std::atomic<bool> m_sleeping;
+        std::atomic<uint> m_dropped;
+        std::mutex m_wait_mutex;
+        std::condition_variable m_cond;
+        std::mutex m_rings_mutex;
+        std::vector<std::shared_ptr<Ring>> m_rings;
+        std::mutex m_drain_mutex;
+        std::string m_batch;
+        std::thread m_thread;
+
+        void run()
+        {
+            std::unique_lock<std::mutex> lock(m_wait_mutex);
+            for (;;) {
+                m_sleeping = true;
+                m_cond.wait_for(lock, DRAIN_INTERVAL);
+                m_sleeping = false;
+                lock.unlock();
+                drain();
+                lock.lock();
+            }
+        }
+};
+
+
+static Writer &writer()
+{
+    // Intentionally never destroyed, so records logged during static destruction 
+    // still have somewhere to go. Remaining messages are written by the atexit hook.
+    static Writer *instance = new Writer;
+    return *instance;
+}
+
+
+class ThreadRing {
+    public:
+        ThreadRing() : m_ring { writer().createRing() } {}
+        ~ThreadRing() { m_ring->orphaned = true; }
+        Ring &operator*() { return *m_ring; }
+    private:
+        std::shared_ptr<Ring> m_ring;
+};
+
+
+/**
+ * Formats on the logging thread and hands the text to the thread ring,
+ * the unlocked frontend calls consume concurrently without a sink lock.
+ */
+class RingBackend : public sinks::basic_sink_backend<sinks::concurrent_feeding> {
+    public:
+        explicit RingBackend(const logging::formatter &formatter) :
+            m_formatter { formatter }
+        {
+        }
+
+        void consume(const logging::record_view &rec)
+        {
+            thread_local std::string buffer;
+            thread_local logging::formatting_ostream stream { buffer };
+            thread_local ThreadRing ring;
+
+            buffer.clear();
+            m_formatter(rec, stream);
+            stream.flush();
+            buffer.push_back('\n');
+
+            auto &w = writer();
+            if (!(*ring).push(buffer)) {
+                w.dropped();
+                w.wake();
+                return;
+            }
+            auto severity = rec[logging::trivial::severity];
+            if (severity && *severity>=logging::trivial::warning) {
+                w.wake();
+            }
+        }
+
+    private:
+        logging::formatter m_formatter;
+};
+
+
 
 static std::once_flag logging_flag;
 
-void initLogging(boost::log::trivial::severity_level level)
+void initLogging(logging::trivial::severity_level level)
 {
     std::call_once(logging_flag, [level]() {
-        namespace logging = boost::log;
         namespace keywords = boost::log::keywords;
         namespace expr = boost::log::expressions;
     
         logging::add_common_attributes();
 
-        auto sink = logging::add_console_log();
         auto formatter =
                 expr::stream
                 << "["
@@ -38,13 +262,13 @@ void initLogging(boost::log::trivial::severity_level level)
                 << "]  "
                 << expr::message;
 
-        sink->set_formatter(formatter);
-        sink->locked_backend()->auto_flush(true);
+        writer();
+        std::atexit([]{ writer().drain(); });
 
-        logging::core::get()->set_filter(
-            logging::trivial::severity >= level
-        );
+        auto sink = boost::make_shared<sinks::unlocked_sink<RingBackend>>(boost::make_shared<RingBackend>(formatter));
+        logging::core::get()->add_sink(sink);
 
+        setLevel(level);
 
         BOOST_LOG_TRIVIAL(info) << "Logging initialized";
     });
@@ -56,4 +280,19 @@ void skipLogging()
 }
 
 
-}
\ No newline at end of file
+void setLevel(logging::trivial::severity_level level)
+{
+    g_level = level;
+    logging::core::get()->set_filter(
+        logging::trivial::severity >= level
+    );
+}
+
+
+void flush()
+{
+    writer().drain();
+}
+
+
+}
@@ -35,6 +35,9 @@ namespace Robot {
         class Network;
         class Power;
     };
+    namespace Metrics {
+        class Server;
+    };
 
     namespace Hardware {
         #if ROBOT_PLATFORM == ROBOT_PLATFORM_BEAGLEBONE
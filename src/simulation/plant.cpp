@@ -0,0 +1,342 @@
+#include "plant.h"
+
+#include <cmath>
+#include <algorithm>
+
+using namespace Robot::Config;
+
+namespace Robot::Simulation {
+
+static constexpr auto GRAVITY { 9.81 };
+static constexpr auto TWO_PI { 2.0*M_PI };
+
+static constexpr auto WHEEL_RPM_MAX { static_cast<double>(WHEEL_NO_LOAD_RPM) };
+
+static constexpr auto VELOCITY_EPSILON { 1e-9 };
+static constexpr auto SLIP_EPSILON { 1e-4 };    // m/s difference treated as rolling
+
+// Right hand side motors are mounted mirrored, positive duty drives them backwards
+static constexpr std::array<double, Motor::MOTOR_COUNT> MOUNT_DIRECTION { 1.0, -1.0, 1.0, -1.0 };
+static constexpr auto FRONT_LEFT { 0u };
+static constexpr auto FRONT_RIGHT { 1u };
+static constexpr auto REAR_LEFT { 2u };
+static constexpr auto REAR_RIGHT { 3u };
+
+
+Plant::Parameters Plant::Parameters::defaults()
+{
+    Parameters p;
+    p.supply_voltage = 7.4;
+    p.resistance = 2.5;
+    // Back-EMF balances the supply at the no load speed
+    p.torque_constant = p.supply_voltage / (WHEEL_RPM_MAX*WHEEL_GEARING*TWO_PI/60.0);
+    p.rotor_inertia = 2.0e-7;
+    p.viscous_friction = 1.0e-7;
+    p.coulomb_friction = 2.0e-4;
+    p.gear_efficiency = 0.8;
+    p.wheel_inertia = 6.0e-5;
+    p.wheel_radius = WHEEL_DIAMETER_MM/2000.0;
+    p.mass = 1.5;
+    p.traction = 0.8;
+    p.rolling_resistance = 0.02;
+    p.servo_slew_rate = 8.7;
+    p.body_mass = BODY_MASS;
+    p.body_height = BODY_HEIGHT_MM/1000.0;
+    p.body_inertia = BODY_INERTIA;
+    return p;
+}
+
+
+/**
+ * Explicit Euler step of a body with Coulomb friction.
+ *
+ * The body sticks when the applied force can not overcome the friction, and
+ * friction alone never reverses the direction of motion.
+ */
+static double integrate(double velocity, double force, double friction, double inertia, double dt)
+{
+    if (std::abs(velocity)<VELOCITY_EPSILON && std::abs(force)<=friction) {
+        return 0.0;
+    }
+    auto direction = std::abs(velocity)>=VELOCITY_EPSILON ? std::copysign(1.0, velocity) : std::copysign(1.0, force);
+    auto next = velocity + (force - direction*friction) / inertia * dt;
+    if (next*velocity<0.0 && std::abs(force)<=friction) {
+        return 0.0;
+    }
+    return next;
+}
+
+
+
+Plant::Plant(const Parameters &parameters) :
+    m_parameters { parameters }
+{
+    reset();
+}
+
+
+void Plant::reset()
+{
+    const guard lock(m_mutex);
+    m_time = duration_type::zero();
+    m_pending = duration_type::zero();
+    for (auto &wheel : m_wheels) {
+        wheel = Wheel { Drive::FREE_SPIN, 0.0, 0.0, m_parameters.traction, 0.0, 0.0, 0.0, 0.0 };
+    }
+    for (auto &servo : m_servos) {
+        servo = Servo { 0.0, 0.0 };
+    }
+    m_pendulum = false;
+    m_pitch = 0.0;
+    m_pitch_rate = 0.0;
+    m_yaw = 0.0;
+}
+
+
+void Plant::advance(duration_type time)
+{
+    const guard lock(m_mutex);
+    m_pending += time;
+    while (m_pending>=STEP) {
+        step(STEP.count());
+        m_pending -= STEP;
+        m_time += STEP;
+    }
+}
+
+
+void Plant::motorSet(uint index, float duty)
+{
+    const guard lock(m_mutex);
+    auto &wheel = m_wheels.at(index);
+    wheel.drive = Drive::DUTY;
+    wheel.voltage = std::clamp(static_cast<double>(duty), -1.0, 1.0) * m_parameters.supply_voltage;
+}
+
+
+void Plant::motorBrake(uint index)
+{
+    const guard lock(m_mutex);
+    m_wheels.at(index).drive = Drive::BRAKE;
+}
+
+
+void Plant::motorFreeSpin(uint index)
+{
+    const guard lock(m_mutex);
+    m_wheels.at(index).drive = Drive::FREE_SPIN;
+}
+
+
+void Plant::servoSendPulse(uint index, std::uint32_t pulse_us)
+{
+    const guard lock(m_mutex);
+    auto pulse = std::clamp(pulse_us, SERVO_LIMIT_MIN, SERVO_LIMIT_MAX);
+    m_servos.at(index).target = M_PI * (static_cast<double>(pulse)-SERVO_CENTER) / SERVO_RANGE;
+}
+
+
+void Plant::setLoad(uint index, float torque)
+{
+    const guard lock(m_mutex);
+    m_wheels.at(index).load = std::abs(torque);
+}
+
+
+void Plant::setTraction(uint index, float traction)
+{
+    const guard lock(m_mutex);
+    m_wheels.at(index).traction = std::max(traction, 0.0f);
+}
+
+
+void Plant::push(float pitch_rate)
+{
+    const guard lock(m_mutex);
+    if (m_pendulum) {
+        m_pitch_rate += pitch_rate;
+    }
+}
+
+
+std::int32_t Plant::encoder(uint index) const
+{
+    const guard lock(m_mutex);
+    return static_cast<std::int32_t>(std::lround(m_wheels.at(index).angle / TWO_PI * WHEEL_ENCODER_CPR * WHEEL_GEARING));
+}
+
+
+float Plant::wheelRPM(uint index) const
+{
+    const guard lock(m_mutex);
+    return m_wheels.at(index).omega * 60.0 / TWO_PI;
+}
+
+
+float Plant::servoAngle(uint index) const
+{
+    const guard lock(m_mutex);
+    return m_servos.at(index).angle;
+}
+
+
+float Plant::groundSpeed(uint index) const
+{
+    const guard lock(m_mutex);
+    return m_wheels.at(index).speed;
+}
+
+
+Plant::IMU Plant::imu() const
+{
+    const guard lock(m_mutex);
+    // Pitch decreases when the body leans forward
+    return IMU {
+        static_cast<float>(m_pendulum ? M_PI_2-m_pitch : 0.0),
+        0.0f,
+        static_cast<float>(m_yaw),
+        static_cast<float>(-m_pitch_rate)
+    };
+}
+
+
+void Plant::setPendulum(bool enabled, float pitch)
+{
+    const guard lock(m_mutex);
+    m_pendulum = enabled;
+    m_pitch = enabled ? pitch : 0.0;
+    m_pitch_rate = 0.0;
+    for (auto index : { FRONT_LEFT, FRONT_RIGHT }) {
+        m_wheels[index].speed = 0.0;
+        m_wheels[index].acceleration = 0.0;
+    }
+}
+
+
+
+void Plant::step(double dt)
+{
+    for (auto &wheel : m_wheels) {
+        stepWheel(wheel, dt);
+    }
+    for (auto &servo : m_servos) {
+        stepServo(servo, dt);
+    }
+    stepBody(dt);
+}
+
+
+void Plant::stepWheel(Wheel &wheel, double dt)
+{
+    const auto &p = m_parameters;
+    const auto index = static_cast<uint>(&wheel - m_wheels.data());
+    const auto gearing = static_cast<double>(WHEEL_GEARING);
+    const auto r = p.wheel_radius;
+
+    // Front wheels are off the ground when balancing on the rear axle
+    const auto airborne = m_pendulum && (index==FRONT_LEFT || index==FRONT_RIGHT);
+    const auto mass = airborne ? 0.0 : (m_pendulum ? p.mass/2.0 : p.mass/4.0);
+    const auto normal = mass * GRAVITY;
+
+    // Motor torque, the electrical time constant is far below the step size and is ignored
+    const auto motor_omega = wheel.omega * gearing;
+    double current = 0.0;
+    switch (wheel.drive) {
+        case Drive::DUTY:
+            current = (wheel.voltage - p.torque_constant*motor_omega) / p.resistance;
+            break;
+        case Drive::BRAKE:
+            current = -p.torque_constant*motor_omega / p.resistance;
+            break;
+        case Drive::FREE_SPIN:
+            current = 0.0;
+            break;
+    }
+    const auto torque = gearing * (p.gear_efficiency*p.torque_constant*current - p.viscous_friction*motor_omega);
+    const auto friction = gearing * p.coulomb_friction + wheel.load;
+    const auto inertia = p.wheel_inertia + gearing*gearing*p.rotor_inertia;
+
+    const auto omega = wheel.omega;
+    const auto speed = wheel.speed;
+
+    if (mass<=0.0) {
+        wheel.omega = integrate(omega, torque, friction, inertia, dt);
+        wheel.speed = 0.0;
+        wheel.acceleration = 0.0;
+    }
+    else {
+        const auto rolling = normal * p.rolling_resistance;
+        const auto traction = normal * wheel.traction;
+        bool slipping = std::abs(omega*r - speed) > SLIP_EPSILON;
+
+        if (!slipping) {
+            // Wheel and chassis share move together, check that the ground can transfer the force
+            auto next = integrate(omega, torque, friction + rolling*r, inertia + mass*r*r, dt);
+            auto force = mass * (next*r - speed) / dt;
+            if (std::abs(force)<=traction) {
+                wheel.omega = next;
+                wheel.speed = next*r;
+            }
+            else {
+                slipping = true;
+            }
+        }
+        if (slipping) {
+            auto slip = omega*r - speed;
+            auto direction = std::abs(slip)>SLIP_EPSILON ? std::copysign(1.0, slip) : std::copysign(1.0, torque);
+            auto force = direction * traction;
+            wheel.omega = integrate(omega, torque - force*r, friction, inertia, dt);
+            wheel.speed = integrate(speed, force, rolling, mass, dt);
+            // Grip is regained when the slip changes direction
+            if ((wheel.omega*r - wheel.speed)*slip < 0.0) {
+                auto momentum = inertia/(r*r) * wheel.omega*r + mass*wheel.speed;
+                auto common = momentum / (inertia/(r*r) + mass);
+                wheel.omega = common/r;
+                wheel.speed = common;
+            }
+        }
+        wheel.acceleration = (wheel.speed - speed) / dt;
+    }
+
+    wheel.angle += wheel.omega * dt;
+}
+
+
+void Plant::stepServo(Servo &servo, double dt)
+{
+    const auto max_step = m_parameters.servo_slew_rate * dt;
+    servo.angle += std::clamp(servo.target-servo.angle, -max_step, max_step);
+}
+
+
+void Plant::stepBody(double dt)
+{
+    const auto &p = m_parameters;
+
+    auto forward = [this](uint index) {
+        return MOUNT_DIRECTION[index] * m_wheels[index].speed;
+    };
+    const auto left = (forward(FRONT_LEFT) + forward(REAR_LEFT)) / (m_pendulum ? 1.0 : 2.0);
+    const auto right = (forward(FRONT_RIGHT) + forward(REAR_RIGHT)) / (m_pendulum ? 1.0 : 2.0);
+    m_yaw = std::remainder(m_yaw + (right-left) / (WHEEL_BASE_MM/1000.0) * dt, TWO_PI);
+
+    if (!m_pendulum) {
+        return;
+    }
+
+    // Inverted pendulum on the rear axle, driven by the axle acceleration
+    const auto acceleration = (MOUNT_DIRECTION[REAR_LEFT]*m_wheels[REAR_LEFT].acceleration + MOUNT_DIRECTION[REAR_RIGHT]*m_wheels[REAR_RIGHT].acceleration) / 2.0;
+    const auto ml = p.body_mass * p.body_height;
+    const auto alpha = ml * (GRAVITY*std::sin(m_pitch) - acceleration*std::cos(m_pitch)) / (p.body_inertia + ml*p.body_height);
+    m_pitch_rate += alpha * dt;
+    m_pitch += m_pitch_rate * dt;
+
+    // Lying on the ground
+    if (std::abs(m_pitch)>=M_PI_2) {
+        m_pitch = std::copysign(M_PI_2, m_pitch);
+        m_pitch_rate = 0.0;
+    }
+}
+
+
+}
@@ -0,0 +1,148 @@
+#ifndef _ROBOT_SIMULATION_PLANT_H_
+#define _ROBOT_SIMULATION_PLANT_H_
+
+#include <array>
+#include <mutex>
+#include <chrono>
+#include <cstdint>
+
+#include <robotconfig.h>
+#include <common/withmutex.h>
+#include <motor/types.h>
+
+namespace Robot::Simulation {
+
+    /**
+     * Physical model of the rover used in place of the hardware on the PC platform.
+     *
+     * Each wheel is a DC motor with gearbox driving a wheel with traction limited
+     * ground contact, each steering servo slews towards the commanded pulse and the
+     * body can be modelled as an inverted pendulum on the rear axle for the
+     * balancing scheme. The model is integrated with a fixed time step, independent
+     * of wall clock time, so it can be run much faster than real time.
+     */
+    class Plant : public WithMutexStd {
+        public:
+            using duration_type = std::chrono::duration<double>;
+
+            static constexpr duration_type STEP { std::chrono::milliseconds(1) };
+
+            struct Parameters {
+                // DC motor
+                double supply_voltage;      // V
+                double resistance;          // Ohm
+                double torque_constant;     // Nm/A (equal to the back-EMF constant in V*s/rad)
+                double rotor_inertia;       // kg*m^2 at the motor shaft
+                double viscous_friction;    // Nm*s/rad at the motor shaft
+                double coulomb_friction;    // Nm at the motor shaft
+                // Gearbox and wheel
+                double gear_efficiency;
+                double wheel_inertia;       // kg*m^2
+                double wheel_radius;        // m
+                // Ground contact
+                double mass;                // kg, total chassis mass
+                double traction;            // Friction coefficient between wheel and ground
+                double rolling_resistance;  // Coefficient of rolling resistance
+                // Steering servo
+                double servo_slew_rate;     // rad/s
+                // Pendulum body
+                double body_mass;           // kg
+                double body_height;         // m, axle to center of mass
+                double body_inertia;        // kg*m^2 around the center of mass
+
+                static Parameters defaults();
+            };
+
+            enum class Drive {
+                DUTY,
+                BRAKE,
+                FREE_SPIN
+            };
+
+            struct IMU {
+                float pitch;    // rad, PI/2 when standing upright on the rear wheels and 0 when lying on the front
+                float roll;     // rad
+                float yaw;      // rad
+                float gyro_pitch; // rad/s
+            };
+
+            explicit Plant(const Parameters &parameters = Parameters::defaults());
+            Plant(const Plant&) = delete; // No copy constructor
+            Plant(Plant&&) = delete; // No move constructor
+
+            void reset();
+
+            /**
+             * @brief Integrate the model
+             *
+             * Time is accumulated and integrated in whole STEP increments, remainders
+             * are carried to the next call.
+             */
+            void advance(duration_type time);
+
+            // Actuators, mirror the robotcontrol motor and servo calls
+            void motorSet(uint index, float duty);
+            void motorBrake(uint index);
+            void motorFreeSpin(uint index);
+            void servoSendPulse(uint index, std::uint32_t pulse_us);
+
+            // Disturbances
+            void setLoad(uint index, float torque);  ///< External torque (Nm) opposing the wheel rotation
+            void setTraction(uint index, float traction); ///< Friction coefficient of the ground under the wheel
+            void push(float pitch_rate);             ///< Add angular velocity (rad/s) to the pendulum body
+
+            // Sensors
+            std::int32_t encoder(uint index) const;
+            float wheelRPM(uint index) const;
+            float servoAngle(uint index) const;
+            float groundSpeed(uint index) const;
+            IMU imu() const;
+
+            /**
+             * @brief Release the front of the chassis so the body balances on the rear axle
+             *
+             * @param pitch Initial lean from upright, positive leaning forward
+             */
+            void setPendulum(bool enabled, float pitch = 0.0f);
+            bool pendulum() const { return m_pendulum; }
+
+            duration_type time() const { return m_time; }
+            const Parameters &parameters() const { return m_parameters; }
+
+        private:
+            struct Wheel {
+                Drive drive;
+                double voltage;         // Commanded terminal voltage
+                double load;            // Nm of external load at the wheel
+                double traction;        // Friction coefficient between wheel and ground
+                double omega;           // rad/s of the wheel
+                double angle;           // rad of the wheel
+                double speed;           // m/s of the chassis share riding on this wheel
+                double acceleration;    // m/s^2 of the chassis share in the last step
+            };
+            struct Servo {
+                double target;          // rad
+                double angle;           // rad
+            };
+
+            const Parameters m_parameters;
+            duration_type m_time;
+            duration_type m_pending;
+
+            std::array<Wheel, Motor::MOTOR_COUNT> m_wheels;
+            std::array<Servo, Motor::MOTOR_COUNT> m_servos;
+
+            bool m_pendulum;
+            double m_pitch;         // rad from upright, positive leaning forward
+            double m_pitch_rate;    // rad/s
+            double m_yaw;           // rad
+
+            void step(double dt);
+            void stepWheel(Wheel &wheel, double dt);
+            void stepServo(Servo &servo, double dt);
+            void stepBody(double dt);
+    };
+
+}
+
+#endif
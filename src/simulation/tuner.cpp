@@ -0,0 +1,406 @@
+#include "tuner.h"
+
+#include <cmath>
+#include <array>
+#include <atomic>
+#include <thread>
+#include <random>
+#include <algorithm>
+
+#include <robotcontext.h>
+#include <math/pid.h>
+#include <math/motionprofile.h>
+#include <motor/types.h>
+
+using namespace std::literals;
+using namespace Robot::Config;
+
+namespace Robot::Simulation {
+
+// Both controllers read their gains with these keys
+static const std::string PROPERTY_PID_P { "pid_p" };
+static const std::string PROPERTY_PID_I { "pid_i" };
+static const std::string PROPERTY_PID_D { "pid_d" };
+static const std::string MOTOR_PROPERTY_GROUP { "motor" };
+static const std::string BALANCING_PROPERTY_GROUP { "balancing" };
+
+static constexpr auto SETTLING_BAND { 0.05f };
+static constexpr auto UNSTABLE_COST { 1000.0f };
+
+// Motor episode, rear left wheel on the ground
+static constexpr auto MOTOR_INDEX { 2u };
+static constexpr auto MOTOR_TARGET_RPM { 100.0f };
+static constexpr auto MOTOR_EPISODE { 3s };
+static constexpr auto MOTOR_DISTURBANCE_AT { 1500ms };
+static constexpr auto MOTOR_LOAD_TORQUE { 0.1f };
+
+// Balancing episode, mirrors ControlSchemeBalancing
+static constexpr auto REAR_LEFT { 2u };
+static constexpr auto REAR_RIGHT { 3u };
+static constexpr Math::PID::sample_time_type BALANCE_INTERVAL { 10ms };
+static constexpr auto BALANCE_P { 1.0f };
+static constexpr auto BALANCE_I { 10.0f };
+static constexpr auto BALANCE_D { 0.0f };
+static constexpr auto BALANCE_INITIAL_LEAN { 0.1f };
+static constexpr auto BALANCE_FALL_ANGLE { 0.5f };
+static constexpr auto BALANCE_EPISODE { 5s };
+static constexpr auto BALANCE_DISTURBANCE_AT { 2500ms };
+static constexpr auto BALANCE_PUSH { 0.5f };
+
+
+
+/**
+ * The output path of Motor::update, run on the simulated motor tick
+ */
+class MotorLoop {
+    public:
+        MotorLoop(Plant &plant, uint index) :
+            m_plant { plant },
+            m_index { index },
+            m_last_enc_value { plant.encoder(index) },
+            m_rpm { 0.0f },
+            m_duty_set { 0.0f }
+        {
+        }
+
+        float measure()
+        {
+            constexpr auto interval = std::chrono::duration<float>(Motor::MOTOR_TIMER_INTERVAL).count();
+            auto value = m_plant.encoder(m_index);
+            auto rpm = (value-m_last_enc_value) * 60.0f / (WHEEL_ENCODER_CPR*WHEEL_GEARING*interval);
+            m_last_enc_value = value;
+            m_rpm = (rpm+m_rpm)/2.0f;
+            return m_rpm;
+        }
+
+        void write(float duty)
+        {
+            if (std::abs(duty-m_duty_set)>Motor::MOTOR_DUTY_MIN_CHANGE) {
+                m_plant.motorSet(m_index, std::abs(duty)<Motor::MOTOR_DEADZONE ? 0.0f : duty);
+                m_duty_set = duty;
+            }
+        }
+
+    private:
+        Plant &m_plant;
+        const uint m_index;
+        std::int32_t m_last_enc_value;
+        float m_rpm;
+        float m_duty_set;
+};
+
+
+/**
+ * Accumulates a response normalized so the step goes from 0 to 1
+ */
+class Response {
+    public:
+        explicit Response(float disturbance_at) :
+            m_disturbance_at { disturbance_at },
+            m_score { true, 0.0f, 0.0f, 0.0f, 0.0f },
+            m_rise_start { -1.0f },
+            m_rise_end { -1.0f },
+            m_peak { 0.0f },
+            m_last_outside { 0.0f },
+            m_last { 0.0f }
+        {
+        }
+
+        void sample(float time, float value, float dt)
+        {
+            if (!std::isfinite(value)) {
+                m_score.stable = false;
+                return;
+            }
+            if (time<m_disturbance_at) {
+                if (m_rise_start<0.0f && value>=0.1f) {
+                    m_rise_start = time;
+                }
+                if (m_rise_end<0.0f && value>=0.9f) {
+                    m_rise_end = time;
+                }
+                m_peak = std::max(m_peak, value);
+                if (std::abs(value-1.0f)>SETTLING_BAND) {
+                    m_last_outside = time+dt;
+                }
+            }
+            else {
+                m_score.disturbance += std::abs(1.0f-value) * dt;
+            }
+            m_last = value;
+        }
+
+        void fail() { m_score.stable = false; }
+
+        Score score() const
+        {
+            auto score = m_score;
+            score.rise_time = (m_rise_start>=0.0f && m_rise_end>=0.0f) ? m_rise_end-m_rise_start : m_disturbance_at;
+            score.overshoot = std::max(0.0f, m_peak-1.0f);
+            score.settling_time = m_last_outside;
+            if (std::abs(m_last-1.0f)>4.0f*SETTLING_BAND) {
+                score.stable = false;
+            }
+            return score;
+        }
+
+    private:
+        const float m_disturbance_at;
+        Score m_score;
+        float m_rise_start;
+        float m_rise_end;
+        float m_peak;
+        float m_last_outside;
+        float m_last;
+};
+
+
+
+float Score::cost() const
+{
+    if (!stable) {
+        return UNSTABLE_COST + settling_time;
+    }
+    return rise_time + settling_time + 2.0f*overshoot + disturbance;
+}
+
+
+
+Tuner::Tuner(Loop loop, const Plant::Parameters &parameters) :
+    m_loop { loop },
+    m_parameters { parameters },
+    m_threads { std::max(1u, std::thread::hardware_concurrency()) },
+    m_grid { 6u },
+    m_rounds { 8u },
+    m_candidates { 32u }
+{
+    switch (m_loop) {
+        case Loop::MOTOR:
+            m_ranges = {{ { 1.0e-4f, 1.0e-1f }, { 0.0f, 5.0e-1f }, { 0.0f, 1.0e-3f } }};
+            break;
+        case Loop::BALANCING:
+            m_ranges = {{ { 0.5f, 100.0f }, { 0.0f, 100.0f }, { 0.0f, 2.0f } }};
+            break;
+    }
+}
+
+
+Gains Tuner::defaults(Loop loop)
+{
+    switch (loop) {
+        case Loop::MOTOR:
+            return Gains { Motor::MOTOR_PID_P, Motor::MOTOR_PID_I, Motor::MOTOR_PID_D };
+        case Loop::BALANCING:
+            return Gains { BALANCE_P, BALANCE_I, BALANCE_D };
+    }
+    return Gains { 0.0f, 0.0f, 0.0f };
+}
+
+
+const std::string &Tuner::propertyGroup(Loop loop)
+{
+    return loop==Loop::MOTOR ? MOTOR_PROPERTY_GROUP : BALANCING_PROPERTY_GROUP;
+}
+
+
+void Tuner::store(Context &context, const Gains &gains) const
+{
+    const Context::guard lock(context.mutex());
+    auto &values = context.properties()[propertyGroup(m_loop)];
+    values.put(PROPERTY_PID_P, gains.p);
+    values.put(PROPERTY_PID_I, gains.i);
+    values.put(PROPERTY_PID_D, gains.d);
+}
+
+
+
+Score Tuner::evaluate(const Gains &gains) const
+{
+    switch (m_loop) {
+        case Loop::MOTOR:
+            return motorEpisode(gains);
+        case Loop::BALANCING:
+            return balancingEpisode(gains);
+    }
+    return Score { false, 0.0f, 0.0f, 0.0f, 0.0f };
+}
+
+
+std::vector<Score> Tuner::evaluate(const std::vector<Gains> &gains) const
+{
+    std::vector<Score> scores(gains.size());
+    std::atomic<std::size_t> next { 0u };
+    auto worker = [&] {
+        for (auto n=next++; n<gains.size(); n=next++) {
+            scores[n] = evaluate(gains[n]);
+        }
+    };
+
+    std::vector<std::thread> threads;
+    auto count = std::min<std::size_t>(m_threads, gains.size());
+    for (auto n=1u; n<count; n++) {
+        threads.emplace_back(worker);
+    }
+    worker();
+    for (auto &thread : threads) {
+        thread.join();
+    }
+    return scores;
+}
+
+
+Tuner::Result Tuner::run() const
+{
+    Result result { defaults(m_loop), evaluate(defaults(m_loop)), 1u };
+
+    auto consider = [&result](const std::vector<Gains> &candidates, const std::vector<Score> &scores) {
+        for (auto n=0u; n<candidates.size(); n++) {
+            if (scores[n].cost()<result.score.cost()) {
+                result.gains = candidates[n];
+                result.score = scores[n];
+            }
+        }
+        result.episodes += candidates.size();
+    };
+
+    // Coarse grid, a zero lower bound gets zero plus a log spaced range below the maximum
+    std::array<std::vector<float>, 3> axes;
+    for (auto k=0u; k<axes.size(); k++) {
+        const auto &range = m_ranges[k];
+        auto points = m_grid;
+        auto min = range.min;
+        if (min<=0.0f) {
+            axes[k].push_back(0.0f);
+            points--;
+            min = range.max/1000.0f;
+        }
+        for (auto n=0u; n<points; n++) {
+            auto f = points>1 ? static_cast<float>(n)/(points-1) : 1.0f;
+            axes[k].push_back(min * std::pow(range.max/min, f));
+        }
+    }
+    std::vector<Gains> candidates;
+    for (auto p : axes[0]) {
+        for (auto i : axes[1]) {
+            for (auto d : axes[2]) {
+                candidates.push_back(Gains { p, i, d });
+            }
+        }
+    }
+    consider(candidates, evaluate(candidates));
+
+    // Local refinement with a log normal spread around the best gains
+    std::mt19937 mt { 42 };
+    auto spread = 0.5f;
+    for (auto round=0u; round<m_rounds; round++) {
+        std::normal_distribution<float> factor { 0.0f, spread };
+        std::uniform_real_distribution<float> uniform { 0.0f, 1.0f };
+        auto perturb = [&](float value, const Range &range) {
+            if (value<=0.0f) {
+                // Try switching an unused term on now and then
+                return uniform(mt)<0.25f ? range.max/1000.0f*std::pow(10.0f, 2.0f*uniform(mt)) : 0.0f;
+            }
+            return std::clamp(value*std::pow(10.0f, factor(mt)), range.min, range.max);
+        };
+        candidates.clear();
+        for (auto n=0u; n<m_candidates; n++) {
+            candidates.push_back(Gains {
+                perturb(result.gains.p, m_ranges[0]),
+                perturb(result.gains.i, m_ranges[1]),
+                perturb(result.gains.d, m_ranges[2]),
+            });
+        }
+        consider(candidates, evaluate(candidates));
+        spread *= 0.7f;
+    }
+
+    return result;
+}
+
+
+
+Score Tuner::motorEpisode(const Gains &gains) const
+{
+    constexpr Math::PID::sample_time_type interval { Motor::MOTOR_TIMER_INTERVAL };
+    const auto dt = interval.count();
+
+    Plant plant { m_parameters };
+    MotorLoop motor { plant, MOTOR_INDEX };
+    Math::PID pid { gains.p, gains.i, gains.d, interval, Motor::MOTOR_PID_EMA_ALPHA };
+    Math::MotionProfile profile { Motor::MOTOR_ACCEL_MAX, Motor::MOTOR_JERK_MAX };
+    profile.setTarget(MOTOR_TARGET_RPM);
+
+    Response response { std::chrono::duration<float>(MOTOR_DISTURBANCE_AT).count() };
+    const auto ticks = static_cast<uint>(MOTOR_EPISODE/Motor::MOTOR_TIMER_INTERVAL);
+    for (auto tick=0u; tick<ticks; tick++) {
+        auto time = tick*dt;
+        if (time>=std::chrono::duration<float>(MOTOR_DISTURBANCE_AT).count()) {
+            plant.setLoad(MOTOR_INDEX, MOTOR_LOAD_TORQUE);
+        }
+        plant.advance(interval);
+        // Feed forward along the profile, the PID corrects the residual
+        auto reference = profile.update(interval);
+        auto feed_forward = reference!=0.0f ? Motor::MOTOR_FF_KV*reference + std::copysign(Motor::MOTOR_FF_KS, reference) : 0.0f;
+        pid.setSetpoint(reference);
+        pid.setLimits(-1.0f-feed_forward, 1.0f-feed_forward);
+        motor.write(feed_forward + pid.update(motor.measure()));
+        response.sample(time+dt, plant.wheelRPM(MOTOR_INDEX)/MOTOR_TARGET_RPM, dt);
+    }
+    return response.score();
+}
+
+
+Score Tuner::balancingEpisode(const Gains &gains) const
+{
+    const auto dt = BALANCE_INTERVAL.count();
+    const auto motor_ticks = static_cast<uint>(std::chrono::duration<float>(Motor::MOTOR_TIMER_INTERVAL)/BALANCE_INTERVAL);
+
+    Plant plant { m_parameters };
+    plant.setPendulum(true, BALANCE_INITIAL_LEAN);
+    MotorLoop left { plant, REAR_LEFT };
+    MotorLoop right { plant, REAR_RIGHT };
+    Math::PID pid { gains.p, gains.i, gains.d, BALANCE_INTERVAL };
+    pid.setLimits(-1.0f, 1.0f);
+    pid.setSetpoint(static_cast<float>(M_PI_2));
+
+    Response response { std::chrono::duration<float>(BALANCE_DISTURBANCE_AT).count() };
+    const auto steps = static_cast<uint>(BALANCE_EPISODE/BALANCE_INTERVAL);
+    auto duty = 0.0f;
+    for (auto step=0u; step<steps; step++) {
+        auto time = step*dt;
+        if (step==static_cast<uint>(BALANCE_DISTURBANCE_AT/BALANCE_INTERVAL)) {
+            plant.push(BALANCE_PUSH);
+        }
+        duty = pid.update(plant.imu().pitch);
+        if (step%motor_ticks==0) {
+            // The rear right motor is mirrored
+            left.write(duty);
+            right.write(-duty);
+        }
+        plant.advance(BALANCE_INTERVAL);
+
+        auto tilt = static_cast<float>(M_PI_2) - plant.imu().pitch;
+        if (std::abs(tilt)>BALANCE_FALL_ANGLE) {
+            response.fail();
+            break;
+        }
+        response.sample(time+dt, 1.0f - tilt/BALANCE_INITIAL_LEAN, dt);
+    }
+    return response.score();
+}
+
+
+
+std::ostream &operator<<(std::ostream &os, const Tuner::Loop &loop)
+{
+    switch (loop) {
+        case Tuner::Loop::MOTOR:
+            return os << "motor";
+        case Tuner::Loop::BALANCING:
+            return os << "balancing";
+    }
+    return os;
+}
+
+
+}
@@ -0,0 +1,97 @@
+#ifndef _ROBOT_SIMULATION_TUNER_H_
+#define _ROBOT_SIMULATION_TUNER_H_
+
+#include <string>
+#include <vector>
+#include <iostream>
+
+#include <robottypes.h>
+#include "plant.h"
+
+namespace Robot::Simulation {
+
+    struct Gains {
+        float p;
+        float i;
+        float d;
+    };
+
+    /**
+     * Step and disturbance response of one simulated episode.
+     */
+    struct Score {
+        bool stable;            // Did not fall and ended close to the target
+        float rise_time;        // s from 10% to 90% of the step
+        float overshoot;        // Fraction of the step
+        float settling_time;    // s until the response stays within the settling band
+        float disturbance;      // Integrated absolute error after the disturbance, relative to the step (s)
+
+        float cost() const;
+    };
+
+
+    /**
+     * Searches controller gains by running simulated episodes on the plant.
+     *
+     * A log spaced grid over the gain ranges is evaluated first, followed by
+     * rounds of random perturbations around the best candidate with a shrinking
+     * spread. Episodes are independent and are spread over a pool of threads.
+     */
+    class Tuner {
+        public:
+            enum class Loop {
+                MOTOR,      ///< Motor RPM loop, step from standstill and a wheel load disturbance
+                BALANCING,  ///< Balancing pitch loop, recovery from a lean and a push
+            };
+
+            struct Range {
+                float min;
+                float max;
+            };
+
+            struct Result {
+                Gains gains;
+                Score score;
+                uint episodes;
+            };
+
+            explicit Tuner(Loop loop, const Plant::Parameters &parameters = Plant::Parameters::defaults());
+
+            void setThreads(uint threads) { m_threads = std::max(1u, threads); }
+            void setGrid(uint points) { m_grid = std::max(2u, points); }
+            void setRounds(uint rounds, uint candidates) { m_rounds = rounds; m_candidates = candidates; }
+            void setRange(const Range &p, const Range &i, const Range &d) { m_ranges = { p, i, d }; }
+
+            Score evaluate(const Gains &gains) const;
+            std::vector<Score> evaluate(const std::vector<Gains> &gains) const;
+
+            Result run() const;
+
+            /**
+             * @brief Write the gains into the property group read by the controller
+             */
+            void store(Context &context, const Gains &gains) const;
+
+            Loop loop() const { return m_loop; }
+
+            static Gains defaults(Loop loop);
+            static const std::string &propertyGroup(Loop loop);
+
+        private:
+            const Loop m_loop;
+            const Plant::Parameters m_parameters;
+            uint m_threads;
+            uint m_grid;
+            uint m_rounds;
+            uint m_candidates;
+            std::array<Range, 3> m_ranges;
+
+            Score motorEpisode(const Gains &gains) const;
+            Score balancingEpisode(const Gains &gains) const;
+    };
+
+    std::ostream &operator<<(std::ostream &os, const Tuner::Loop &loop);
+
+}
+
+#endif
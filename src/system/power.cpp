@@ -86,7 +86,7 @@ void Power::cleanup()
 void Power::onTelemetryEvent(const ::Robot::Telemetry::Event &event)
 {
     #if ROBOT_HAVE_BATTERY
-    if (const auto ev = dynamic_cast<const Robot::Telemetry::EventBattery*>(&event)) {
+    if (const auto ev = Robot::Telemetry::event_cast<Robot::Telemetry::EventBattery>(event)) {
         const std::lock_guard<std::mutex> lock(m_mutex);
         if (ev->battery_id==0) {
             // Main battery
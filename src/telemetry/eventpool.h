@@ -0,0 +1,143 @@
+#ifndef _ROBOT_TELEMETRY_EVENTPOOL_H_
+#define _ROBOT_TELEMETRY_EVENTPOOL_H_
+
+#include <array>
+#include <atomic>
+#include <utility>
+#include <cstddef>
+#include <metrics/metrics.h>
+#include "events.h"
+
+namespace Robot::Telemetry {
+
+    /**
+     * @brief Reference counted handle to a pooled event
+     *
+     * Copying the handle only bumps the slot reference count, the slot is
+     * returned to its pool when the last handle goes away.
+     */
+    template<typename T>
+    class EventHandle {
+        public:
+            using refcount_type = std::atomic<uint>;
+
+            EventHandle() : m_event { nullptr }, m_refs { nullptr } {}
+            EventHandle(T *event, refcount_type *refs) : m_event { event }, m_refs { refs } {}
+            EventHandle(const EventHandle &other) :
+                m_event { other.m_event },
+                m_refs { other.m_refs }
+            {
+                if (m_refs) {
+                    m_refs->fetch_add(1, std::memory_order_relaxed);
+                }
+            }
+            EventHandle(EventHandle &&other) noexcept :
+                m_event { std::exchange(other.m_event, nullptr) },
+                m_refs { std::exchange(other.m_refs, nullptr) }
+            {
+            }
+            /**
+             * @brief Type erasing conversion, ex. EventHandle<EventIMU> to EventHandle<const Event>
+             */
+            template<typename U, typename = std::enable_if_t<std::is_convertible_v<U*, T*>>>
+            EventHandle(EventHandle<U> other) :
+                m_event { std::exchange(other.m_event, nullptr) },
+                m_refs { std::exchange(other.m_refs, nullptr) }
+            {
+            }
+            ~EventHandle()
+            {
+                reset();
+            }
+
+            EventHandle &operator=(EventHandle other) noexcept
+            {
+                std::swap(m_event, other.m_event);
+                std::swap(m_refs, other.m_refs);
+                return *this;
+            }
+
+            void reset()
+            {
+                if (m_refs) {
+                    m_refs->fetch_sub(1, std::memory_order_release);
+                }
+                m_event = nullptr;
+                m_refs = nullptr;
+            }
+
+            explicit operator bool() const { return m_event!=nullptr; }
+            T &operator*() const { return *m_event; }
+            T *operator->() const { return m_event; }
+            T *get() const { return m_event; }
+
+        private:
+            template<typename U>
+            friend class EventHandle;
+
+            T *m_event;
+            refcount_type *m_refs;
+    };
+
+    using EventRef = EventHandle<const Event>;
+
+
+    /**
+     * @brief Fixed set of preallocated events owned by a telemetry source
+     *
+     * acquire() is lock free and never allocates. When every slot is still
+     * referenced by consumers an empty handle is returned and the producer
+     * should drop the sample.
+     *
+     * @tparam T Event type
+     * @tparam N Number of slots
+     */
+    template<typename T, std::size_t N = 4>
+    class EventPool {
+        public:
+            using handle_type = EventHandle<T>;
+
+            explicit EventPool(const std::string_view &name) :
+                m_next { 0u }
+            {
+                for (auto &slot : m_slots) {
+                    slot.refs.store(0u, std::memory_order_relaxed);
+                    slot.event = T { name };
+                }
+                m_initial = T { name };
+            }
+            EventPool(const EventPool&) = delete; // No copy constructor
+            EventPool(EventPool&&) = delete; // No move constructor
+
+            /**
+             * @brief Get a free event, reset to its initial value
+             */
+            handle_type acquire()
+            {
+                for (auto n=0u; n<N; n++) {
+                    auto &slot = m_slots[m_next.fetch_add(1, std::memory_order_relaxed) % N];
+                    uint expected = 0u;
+                    if (slot.refs.compare_exchange_strong(expected, 1u, std::memory_order_acquire, std::memory_order_relaxed)) {
+                        slot.event = m_initial;
+                        return handle_type { &slot.event, &slot.refs };
+                    }
+                }
+                static const auto exhausted = Metrics::registry().counter("robot_telemetry_pool_exhausted", "Telemetry events dropped because the source pool was empty");
+                exhausted->inc();
+                return handle_type {};
+            }
+
+        private:
+            struct Slot {
+                typename handle_type::refcount_type refs;
+                T event;
+            };
+
+            T m_initial;
+            std::atomic<uint> m_next;
+            std::array<Slot, N> m_slots;
+    };
+
+}
+
+#endif
@@ -1,7 +1,25 @@
 #include "events.h"
 
+#include <string>
+
 namespace Robot::Telemetry {
 
+/**
+ * Keys are only allocated the first time they are inserted, after that 
+ * the lookup is heterogeneous and the value is assigned in place.
+ */
+template<typename T>
+static inline void set(ValueMap &map, const std::string_view &key, T value)
+{
+    if (auto it = map.find(key); it!=map.end()) {
+        it->second = value;
+    }
+    else {
+        map.emplace(key, value);
+    }
+}
+
+
 void EventMotors::update(ValueMap &map) const
 {
     
@@ -9,27 +27,107 @@ void EventMotors::update(ValueMap &map) const
 
 void EventBattery::update(ValueMap &map) const 
 {
-    map["id"] = (uint32_t)battery_id;
-    map["voltage"] = voltage;
-    map["cells"] = (uint32_t)cell_voltage.size();
+    set(map, "id", (uint32_t)battery_id);
+    set(map, "voltage", voltage);
+    set(map, "cells", (uint32_t)cell_count);
 }
 
 void EventTemperature::update(ValueMap &map) const 
 {
-    map["temp"] = temperature;
+    set(map, "temp", temperature);
 }
 
 void EventOdometer::update(ValueMap &map) const
 {
-    map["value"] = value;
+    set(map, "value", value);
+}
+
+void EventSystem::update(ValueMap &map) const
+{
+    static const auto THREAD_CPU_KEYS = [] {
+        std::array<std::string, Context::THREADS_MAX> keys;
+        for (auto i=0u; i<keys.size(); i++) {
+            keys[i] = "thread_cpu_" + std::to_string(i);
+        }
+        return keys;
+    }();
+
+    set(map, "threads", thread_count);
+    set(map, "cpu", cpu);
+    set(map, "context_switches", context_switches);
+    set(map, "context_switches_involuntary", context_switches_involuntary);
+    set(map, "rss_kb", rss_kb);
+    set(map, "minor_faults", minor_faults);
+    set(map, "major_faults", major_faults);
+    set(map, "temp", temperature);
+    set(map, "load1", load[0]);
+    set(map, "load5", load[1]);
+    set(map, "load15", load[2]);
+    for (auto i=0u; i<THREAD_CPU_KEYS.size(); i++) {
+        if (i<thread_count) {
+            set(map, THREAD_CPU_KEYS[i], thread_cpu[i]);
+        }
+        else if (auto it = map.find(THREAD_CPU_KEYS[i]); it!=map.end()) {
+            map.erase(it);
+        }
+    }
 }
 
 void EventIMU::update(ValueMap &map) const 
 {
-    map["pitch"] = pitch;
-    map["roll"] = roll;
-    map["yaw"] = yaw;
+    set(map, "pitch", pitch);
+    set(map, "roll", roll);
+    set(map, "yaw", yaw);
 }
 
 
-}
\ No newline at end of file
+void EventPerf::update(ValueMap &map) const
+{
+    std::string key { loop };
+    key.push_back('_');
+    const auto prefix = key.size();
+    auto field = [&key, prefix](const char *name) -> const std::string & {
+        key.resize(prefix);
+        key.append(name);
+        return key;
+    };
+
+    set(map, field("ticks"), ticks);
+    set(map, field("rate"), rate);
+    set(map, field("cycles"), cycles);
+    set(map, field("instructions"), instructions);
+    set(map, field("ipc"), cycles>0.0f ? instructions/cycles : 0.0f);
+    set(map, field("cache_misses"), cache_misses);
+    set(map, field("context_switches"), context_switches);
+}
+
+void EventAutotune::update(ValueMap &map) const
+{
+    static const std::array<std::string, 4> STATE_NAMES { "IDLE", "RUNNING", "DONE", "FAILED" };
+
+    set(map, "motor", motor);
+    set(map, "state", STATE_NAMES[static_cast<std::size_t>(state)]);
+    set(map, "cycles", cycles);
+    set(map, "setpoint", setpoint);
+    set(map, "bias", bias);
+    set(map, "swing", swing);
+    set(map, "ku", ku);
+    set(map, "tu", tu);
+    set(map, "pid_p", p);
+    set(map, "pid_i", i);
+    set(map, "pid_d", d);
+}
+
+void EventTraction::update(ValueMap &map) const
+{
+    static const std::array<std::string, 3> STATE_NAMES { "GRIP", "SLIP", "STALL" };
+
+    set(map, "motor", motor);
+    set(map, "state", STATE_NAMES[static_cast<std::size_t>(state)]);
+    set(map, "rpm", rpm);
+    set(map, "expected", expected);
+    set(map, "limit", limit);
+}
+
+
+}
@@ -2,24 +2,55 @@
 #define _ROBOT_TELEMETRY_EVENTS_H_
 
 #include <cstdint>
-#include <vector>
 #include <array>
 #include <string_view>
+#include <type_traits>
 #include "types.h"
+#include <robotcontext.h>
 #include <motor/types.h>
+#include <motor/autotune.h>
+#include <motor/traction.h>
 
 namespace Robot::Telemetry {
 
+    /**
+     * @brief Base of all telemetry events
+     * 
+     * Events are plain fixed-size structs so they can be copied between threads
+     * and stored in pools without touching the heap. The concrete type is
+     * identified by the type tag, use event_cast<T>() instead of dynamic_cast.
+     */
     class Event {
         public:
+            enum class Type : std::uint8_t {
+                MOTORS,
+                BATTERY,
+                TEMPERATURE,
+                ODOMETER,
+                IMU,
+                SYSTEM,
+                PERF,
+                AUTOTUNE,
+                TRACTION,
+            };
+
+            Type type;
             std::string_view name;
-            Event(const std::string_view &name) : name { name } {}
-            virtual ~Event() = default;
-            virtual void update(ValueMap &map) const = 0;
+
+        protected:
+            Event(Type type, const std::string_view &name) : type { type }, name { name } {}
     };
 
+    template<typename T>
+    inline const T *event_cast(const Event &event) 
+    {
+        return event.type==T::TYPE ? static_cast<const T*>(&event) : nullptr;
+    }
+
+
     class EventMotors : public Event {
         public:
+            static constexpr Type TYPE { Type::MOTORS };
             using duty_type = float;
             using rpm_type = float;
             using duty_list = std::array<duty_type, Motor::MOTOR_COUNT>;
@@ -30,57 +61,76 @@ namespace Robot::Telemetry {
             rpm_list rpm_target;
 
             EventMotors(const std::string_view &name) : 
-                Event { name }
+                Event { TYPE, name }
             {
                 duty.fill(0.0f);
                 rpm.fill(0.0f);
                 rpm_target.fill(0.0f);
             }
             EventMotors() : EventMotors { "" } {}
-            virtual void update(ValueMap &map) const;
+            void update(ValueMap &map) const;
     };
 
     class EventBattery : public Event {
         public:
+            static constexpr Type TYPE { Type::BATTERY };
+            static constexpr auto CELLS_MAX { 6u };
+            using cell_list = std::array<float, CELLS_MAX>;
+
             EventBattery(const std::string_view &name) : 
-                Event { name },
+                Event { TYPE, name },
                 battery_id { 0x00 },
                 charging { false },
                 on_battery { true },
                 jack_voltage { 0.0f },
                 percent { 0.0f },
-                voltage { 0.0f }
+                voltage { 0.0f },
+                cell_count { 0u }
             { 
+                cell_voltage.fill(0.0f);
             }
+            EventBattery() : EventBattery { "" } {}
             std::uint8_t battery_id;
             bool charging; // Is the battery charging
             bool on_battery; // Is the robot running on battery
             float jack_voltage; // Voltage of the power supply
             float percent; // Pattery charge percent
             float voltage; // Total battery voltage
-            std::vector<float> cell_voltage;
-            virtual void update(ValueMap &map) const;
+            std::uint8_t cell_count; // Number of valid entries in cell_voltage
+            cell_list cell_voltage;
+
+            void addCell(float voltage) 
+            {
+                if (cell_count<cell_voltage.size()) {
+                    cell_voltage[cell_count++] = voltage;
+                }
+            }
+            void update(ValueMap &map) const;
     };
 
     class EventTemperature : public Event {
         public:
-            EventTemperature(const std::string_view &name) : Event { name }, temperature { 0.0f } {}
+            static constexpr Type TYPE { Type::TEMPERATURE };
+            EventTemperature(const std::string_view &name) : Event { TYPE, name }, temperature { 0.0f } {}
+            EventTemperature() : EventTemperature { "" } {}
             float temperature;
-            virtual void update(ValueMap &map) const;
+            void update(ValueMap &map) const;
     };
 
     class EventOdometer : public Event {
         public:
-            EventOdometer(const std::string_view &name) : Event { name }, value { 0 } {}
+            static constexpr Type TYPE { Type::ODOMETER };
+            EventOdometer(const std::string_view &name) : Event { TYPE, name }, value { 0 } {}
             EventOdometer() : EventOdometer { "" } {}
             std::int32_t value;
-            virtual void update(ValueMap &map) const;
+            void update(ValueMap &map) const;
     };
 
     class EventIMU : public Event {
         public:
+            static constexpr Type TYPE { Type::IMU };
             EventIMU(const std::string_view &name, float pitch, float roll, float yaw) : 
-                Event { name },
+                Event { TYPE, name },
                 pitch { pitch },
                 roll { roll },
                 yaw { yaw }
@@ -97,9 +147,133 @@ namespace Robot::Telemetry {
             float pitch;
             float roll;
             float yaw;
-            virtual void update(ValueMap &map) const;
+            void update(ValueMap &map) const;
     };
 
+    class EventSystem : public Event {
+        public:
+            static constexpr Type TYPE { Type::SYSTEM };
+            using thread_cpu_list = std::array<float, Context::THREADS_MAX>;
+
+            EventSystem(const std::string_view &name) : 
+                Event { TYPE, name },
+                thread_count { 0u },
+                cpu { 0.0f },
+                context_switches { 0.0f },
+                context_switches_involuntary { 0.0f },
+                rss_kb { 0u },
+                minor_faults { 0.0f },
+                major_faults { 0.0f },
+                temperature { 0.0f },
+                load { 0.0f, 0.0f, 0.0f }
+            {
+                thread_cpu.fill(0.0f);
+            }
+            EventSystem() : EventSystem { "" } {}
+            std::uint32_t thread_count; // Number of valid entries in thread_cpu
+            thread_cpu_list thread_cpu; // CPU usage of each context pool thread (0..1)
+            float cpu; // Combined CPU usage of the context pool (0..1 per core)
+            float context_switches; // Voluntary context switches per second
+            float context_switches_involuntary; // Involuntary context switches per second
+            std::uint32_t rss_kb; // Resident set size
+            float minor_faults; // Minor page faults per second
+            float major_faults; // Major page faults per second
+            float temperature; // SoC temperature in celsius
+            std::array<float, 3> load; // 1, 5 and 15 minute load average
+            void update(ValueMap &map) const;
+    };
+
+    class EventPerf : public Event {
+        public:
+            static constexpr Type TYPE { Type::PERF };
+
+            EventPerf(const std::string_view &name) :
+                Event { TYPE, name },
+                ticks { 0u },
+                rate { 0.0f },
+                cycles { 0.0f },
+                instructions { 0.0f },
+                cache_misses { 0.0f },
+                context_switches { 0u }
+            {
+            }
+            EventPerf() : EventPerf { "" } {}
+            std::string_view loop; // Name of the control loop
+            std::uint32_t ticks; // Ticks sampled in the interval
+            float rate; // Ticks per second
+            float cycles; // CPU cycles per tick
+            float instructions; // Instructions per tick
+            float cache_misses; // Cache misses per tick
+            std::uint32_t context_switches; // Context switches during ticks in the interval
+            void update(ValueMap &map) const;
+    };
+
+    class EventAutotune : public Event {
+        public:
+            static constexpr Type TYPE { Type::AUTOTUNE };
+
+            EventAutotune(const std::string_view &name) :
+                Event { TYPE, name },
+                motor { 0u },
+                state { Motor::Autotune::State::IDLE },
+                cycles { 0u },
+                setpoint { 0.0f },
+                bias { 0.0f },
+                swing { 0.0f },
+                ku { 0.0f },
+                tu { 0.0f },
+                p { 0.0f },
+                i { 0.0f },
+                d { 0.0f }
+            {
+            }
+            EventAutotune() : EventAutotune { "" } {}
+            std::uint32_t motor; // Motor index
+            Motor::Autotune::State state;
+            std::uint32_t cycles; // Completed relay cycles
+            float setpoint; // RPM
+            float bias; // Duty the relay is centered on
+            float swing; // RPM amplitude of the last cycle
+            float ku; // Ultimate gain
+            float tu; // Ultimate period (s)
+            float p;
+            float i;
+            float d;
+            void update(ValueMap &map) const;
+    };
+
+    class EventTraction : public Event {
+        public:
+            static constexpr Type TYPE { Type::TRACTION };
+
+            EventTraction(const std::string_view &name) :
+                Event { TYPE, name },
+                motor { 0u },
+                state { Motor::Traction::State::GRIP },
+                rpm { 0.0f },
+                expected { 0.0f },
+                limit { 1.0f }
+            {
+            }
+            EventTraction() : EventTraction { "" } {}
+            std::uint32_t motor; // Motor index
+            Motor::Traction::State state;
+            float rpm; // Measured RPM
+            float expected; // RPM expected from the command
+            float limit; // Factor the duty is scaled with
+            void update(ValueMap &map) const;
+    };
+
+    static_assert(std::is_trivially_copyable_v<EventMotors>);
+    static_assert(std::is_trivially_copyable_v<EventBattery>);
+    static_assert(std::is_trivially_copyable_v<EventTemperature>);
+    static_assert(std::is_trivially_copyable_v<EventOdometer>);
+    static_assert(std::is_trivially_copyable_v<EventIMU>);
+    static_assert(std::is_trivially_copyable_v<EventSystem>);
+    static_assert(std::is_trivially_copyable_v<EventPerf>);
+    static_assert(std::is_trivially_copyable_v<EventAutotune>);
+    static_assert(std::is_trivially_copyable_v<EventTraction>);
+
 }
 
 
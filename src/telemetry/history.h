@@ -36,6 +36,7 @@ namespace Robot::Telemetry {
     using HistoryIMU = HistoryData<std::array<float,3>>;
     using HistoryMotorDuty = HistoryData<std::array<float,Motor::MOTOR_COUNT>>;
     using HistoryMotorRPM = HistoryData<std::array<float,Motor::MOTOR_COUNT*2>>;
+    using HistorySystem = HistoryData<std::array<float,4>>; // cpu, temperature, load1, context switches/s
 
 }
 
@@ -11,7 +11,7 @@ namespace Robot::Telemetry {
     template<typename T>
     class AbstractSource : public Source, public std::enable_shared_from_this<T> {
         public:
-            AbstractSource() { }
+            explicit AbstractSource(const std::string_view &name, bool always_on = false) : Source { name, always_on } { }
             virtual ~AbstractSource() = default;
 
     };
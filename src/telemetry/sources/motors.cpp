@@ -6,11 +6,20 @@
 
 namespace Robot::Telemetry {
 
+static const std::string_view SOURCE_NAME { "motors" };
+
 Motors::Motors(const std::shared_ptr<Motor::Control> &motor_control) :
+    AbstractSource { SOURCE_NAME },
+    m_initialized { false },
     m_motor_control { motor_control },
-    m_event { "motors" }
+    m_events { SOURCE_NAME },
+    m_autotune_events { SOURCE_NAME },
+    m_traction_events { SOURCE_NAME }
 {
-
+    for (auto &status : m_autotune) {
+        status = Motor::Autotune::Status { Motor::Autotune::State::IDLE, 0u, 0.0f, 0.0f, { 0.0f, 0.0f, 0.0f, 0.0f, 0.0f } };
+    }
+    m_traction.fill(Motor::Traction::State::GRIP);
 }
 
 
@@ -24,10 +33,6 @@ void Motors::init(const std::shared_ptr<Telemetry> &telemetry)
 {
     m_initialized = true;
     AbstractSource::init(telemetry);
-
-    if (auto control = m_motor_control.lock()) {
-        m_connection = control->sig_motor.connect([this](const auto &motors) { onMotorsUpdated(motors); });
-    }
 }
 
 
@@ -37,20 +42,90 @@ void Motors::cleanup()
         return;
     m_initialized = false;
 
-    m_connection.disconnect();
-
     AbstractSource::cleanup();
 }
 
 
+void Motors::start()
+{
+    if (auto control = m_motor_control.lock()) {
+        m_connection = control->sig_motor.connect([this](const auto &motors) { onMotorsUpdated(motors); });
+    }
+}
+
+
+void Motors::stop()
+{
+    m_connection.disconnect();
+}
+
+
 void Motors::onMotorsUpdated(const Motor::MotorList &motors)
 {
+    auto event = m_events.acquire();
+    if (!event) 
+        return;
+    for (auto i = 0u; i<motors.size(); i++) {
+        event->duty[i] = motors[i]->getDuty();
+        event->rpm[i] = motors[i]->getRPM();
+        event->rpm_target[i] = motors[i]->getTargetRPM();
+    }
+    sendEvent(event);
+
+    // Auto-tune progress is only sent when a cycle completes or the state changes
     for (auto i = 0u; i<motors.size(); i++) {
-        m_event.duty[i] = motors[i]->getDuty();
-        m_event.rpm[i] = motors[i]->getRPM();
-        m_event.rpm_target[i] = motors[i]->getTargetRPM();
+        auto &last = m_autotune[i];
+        if (motors[i]->getMode()!=Motor::Motor::Mode::AUTOTUNE && last.state!=Motor::Autotune::State::RUNNING)
+            continue;
+        auto status = motors[i]->getAutotune();
+        if (status.state!=last.state || status.cycles!=last.cycles) {
+            sendAutotune(i, motors[i]->getTargetRPM(), status);
+            last = status;
+        }
     }
-    sendEvent(m_event);
+
+    // Slip and stall alarms are sent when a wheel changes state
+    for (auto i = 0u; i<motors.size(); i++) {
+        const auto state = motors[i]->getTraction();
+        if (state!=m_traction[i]) {
+            sendTraction(i, *motors[i]);
+            m_traction[i] = state;
+        }
+    }
+}
+
+
+void Motors::sendAutotune(uint index, float setpoint, const Motor::Autotune::Status &status)
+{
+    auto event = m_autotune_events.acquire();
+    if (!event) 
+        return;
+    event->motor = index;
+    event->state = status.state;
+    event->cycles = status.cycles;
+    event->setpoint = setpoint;
+    event->bias = status.bias;
+    event->swing = status.swing;
+    event->ku = status.result.ku;
+    event->tu = status.result.tu;
+    event->p = status.result.p;
+    event->i = status.result.i;
+    event->d = status.result.d;
+    sendEvent(event);
+}
+
+
+void Motors::sendTraction(uint index, const Motor::Motor &motor)
+{
+    auto event = m_traction_events.acquire();
+    if (!event) 
+        return;
+    event->motor = index;
+    event->state = motor.getTraction();
+    event->rpm = motor.getRPM();
+    event->expected = motor.getExpectedRPM();
+    event->limit = motor.getTractionLimit();
+    sendEvent(event);
 }
 
 
@@ -10,6 +10,7 @@
 #include "abstracttelemetrysource.h"
 #include <motor/types.h>
 #include "../types.h"
+#include "../eventpool.h"
 
 namespace Robot::Telemetry {
 
@@ -23,15 +24,25 @@ namespace Robot::Telemetry {
             void init(const std::shared_ptr<Telemetry> &telemetry);
             void cleanup();
 
+        protected:
+            void start() override;
+            void stop() override;
+
         private:
             bool m_initialized;
 
             std::weak_ptr<Motor::Control> m_motor_control;
 
-            EventMotors m_event;
+            EventPool<EventMotors> m_events;
+            EventPool<EventAutotune> m_autotune_events;
+            std::array<Motor::Autotune::Status, Motor::MOTOR_COUNT> m_autotune;
+            EventPool<EventTraction> m_traction_events;
+            std::array<Motor::Traction::State, Motor::MOTOR_COUNT> m_traction;
 
             boost::signals2::connection m_connection;
             void onMotorsUpdated(const Motor::MotorList &motors);
+            void sendAutotune(uint index, float setpoint, const Motor::Autotune::Status &status);
+            void sendTraction(uint index, const Motor::Motor &motor);
     };
 
 }
@@ -5,9 +5,13 @@
 
 namespace Robot::Telemetry {
 
+static const std::string_view SOURCE_NAME { "odometer" };
+
 Odometer::Odometer(const std::shared_ptr<Kinematic::Kinematic> &kinematic) :
+    AbstractSource { SOURCE_NAME },
+    m_initialized { false },
     m_kinematic { kinematic },
-    m_event { "odometer" }
+    m_events { SOURCE_NAME }
 {
 
 }
@@ -23,10 +27,6 @@ void Odometer::init(const std::shared_ptr<Telemetry> &telemetry)
 {
     m_initialized = true;
     AbstractSource::init(telemetry);
-
-    if (auto kinematic = m_kinematic.lock()) {
-        m_connection = kinematic->sig_odometer.connect([this](auto odometer) { onOdometerUpdated(odometer); });
-    }
 }
 
 
@@ -36,16 +36,30 @@ void Odometer::cleanup()
         return;
     m_initialized = false;
 
-    m_connection.disconnect();
-
     AbstractSource::cleanup();
 }
 
 
+void Odometer::start()
+{
+    if (auto kinematic = m_kinematic.lock()) {
+        m_connection = kinematic->sig_odometer.connect([this](auto odometer) { onOdometerUpdated(odometer); });
+    }
+}
+
+
+void Odometer::stop()
+{
+    m_connection.disconnect();
+}
+
+
 void Odometer::onOdometerUpdated(Kinematic::Kinematic::odometer_type odometer)
 {
-    m_event.value = odometer;
-    sendEvent(m_event);
+    if (auto event = m_events.acquire()) {
+        event->value = odometer;
+        sendEvent(event);
+    }
 }
 
 
@@ -10,6 +10,7 @@
 #include "abstracttelemetrysource.h"
 #include <kinematic/types.h>
 #include "../types.h"
+#include "../eventpool.h"
 
 namespace Robot::Telemetry {
 
@@ -25,12 +26,16 @@ namespace Robot::Telemetry {
             void init(const std::shared_ptr<Telemetry> &telemetry);
             void cleanup();
 
+        protected:
+            void start() override;
+            void stop() override;
+
         private:
             bool m_initialized;
 
             std::weak_ptr<Kinematic::Kinematic> m_kinematic;
 
-            EventOdometer m_event;
+            EventPool<EventOdometer> m_events;
 
             boost::signals2::connection m_connection;
             void onOdometerUpdated(odometer_type odometer);
@@ -0,0 +1,135 @@
+#include "perfcounters.h"
+
+#include <boost/log/trivial.hpp>
+
+#include <robotcontext.h>
+#include <metrics/perfcounters.h>
+#include "../types.h"
+#include "../events.h"
+#include "../telemetry.h"
+
+using namespace std::literals;
+
+namespace Robot::Telemetry {
+
+static constexpr auto DEFAULT_INTERVAL_MS { 1000 };
+static constexpr auto MIN_INTERVAL_MS { 100 };
+static const std::string SOURCE_NAME { "perf" };
+
+
+PerfCounters::PerfCounters(const std::shared_ptr<Robot::Context> &context) :
+    AbstractSource { SOURCE_NAME },
+    WithStrand { context->io() },
+    m_initialized { false },
+    m_context { context },
+    m_timer { context->io() },
+    m_generation { 0u },
+    m_interval { DEFAULT_INTERVAL_MS },
+    m_events { SOURCE_NAME }
+{
+    PropertyMap values;
+    values.put(PROPERTY_INTERVAL, DEFAULT_INTERVAL_MS);
+    context->registerProperties(PROPERTY_GROUP, values);
+}
+
+
+PerfCounters::~PerfCounters()
+{
+    cleanup();
+}
+
+
+void PerfCounters::init(const std::shared_ptr<Telemetry> &telemetry)
+{
+    AbstractSource::init(telemetry);
+
+    m_initialized = true;
+
+    const auto &properties = m_context->properties(PROPERTY_GROUP);
+    m_interval = std::chrono::milliseconds(std::max(MIN_INTERVAL_MS, properties.get(PROPERTY_INTERVAL, DEFAULT_INTERVAL_MS)));
+}
+
+
+void PerfCounters::cleanup()
+{
+    if (!m_initialized)
+        return;
+    m_initialized = false;
+
+    Metrics::PerfLoop::setEnabled(false);
+    m_timer.cancel();
+    AbstractSource::cleanup();
+}
+
+
+void PerfCounters::start()
+{
+    dispatch([this]{
+        // Drop whatever was left from a previous activation
+        for (auto &loop : Metrics::PerfLoop::loops()) {
+            loop->take();
+        }
+        m_last_time = clock_type::now();
+        Metrics::PerfLoop::setEnabled(true);
+
+        m_timer.expires_after(0s);
+        timer_setup(++m_generation);
+    });
+}
+
+
+void PerfCounters::stop()
+{
+    dispatch([this]{
+        Metrics::PerfLoop::setEnabled(false);
+        m_generation++;
+        m_timer.cancel();
+    });
+}
+
+
+inline void PerfCounters::timer()
+{
+    auto now = clock_type::now();
+    auto elapsed = std::chrono::duration<float>(now-m_last_time).count();
+    m_last_time = now;
+
+    for (auto &loop : Metrics::PerfLoop::loops()) {
+        auto totals = loop->take();
+        if (totals.ticks==0u) {
+            continue;
+        }
+        auto handle = m_events.acquire();
+        if (!handle)
+            return;
+        auto &event = *handle;
+
+        event.loop = loop->name();
+        event.ticks = totals.ticks;
+        event.rate = elapsed>0.0f ? totals.ticks/elapsed : 0.0f;
+        event.cycles = static_cast<float>(totals.cycles) / totals.ticks;
+        event.instructions = static_cast<float>(totals.instructions) / totals.ticks;
+        event.cache_misses = static_cast<float>(totals.cache_misses) / totals.ticks;
+        event.context_switches = totals.context_switches;
+
+        sendEvent(handle);
+    }
+}
+
+
+void PerfCounters::timer_setup(uint generation)
+{
+    m_timer.expires_at(m_timer.expiry() + m_interval);
+    m_timer.async_wait(boost::asio::bind_executor(m_strand,
+        [this,generation](boost::system::error_code error) {
+            if (error!=boost::system::errc::success || !m_initialized || generation!=m_generation) {
+                return;
+            }
+            timer();
+            timer_setup(generation);
+        }
+    ));
+}
+
+
+}
@@ -0,0 +1,57 @@
+#ifndef _ROBOT_TELEMETRY_PERFCOUNTERS_H_
+#define _ROBOT_TELEMETRY_PERFCOUNTERS_H_
+
+#include <memory>
+#include <chrono>
+#include <string>
+#include <boost/asio.hpp>
+
+#include <common/withstrand.h>
+#include "abstracttelemetrysource.h"
+#include "../types.h"
+#include "../eventpool.h"
+
+namespace Robot::Telemetry {
+
+    /**
+     * Publishes the hardware performance counter aggregates of the control loops.
+     *
+     * Counter sampling in the loops is only switched on while this source is
+     * active, so the instrumentation costs nothing until someone acquires "perf".
+     */
+    class PerfCounters : public AbstractSource<PerfCounters>, public WithStrand {
+        public:
+            inline static const std::string PROPERTY_GROUP { "perf" };
+            inline static const std::string PROPERTY_INTERVAL { "interval_ms" };
+
+            explicit PerfCounters(const std::shared_ptr<::Robot::Context> &context);
+            PerfCounters(const PerfCounters&) = delete; // No copy constructor
+            PerfCounters(PerfCounters&&) = delete; // No move constructor
+            virtual ~PerfCounters();
+
+            void init(const std::shared_ptr<Telemetry> &telemetry);
+            void cleanup();
+
+        protected:
+            void start() override;
+            void stop() override;
+
+        private:
+            using clock_type = std::chrono::steady_clock;
+
+            bool m_initialized;
+            std::shared_ptr<::Robot::Context> m_context;
+            boost::asio::steady_timer m_timer;
+            uint m_generation; // Incremented on the strand when started/stopped
+            std::chrono::milliseconds m_interval;
+            clock_type::time_point m_last_time;
+
+            EventPool<EventPerf, 8> m_events;
+
+            inline void timer();
+            void timer_setup(uint generation);
+    };
+
+}
+
+#endif
@@ -32,13 +32,16 @@ static constexpr auto FILTER_RESET_THRES { 2.0 };
 static constexpr auto FILTER_SAMPLES { 6 }; // average over 6 samples
 
 RobotControlBattery::RobotControlBattery(const std::shared_ptr<Robot::Context> &context):
+    AbstractSource { SOURCE_NAME, true },
     WithStrand { context->io() },
     m_initialized { false },
     m_timer { context->io() }, 
+    m_generation { 0u },
     m_pack_filter { rc_filter_empty() },
     m_jack_filter { rc_filter_empty() },
     m_pack_voltage { 0.0 },
-    m_jack_voltage { 0.0 }
+    m_jack_voltage { 0.0 },
+    m_events { SOURCE_NAME }
 
 {
 }
@@ -75,11 +78,6 @@ void RobotControlBattery::init(const std::shared_ptr<Telemetry> &telemetry)
 	}
 	rc_filter_prefill_outputs(&m_jack_filter, m_jack_voltage);
 	rc_filter_prefill_inputs(&m_jack_filter, m_jack_voltage);
-
-    // Setup battery timer
-    m_timer.expires_after(TIMER_INTERVAL);
-    timer_setup();
-
 }
 
 
@@ -94,6 +92,24 @@ void RobotControlBattery::cleanup()
 }
 
 
+void RobotControlBattery::start()
+{
+    dispatch([this]{
+        m_timer.expires_after(0s);
+        timer_setup(++m_generation);
+    });
+}
+
+
+void RobotControlBattery::stop()
+{
+    dispatch([this]{
+        m_generation++;
+        m_timer.cancel();
+    });
+}
+
+
 inline void RobotControlBattery::timer() 
 {
     auto v_pack = rc_adc_batt();
@@ -135,28 +151,29 @@ inline void RobotControlBattery::timer()
     else                            percent = 0.00f; // Critical
 
     // Fill and send event
-    EventBattery event { SOURCE_NAME };
-    event.battery_id = 0x00;
-    event.charging = charging;
-    event.on_battery = on_battery;
-    event.jack_voltage = m_jack_voltage;
-    event.percent = percent;
-    event.voltage = m_pack_voltage;
-    event.cell_voltage.push_back(cell_voltage);
-    event.cell_voltage.push_back(cell_voltage);
+    auto event = m_events.acquire();
+    if (!event)
+        return;
+    event->battery_id = 0x00;
+    event->charging = charging;
+    event->on_battery = on_battery;
+    event->jack_voltage = m_jack_voltage;
+    event->percent = percent;
+    event->voltage = m_pack_voltage;
+    event->addCell(cell_voltage);
+    event->addCell(cell_voltage);
     sendEvent(event);
-
-    timer_setup();
 }
 
-void RobotControlBattery::timer_setup() {
+void RobotControlBattery::timer_setup(uint generation) {
     m_timer.expires_at(m_timer.expiry() + TIMER_INTERVAL);
     m_timer.async_wait(boost::asio::bind_executor(m_strand, 
-        [this](boost::system::error_code error) {
-            if (error!=boost::system::errc::success || !m_initialized) {
+        [this,generation](boost::system::error_code error) {
+            if (error!=boost::system::errc::success || !m_initialized || generation!=m_generation) {
                 return;
             }
             timer();
+            timer_setup(generation);
         }
     ));
 }
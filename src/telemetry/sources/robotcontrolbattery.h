@@ -11,6 +11,7 @@
 #include <common/withnotify.h>
 #include "abstracttelemetrysource.h"
 #include "../types.h"
+#include "../eventpool.h"
 
 namespace Robot::Telemetry {
 
@@ -24,16 +25,22 @@ namespace Robot::Telemetry {
             void init(const std::shared_ptr<Telemetry> &telemetry);
             void cleanup();
 
+        protected:
+            void start() override;
+            void stop() override;
+
         private:
             bool m_initialized;
             boost::asio::steady_timer m_timer;
+            uint m_generation; // Incremented on the strand when started/stopped
             rc_filter_t m_pack_filter;
 	        rc_filter_t m_jack_filter;
             double m_pack_voltage;
             double m_jack_voltage;
+            EventPool<EventBattery> m_events;
 
             inline void timer();
-            void timer_setup();
+            void timer_setup(uint generation);
     };
 
 }
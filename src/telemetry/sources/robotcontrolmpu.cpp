@@ -38,9 +38,10 @@ static constexpr auto TELEMETRY_INTERVAL { 200ms };
 RobotControlMPU *RobotControlMPU::instance { nullptr };
 
 RobotControlMPU::RobotControlMPU(const std::shared_ptr<Robot::Context> &context):
+    AbstractSource { SOURCE_NAME },
     WithStrand { context->io() },
     m_initialized { false },
-    m_event { SOURCE_NAME }
+    m_events { SOURCE_NAME }
 {
 
 }
@@ -51,37 +52,35 @@ RobotControlMPU::~RobotControlMPU()
 }
 
 
-inline void RobotControlMPU::onData(const rc_mpu_data_t &data)
+inline void RobotControlMPU::onData(float pitch, float roll, float yaw)
 {
-    if (auto telemetry = m_telemetry.lock()) {
-        sendData(telemetry, data);
-
-        auto now = clock_type::now();
-        if (now-m_last_telemetry > TELEMETRY_INTERVAL) {
-            m_event.pitch = data.fused_TaitBryan[TB_PITCH_X];
-            m_event.roll  = data.fused_TaitBryan[TB_ROLL_Y];
-            m_event.yaw   = data.fused_TaitBryan[TB_YAW_Z];
-
-            #if 0
-            BOOST_LOG_TRIVIAL(info) 
-                << boost::format("MPU %04d  ") % m_data_count
-                << boost::format("| %6.1f | %6.1f |") % rad2deg(data.compass_heading_raw) % rad2deg(data.compass_heading)
-                << boost::format("| %6.1f | %6.1f | %6.1f |") % rad2deg(data.fused_TaitBryan[TB_PITCH_X]) % rad2deg(m_saved_data.fused_TaitBryan[TB_ROLL_Y]) % rad2deg(data.fused_TaitBryan[TB_YAW_Z])
-                ;
-            #endif
-
-            sendEvent(telemetry, m_event);
-            m_last_telemetry = now;
-        }
+    auto now = clock_type::now();
+    if (now-m_last_telemetry <= TELEMETRY_INTERVAL) 
+        return;
+    if (auto event = m_events.acquire()) {
+        event->pitch = pitch;
+        event->roll  = roll;
+        event->yaw   = yaw;
+
+        sendEvent(event);
+        m_last_telemetry = now;
     }
 }
 
 
 inline void RobotControlMPU::data_callback() 
 {
-    auto data = m_data;
-    dispatch([this,data]{
-        onData(data);
+    // sig_imu is emitted in the interrupt thread so real-time consumers get the
+    // sample without waiting for the io threads. Only the fused angles are
+    // copied for the telemetry event.
+    if (auto telemetry = m_telemetry.lock()) {
+        sendData(telemetry, m_data);
+    }
+    auto pitch = static_cast<float>(m_data.fused_TaitBryan[TB_PITCH_X]);
+    auto roll  = static_cast<float>(m_data.fused_TaitBryan[TB_ROLL_Y]);
+    auto yaw   = static_cast<float>(m_data.fused_TaitBryan[TB_YAW_Z]);
+    dispatch([this,pitch,roll,yaw]{
+        onData(pitch, roll, yaw);
     });
 }
 
@@ -89,6 +88,24 @@ void RobotControlMPU::init(const std::shared_ptr<Telemetry> &telemetry)
 {
     AbstractSource::init(telemetry);
 
+    m_initialized = true;
+}
+
+
+void RobotControlMPU::cleanup() 
+{
+    if (!m_initialized)
+        return;
+    m_initialized = false;
+
+    AbstractSource::cleanup();
+}
+
+
+void RobotControlMPU::start()
+{
+    BOOST_LOG_TRIVIAL(info) << "Starting MPU";
+
     instance = this;
 
 	rc_mpu_config_t conf = rc_mpu_default_config();
@@ -115,24 +132,16 @@ void RobotControlMPU::init(const std::shared_ptr<Telemetry> &telemetry)
     rc_mpu_set_dmp_callback([]() { RobotControlMPU::instance->data_callback(); });
 
     m_last_telemetry = clock_type::now();
-
-    m_initialized = true;
 }
 
 
-void RobotControlMPU::cleanup() 
+void RobotControlMPU::stop()
 {
-    if (!m_initialized)
-        return;
-    m_initialized = false;
-
-    BOOST_LOG_TRIVIAL(info) << "RobotControlMPU::cleanup()";
+    BOOST_LOG_TRIVIAL(info) << "Parking MPU";
 
 	rc_mpu_power_off();
     rc_mpu_set_dmp_callback(nullptr);
     instance = nullptr;
-
-    AbstractSource::cleanup();
 }
 
 
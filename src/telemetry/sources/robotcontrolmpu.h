@@ -13,6 +13,7 @@
 #include <common/withstrand.h>
 #include <common/withmutex.h>
 #include "../telemetry.h"
+#include "../eventpool.h"
 #include "abstracttelemetrysource.h"
 
 namespace Robot::Telemetry {
@@ -32,6 +33,9 @@ namespace Robot::Telemetry {
         protected:
             friend class Telemetry;
 
+            void start() override;
+            void stop() override;
+
             Signal sig_event;
 
         private:
@@ -43,9 +47,9 @@ namespace Robot::Telemetry {
             // Interrupt data
             rc_mpu_data_t m_data;
 
-            EventIMU m_event;
+            EventPool<EventIMU> m_events;
 
-            inline void onData(const rc_mpu_data_t &data);
+            inline void onData(float pitch, float roll, float yaw);
             inline void data_callback();
     };
 
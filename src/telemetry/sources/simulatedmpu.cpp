@@ -0,0 +1,106 @@
+#include "simulatedmpu.h"
+
+#if ROBOT_PLATFORM == ROBOT_PLATFORM_PC
+
+#include <robotcontext.h>
+#include <simulation/plant.h>
+#include "../types.h"
+#include "../events.h"
+#include "../telemetry.h"
+
+using namespace std::literals;
+
+namespace Robot::Telemetry {
+
+static const std::string_view SOURCE_NAME { "mpu" };
+
+static constexpr auto TELEMETRY_INTERVAL { 200ms };
+
+
+SimulatedMPU::SimulatedMPU(const std::shared_ptr<Robot::Context> &context) :
+    AbstractSource { SOURCE_NAME },
+    WithStrand { context->io() },
+    m_initialized { false },
+    m_context { context },
+    m_timer { context->io() },
+    m_generation { 0u },
+    m_events { SOURCE_NAME }
+{
+}
+
+
+SimulatedMPU::~SimulatedMPU()
+{
+    cleanup();
+}
+
+
+void SimulatedMPU::init(const std::shared_ptr<Telemetry> &telemetry)
+{
+    AbstractSource::init(telemetry);
+    m_initialized = true;
+}
+
+
+void SimulatedMPU::cleanup()
+{
+    if (!m_initialized)
+        return;
+    m_initialized = false;
+
+    m_timer.cancel();
+    AbstractSource::cleanup();
+}
+
+
+void SimulatedMPU::start()
+{
+    dispatch([this]{
+        m_timer.expires_after(0s);
+        timer_setup(++m_generation);
+    });
+}
+
+
+void SimulatedMPU::stop()
+{
+    dispatch([this]{
+        m_generation++;
+        m_timer.cancel();
+    });
+}
+
+
+inline void SimulatedMPU::timer()
+{
+    auto plant = m_context->plant();
+    if (!plant)
+        return;
+    if (auto event = m_events.acquire()) {
+        auto imu = plant->imu();
+        event->pitch = imu.pitch;
+        event->roll = imu.roll;
+        event->yaw = imu.yaw;
+        sendEvent(event);
+    }
+}
+
+
+void SimulatedMPU::timer_setup(uint generation)
+{
+    m_timer.expires_at(m_timer.expiry() + TELEMETRY_INTERVAL);
+    m_timer.async_wait(boost::asio::bind_executor(m_strand,
+        [this,generation](boost::system::error_code error) {
+            if (error!=boost::system::errc::success || !m_initialized || generation!=m_generation) {
+                return;
+            }
+            timer();
+            timer_setup(generation);
+        }
+    ));
+}
+
+
+}
+
+#endif
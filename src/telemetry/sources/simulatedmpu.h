@@ -0,0 +1,51 @@
+#ifndef _ROBOT_TELEMETRY_SIMULATEDMPU_H_
+#define _ROBOT_TELEMETRY_SIMULATEDMPU_H_
+
+#include <memory>
+#include <chrono>
+#include <boost/asio.hpp>
+
+#include <robotconfig.h>
+
+#if ROBOT_PLATFORM == ROBOT_PLATFORM_PC
+
+#include <common/withstrand.h>
+#include "abstracttelemetrysource.h"
+#include "../types.h"
+#include "../eventpool.h"
+
+namespace Robot::Telemetry {
+
+    /**
+     * Publishes the body attitude of the simulated plant as the "mpu" source.
+     */
+    class SimulatedMPU : public AbstractSource<SimulatedMPU>, public WithStrand {
+        public:
+            explicit SimulatedMPU(const std::shared_ptr<::Robot::Context> &context);
+            SimulatedMPU(const SimulatedMPU&) = delete; // No copy constructor
+            SimulatedMPU(SimulatedMPU&&) = delete; // No move constructor
+            virtual ~SimulatedMPU();
+
+            void init(const std::shared_ptr<Telemetry> &telemetry);
+            void cleanup();
+
+        protected:
+            void start() override;
+            void stop() override;
+
+        private:
+            bool m_initialized;
+            std::shared_ptr<::Robot::Context> m_context;
+            boost::asio::steady_timer m_timer;
+            uint m_generation; // Incremented on the strand when started/stopped
+
+            EventPool<EventIMU> m_events;
+
+            inline void timer();
+            void timer_setup(uint generation);
+    };
+
+}
+
+#endif
+#endif
@@ -0,0 +1,262 @@
+#include "systemhealth.h"
+
+#include <fstream>
+#include <sstream>
+#include <unistd.h>
+#include <boost/log/trivial.hpp>
+
+#include <robotconfig.h>
+#include <robotcontext.h>
+#include "../types.h"
+#include "../events.h"
+#include "../telemetry.h"
+
+using namespace std::literals;
+
+namespace Robot::Telemetry {
+
+static constexpr auto DEFAULT_INTERVAL_MS { 1000 };
+static constexpr auto MIN_INTERVAL_MS { 100 };
+static const std::string SOURCE_NAME { "system" };
+
+static const std::string PROC_SELF_STAT { "/proc/self/stat" };
+static const std::string PROC_SELF_STATM { "/proc/self/statm" };
+static const std::string PROC_LOADAVG { "/proc/loadavg" };
+static const std::string THERMAL_ZONE_TEMP { "/sys/class/thermal/thermal_zone0/temp" };
+
+
+/**
+ * Split the fields following the command name of a procfs stat line.
+ * The command name may contain spaces, so parsing starts after the last ')'.
+ * The returned stream is positioned at field 3 (state).
+ */
+static bool openStat(const std::string &path, std::istringstream &fields)
+{
+    std::ifstream file { path };
+    std::string line;
+    if (!std::getline(file, line)) {
+        return false;
+    }
+    auto pos = line.rfind(')');
+    if (pos==std::string::npos) {
+        return false;
+    }
+    fields.str(line.substr(pos+1));
+    return true;
+}
+
+
+static bool readStatFields(const std::string &path, uint first, uint count, std::uint64_t *values)
+{
+    std::istringstream fields;
+    if (!openStat(path, fields)) {
+        return false;
+    }
+    std::string skip;
+    for (auto field=3u; field<first; field++) {
+        fields >> skip;
+    }
+    for (auto i=0u; i<count; i++) {
+        fields >> values[i];
+    }
+    return !fields.fail();
+}
+
+
+static bool readContextSwitches(const std::string &path, std::uint64_t &voluntary, std::uint64_t &involuntary)
+{
+    static const std::string VOLUNTARY { "voluntary_ctxt_switches:" };
+    static const std::string INVOLUNTARY { "nonvoluntary_ctxt_switches:" };
+
+    std::ifstream file { path };
+    std::string key;
+    auto found = 0u;
+    while (file >> key) {
+        if (key==VOLUNTARY) {
+            file >> voluntary;
+            found++;
+        }
+        else if (key==INVOLUNTARY) {
+            file >> involuntary;
+            found++;
+        }
+    }
+    return found==2;
+}
+
+
+SystemHealth::SystemHealth(const std::shared_ptr<Robot::Context> &context) :
+    AbstractSource { SOURCE_NAME },
+    WithStrand { context->io() },
+    m_initialized { false },
+    m_context { context },
+    m_timer { context->io() },
+    m_generation { 0u },
+    m_interval { DEFAULT_INTERVAL_MS },
+    m_ticks_per_second { sysconf(_SC_CLK_TCK) },
+    m_last_minflt { 0u },
+    m_last_majflt { 0u },
+    m_events { SOURCE_NAME }
+{
+    PropertyMap values;
+    values.put(PROPERTY_INTERVAL, DEFAULT_INTERVAL_MS);
+    context->registerProperties(PROPERTY_GROUP, values);
+}
+
+
+SystemHealth::~SystemHealth()
+{
+    cleanup();
+}
+
+
+void SystemHealth::init(const std::shared_ptr<Telemetry> &telemetry)
+{
+    AbstractSource::init(telemetry);
+
+    m_initialized = true;
+
+    const auto &properties = m_context->properties(PROPERTY_GROUP);
+    m_interval = std::chrono::milliseconds(std::max(MIN_INTERVAL_MS, properties.get(PROPERTY_INTERVAL, DEFAULT_INTERVAL_MS)));
+    if (m_ticks_per_second<=0) {
+        m_ticks_per_second = 100;
+    }
+}
+
+
+void SystemHealth::cleanup()
+{
+    if (!m_initialized)
+        return;
+    m_initialized = false;
+
+    m_timer.cancel();
+    AbstractSource::cleanup();
+}
+
+
+void SystemHealth::start()
+{
+    dispatch([this]{
+        m_last_threads.clear();
+        m_last_minflt = 0u;
+        m_last_majflt = 0u;
+        m_last_time = clock_type::now();
+
+        m_timer.expires_after(0s);
+        timer_setup(++m_generation);
+    });
+}
+
+
+void SystemHealth::stop()
+{
+    dispatch([this]{
+        m_generation++;
+        m_timer.cancel();
+    });
+}
+
+
+inline void SystemHealth::timer()
+{
+    auto handle = m_events.acquire();
+    if (!handle)
+        return;
+    auto &event = *handle;
+
+    auto now = clock_type::now();
+    auto elapsed = std::chrono::duration<float>(now-m_last_time).count();
+    bool first = m_last_threads.empty();
+    m_last_time = now;
+
+    // Per thread CPU time and scheduling
+    std::unordered_map<pid_t, ThreadSample> threads;
+    std::uint64_t ctx_voluntary = 0u;
+    std::uint64_t ctx_involuntary = 0u;
+    for (auto tid : m_context->threadIds()) {
+        if (event.thread_count>=event.thread_cpu.size()) {
+            break;
+        }
+        const auto base = "/proc/self/task/"s + std::to_string(tid);
+        std::uint64_t times[2];
+        ThreadSample sample { 0u, 0u, 0u };
+        if (!readStatFields(base+"/stat", 14, 2, times) || !readContextSwitches(base+"/status", sample.ctx_voluntary, sample.ctx_involuntary)) {
+            continue;
+        }
+        sample.ticks = times[0] + times[1];
+
+        float cpu = 0.0f;
+        if (auto last = m_last_threads.find(tid); last!=m_last_threads.end()) {
+            if (elapsed>0.0f) {
+                cpu = (sample.ticks-last->second.ticks) / (elapsed*m_ticks_per_second);
+            }
+            ctx_voluntary += sample.ctx_voluntary-last->second.ctx_voluntary;
+            ctx_involuntary += sample.ctx_involuntary-last->second.ctx_involuntary;
+        }
+        event.thread_cpu[event.thread_count++] = cpu;
+        event.cpu += cpu;
+        threads.emplace(tid, sample);
+    }
+    m_last_threads.swap(threads);
+
+    if (elapsed>0.0f && !first) {
+        event.context_switches = ctx_voluntary / elapsed;
+        event.context_switches_involuntary = ctx_involuntary / elapsed;
+    }
+
+    // Process page faults (fields 10 minflt and 12 majflt)
+    std::uint64_t faults[3];
+    if (readStatFields(PROC_SELF_STAT, 10, 3, faults)) {
+        if (elapsed>0.0f && !first) {
+            event.minor_faults = (faults[0]-m_last_minflt) / elapsed;
+            event.major_faults = (faults[2]-m_last_majflt) / elapsed;
+        }
+        m_last_minflt = faults[0];
+        m_last_majflt = faults[2];
+    }
+
+    // Resident memory
+    {
+        std::ifstream file { PROC_SELF_STATM };
+        std::uint64_t size, resident;
+        if (file >> size >> resident) {
+            event.rss_kb = resident * (sysconf(_SC_PAGESIZE)/1024);
+        }
+    }
+
+    // SoC temperature (millidegrees)
+    {
+        std::ifstream file { THERMAL_ZONE_TEMP };
+        std::int64_t temp;
+        if (file >> temp) {
+            event.temperature = temp / 1000.0f;
+        }
+    }
+
+    // Load average
+    {
+        std::ifstream file { PROC_LOADAVG };
+        file >> event.load[0] >> event.load[1] >> event.load[2];
+    }
+
+    sendEvent(handle);
+}
+
+
+void SystemHealth::timer_setup(uint generation)
+{
+    m_timer.expires_at(m_timer.expiry() + m_interval);
+    m_timer.async_wait(boost::asio::bind_executor(m_strand,
+        [this,generation](boost::system::error_code error) {
+            if (error!=boost::system::errc::success || !m_initialized || generation!=m_generation) {
+                return;
+            }
+            timer();
+            timer_setup(generation);
+        }
+    ));
+}
+
+
+}
@@ -0,0 +1,69 @@
+#ifndef _ROBOT_TELEMETRY_SYSTEMHEALTH_H_
+#define _ROBOT_TELEMETRY_SYSTEMHEALTH_H_
+
+#include <memory>
+#include <chrono>
+#include <string>
+#include <unordered_map>
+#include <boost/asio.hpp>
+
+#include <common/withstrand.h>
+#include "abstracttelemetrysource.h"
+#include "../types.h"
+#include "../eventpool.h"
+
+namespace Robot::Telemetry {
+
+    /**
+     * Samples process and host health from procfs/sysfs.
+     *
+     * CPU time and context switches are read per thread of the context pool,
+     * so a starved or saturated pool thread shows up directly.
+     */
+    class SystemHealth : public AbstractSource<SystemHealth>, public WithStrand {
+        public:
+            inline static const std::string PROPERTY_GROUP { "system" };
+            inline static const std::string PROPERTY_INTERVAL { "interval_ms" };
+
+            explicit SystemHealth(const std::shared_ptr<::Robot::Context> &context);
+            SystemHealth(const SystemHealth&) = delete; // No copy constructor
+            SystemHealth(SystemHealth&&) = delete; // No move constructor
+            virtual ~SystemHealth();
+
+            void init(const std::shared_ptr<Telemetry> &telemetry);
+            void cleanup();
+
+        protected:
+            void start() override;
+            void stop() override;
+
+        private:
+            using clock_type = std::chrono::steady_clock;
+
+            struct ThreadSample {
+                std::uint64_t ticks;
+                std::uint64_t ctx_voluntary;
+                std::uint64_t ctx_involuntary;
+            };
+
+            bool m_initialized;
+            std::shared_ptr<::Robot::Context> m_context;
+            boost::asio::steady_timer m_timer;
+            uint m_generation; // Incremented on the strand when started/stopped
+            std::chrono::milliseconds m_interval;
+            long m_ticks_per_second;
+
+            clock_type::time_point m_last_time;
+            std::unordered_map<pid_t, ThreadSample> m_last_threads;
+            std::uint64_t m_last_minflt;
+            std::uint64_t m_last_majflt;
+
+            EventPool<EventSystem> m_events;
+
+            inline void timer();
+            void timer_setup(uint generation);
+    };
+
+}
+
+#endif
@@ -1,6 +1,7 @@
 #include "telemetry.h"
 
 #include <typeinfo>
+#include <algorithm>
 #include <boost/log/trivial.hpp>
 
 #include <robotconfig.h>
@@ -15,10 +16,49 @@ namespace Robot::Telemetry {
 
 static constexpr auto TELEMETRY_HISTORY_INTERVAL { 50ms };
 
+// History series and the source feeding them
+static const std::unordered_map<std::string, std::string> HISTORY_SERIES {
+    { "history_imu", "mpu" },
+    { "history_motor_duty", "motors" },
+    { "history_motor_rpm", "motors" },
+    { "history_system", "system" },
+};
+
+
+Activation::Activation(const std::shared_ptr<Telemetry> &telemetry, const std::string &name) :
+    m_telemetry { telemetry },
+    m_name { name },
+    m_released { false }
+{
+}
+
+
+Activation::~Activation()
+{
+    release();
+}
+
+
+void Activation::release()
+{
+    if (m_released)
+        return;
+    m_released = true;
+
+    if (auto telemetry = m_telemetry.lock()) {
+        telemetry->release(m_name);
+    }
+}
+
+
 
 Telemetry::Telemetry(const std::shared_ptr<Robot::Context> &context) :
     WithStrand { context->io() },
     m_initialized { false },
+    m_history_refs { 0u },
+    m_history_generation { 0u },
+    m_events_counter { Metrics::registry().counter("robot_telemetry_events", "Telemetry events processed") },
+    m_history_lateness { Metrics::registry().histogram("robot_telemetry_history_lateness_seconds", "Delay from history timer expiry until the sample was taken") },
     m_timer { context->io() }
 {
 
@@ -40,6 +80,14 @@ void Telemetry::init()
     }
     m_initialized = true;
 
+    // Start safety sources and anything acquired before init
+    for (auto &source : m_sources) {
+        if (source->alwaysOn() || m_refs[source->name()]>0) {
+            source->start();
+            source->m_active = true;
+        }
+    }
+
     // Init IMU map
     m_imu_event.update(m_imu_values);
 
@@ -47,12 +95,15 @@ void Telemetry::init()
         EventOdometer ev;
         ev.update(m_odometer_values);
     }
+    m_system_event.update(m_system_values);
 
     resetHistory();
 
-    m_timer.expires_after(TELEMETRY_HISTORY_INTERVAL);
-    m_base_history = m_timer.expiry();
-    timerSetup();
+    m_base_history = history_clock_type::now() + TELEMETRY_HISTORY_INTERVAL;
+    m_last_history = m_base_history;
+    if (m_history_refs>0) {
+        historyStart();
+    }
 }
 
 
@@ -64,9 +115,13 @@ void Telemetry::cleanup()
         return;
     m_initialized = false;
     
-    m_timer.cancel();
+    historyStop();
 
     for (auto &source : m_sources) {
+        if (source->m_active) {
+            source->stop();
+            source->m_active = false;
+        }
         source->cleanup();
     }
 }
@@ -85,6 +140,10 @@ void Telemetry::resetHistory()
     m_history_motor_rpm.values[0].fill(0.0f);
     m_history_motor_rpm.values.fill(m_history_motor_rpm.values[0]);
     m_history_motor_rpm.head = 0;
+
+    m_history_system.values[0].fill(0.0f);
+    m_history_system.values.fill(m_history_system.values[0]);
+    m_history_system.head = 0;
 }
 
 
@@ -95,28 +154,198 @@ void Telemetry::addSource(std::shared_ptr<class Source> source)
 }
 
 
+std::shared_ptr<Activation> Telemetry::acquire(const std::string &name)
+{
+    {
+        const guard lock(m_mutex);
+        acquireLocked(name);
+    }
+    return std::make_shared<Activation>(shared_from_this(), name);
+}
+
+
+void Telemetry::release(const std::string &name)
+{
+    const guard lock(m_mutex);
+    releaseLocked(name);
+}
+
+
+bool Telemetry::active(const std::string &name) const
+{
+    const guard lock(m_mutex);
+    if (auto it = m_refs.find(name); it!=m_refs.end() && it->second>0) {
+        return true;
+    }
+    return std::any_of(m_sources.begin(), m_sources.end(), [&name](const auto &source) { 
+        return source->name()==name && source->m_active; 
+    });
+}
+
+
+void Telemetry::acquireLocked(const std::string &name)
+{
+    if (m_refs[name]++>0) 
+        return;
+
+    if (auto series = HISTORY_SERIES.find(name); series!=HISTORY_SERIES.end()) {
+        acquireLocked(series->second);
+        if (m_history_refs++==0 && m_initialized) {
+            historyStart();
+        }
+    }
+    else if (m_initialized) {
+        startSources(name);
+    }
+}
+
+
+void Telemetry::releaseLocked(const std::string &name)
+{
+    auto it = m_refs.find(name);
+    if (it==m_refs.end() || it->second==0) {
+        BOOST_LOG_TRIVIAL(warning) << "Telemetry source " << name << " released more times than acquired";
+        return;
+    }
+    if (--it->second>0)
+        return;
+
+    if (auto series = HISTORY_SERIES.find(name); series!=HISTORY_SERIES.end()) {
+        if (--m_history_refs==0) {
+            historyStop();
+        }
+        releaseLocked(series->second);
+    }
+    else if (m_initialized) {
+        stopSources(name);
+    }
+}
+
+
+void Telemetry::startSources(const std::string &name)
+{
+    for (auto &source : m_sources) {
+        if (source->name()==name && !source->m_active) {
+            BOOST_LOG_TRIVIAL(info) << "Starting telemetry source " << name;
+            source->start();
+            source->m_active = true;
+        }
+    }
+}
+
+
+void Telemetry::stopSources(const std::string &name)
+{
+    for (auto &source : m_sources) {
+        if (source->name()==name && source->m_active && !source->alwaysOn()) {
+            BOOST_LOG_TRIVIAL(info) << "Parking telemetry source " << name;
+            source->stop();
+            source->m_active = false;
+        }
+    }
+}
+
+
 void Telemetry::process(const Event &event) 
 {
-    if (const auto ev = dynamic_cast<const Robot::Telemetry::EventIMU*>(&event)) {
-        dispatch([this, evt=*ev]{
+    switch (event.type) {
+        case Event::Type::IMU:
+            dispatch([this, evt=static_cast<const EventIMU&>(event)]{ apply(evt); });
+            break;
+        case Event::Type::ODOMETER:
+            dispatch([this, evt=static_cast<const EventOdometer&>(event)]{ apply(evt); });
+            break;
+        case Event::Type::MOTORS:
+            dispatch([this, evt=static_cast<const EventMotors&>(event)]{ apply(evt); });
+            break;
+        case Event::Type::SYSTEM:
+            dispatch([this, evt=static_cast<const EventSystem&>(event)]{ apply(evt); });
+            break;
+        case Event::Type::PERF:
+            dispatch([this, evt=static_cast<const EventPerf&>(event)]{ apply(evt); });
+            break;
+        case Event::Type::AUTOTUNE:
+            dispatch([this, evt=static_cast<const EventAutotune&>(event)]{ apply(evt); });
+            break;
+        case Event::Type::TRACTION:
+            dispatch([this, evt=static_cast<const EventTraction&>(event)]{ apply(evt); });
+            break;
+        default:
+            break;
+    }
+
+    m_events_counter->inc();
+    sig_event(event);
+}
+
+
+void Telemetry::process(const EventRef &event)
+{
+    switch (event->type) {
+        case Event::Type::IMU:
+        case Event::Type::ODOMETER:
+        case Event::Type::MOTORS:
+        case Event::Type::SYSTEM:
+        case Event::Type::PERF:
+        case Event::Type::AUTOTUNE:
+        case Event::Type::TRACTION:
+            // Only the handle is captured, the event stays in the source pool
+            dispatch([this, event]{ apply(*event); });
+            break;
+        default:
+            break;
+    }
+
+    m_events_counter->inc();
+    sig_event(*event);
+}
+
+
+void Telemetry::apply(const Event &event)
+{
+    switch (event.type) {
+        case Event::Type::IMU: {
+            const auto &evt = static_cast<const EventIMU&>(event);
             evt.update(m_imu_values);
             m_imu_event = evt;
             notify(NOTIFY_IMU);
-        });
-    }
-    else if (const auto ev = dynamic_cast<const Robot::Telemetry::EventOdometer*>(&event)) {
-        dispatch([this, evt=*ev]{
+            break;
+        }
+        case Event::Type::ODOMETER: {
+            const auto &evt = static_cast<const EventOdometer&>(event);
             evt.update(m_odometer_values);
             notify(NOTIFY_ODOMETER);
-        });
-    }
-    else if (const auto ev = dynamic_cast<const Robot::Telemetry::EventMotors*>(&event)) {
-        dispatch([this, evt=*ev]{
-            m_motors_event = evt;
-        });
+            break;
+        }
+        case Event::Type::MOTORS: {
+            m_motors_event = static_cast<const EventMotors&>(event);
+            break;
+        }
+        case Event::Type::SYSTEM: {
+            const auto &evt = static_cast<const EventSystem&>(event);
+            evt.update(m_system_values);
+            m_system_event = evt;
+            notify(NOTIFY_SYSTEM);
+            break;
+        }
+        case Event::Type::PERF: {
+            static_cast<const EventPerf&>(event).update(m_perf_values);
+            notify(NOTIFY_PERF);
+            break;
+        }
+        case Event::Type::AUTOTUNE: {
+            static_cast<const EventAutotune&>(event).update(m_autotune_values);
+            notify(NOTIFY_AUTOTUNE);
+            break;
+        }
+        case Event::Type::TRACTION: {
+            static_cast<const EventTraction&>(event).update(m_traction_values);
+            notify(NOTIFY_TRACTION);
+            break;
+        }
+        default:
+            break;
     }
-
-    sig_event(event);
 }
 
 #if ROBOT_HAVE_IMU
@@ -140,14 +369,35 @@ std::int64_t Telemetry::historyIntervalMS() const
 }
 
 
-void Telemetry::timerSetup() 
+void Telemetry::historyStart()
+{
+    auto generation = ++m_history_generation;
+    dispatch([this]{ resetHistory(); });
+
+    // Keep the timer phase aligned with the history base time
+    auto now = history_clock_type::now();
+    auto ticks = (now-m_base_history) / TELEMETRY_HISTORY_INTERVAL;
+    m_timer.expires_at(m_base_history + std::max<decltype(ticks)>(ticks, 0)*TELEMETRY_HISTORY_INTERVAL);
+    timerSetup(generation);
+}
+
+
+void Telemetry::historyStop()
+{
+    ++m_history_generation;
+    m_timer.cancel();
+}
+
+
+void Telemetry::timerSetup(uint generation) 
 {
     m_timer.expires_at(m_timer.expiry() + TELEMETRY_HISTORY_INTERVAL);
     m_timer.async_wait(boost::asio::bind_executor(m_strand, 
-        [this] (boost::system::error_code error) {
-            if (error!=boost::system::errc::success) {
+        [this,generation] (boost::system::error_code error) {
+            if (error!=boost::system::errc::success || generation!=m_history_generation) {
                 return;
             }
+            m_history_lateness->observe(history_clock_type::now() - m_timer.expiry());
 
             // TODO Find a better way of handling telemetry history
 
@@ -179,8 +429,16 @@ void Telemetry::timerSetup()
                 }
             }
 
+            { // System
+                auto &current = m_history_system.next();
+                current[0] = m_system_event.cpu;
+                current[1] = m_system_event.temperature;
+                current[2] = m_system_event.load[0];
+                current[3] = m_system_event.context_switches + m_system_event.context_switches_involuntary;
+            }
+
             m_last_history = m_timer.expiry();
-            timerSetup();
+            timerSetup(generation);
         }
     ));
 }
@@ -2,6 +2,7 @@
 #define _ROBOT_TELEMETRY_TELEMETRY_H_
 
 #include <cstdint>
+#include <atomic>
 #include <memory>
 #include <mutex>
 #include <map>
@@ -18,10 +19,33 @@
 #include <common/withstrand.h>
 #include "types.h"
 #include "events.h"
+#include "eventpool.h"
 #include "history.h"
 
 namespace Robot::Telemetry {
 
+    /**
+     * @brief Handle keeping a telemetry source or history series active
+     * 
+     * The source is released when the handle is destroyed or release() is called.
+     */
+    class Activation {
+        public:
+            Activation(const std::shared_ptr<class Telemetry> &telemetry, const std::string &name);
+            Activation(const Activation&) = delete; // No copy constructor
+            Activation(Activation&&) = delete; // No move constructor
+            ~Activation();
+
+            const std::string &name() const { return m_name; }
+            void release();
+
+        private:
+            std::weak_ptr<class Telemetry> m_telemetry;
+            const std::string m_name;
+            bool m_released;
+    };
+
+
     class Telemetry : public std::enable_shared_from_this<Telemetry>, public WithMutexStd, public WithNotifyInt, public WithStrand {
         public:
             using history_timer_type = boost::asio::high_resolution_timer;
@@ -29,6 +53,10 @@ namespace Robot::Telemetry {
 
             static constexpr notify_type NOTIFY_IMU { 1 };
             static constexpr notify_type NOTIFY_ODOMETER { 2 };
+            static constexpr notify_type NOTIFY_SYSTEM { 3 };
+            static constexpr notify_type NOTIFY_PERF { 4 };
+            static constexpr notify_type NOTIFY_AUTOTUNE { 5 };
+            static constexpr notify_type NOTIFY_TRACTION { 6 };
 
             explicit Telemetry(const std::shared_ptr<::Robot::Context> &context);
             Telemetry(const Telemetry&) = delete; // No copy constructor
@@ -40,25 +68,48 @@ namespace Robot::Telemetry {
 
             Signal sig_event;
             #if ROBOT_HAVE_IMU
-            IMUSignal sig_imu;
+            IMUSignal sig_imu; ///< Emitted in the MPU interrupt thread, slots must not block
             #endif
 
             const ValueMap &imuValues() const { return m_imu_values; }
             const ValueMap &odometerValues() const { return m_odometer_values; }
+            const ValueMap &systemValues() const { return m_system_values; }
+            const ValueMap &perfValues() const { return m_perf_values; }
+            const ValueMap &autotuneValues() const { return m_autotune_values; }
+            const ValueMap &tractionValues() const { return m_traction_values; }
 
             const HistoryIMU &historyIMU() const { return m_history_imu; }
             const HistoryMotorDuty &historyMotorDuty() const { return m_history_motor_duty; }
             const HistoryMotorRPM &historyMotorRPM() const { return m_history_motor_rpm; }
+            const HistorySystem &historySystem() const { return m_history_system; }
 
             std::int64_t historyLastMS() const;
             std::int64_t historyIntervalMS() const;
 
             void addSource(std::shared_ptr<class Source> source);
 
+            /**
+             * @brief Acquire a telemetry source or history series
+             * 
+             * Sources are started when the first activation is acquired and stopped 
+             * when the last one is released. Names starting with "history_" select a
+             * history series, which keeps the history timer and the sources feeding 
+             * it running.
+             * 
+             * @param name Source name (ex. "mpu", "motors") or history series (ex. "history_imu")
+             * @return std::shared_ptr<Activation> Handle keeping the source active
+             */
+            std::shared_ptr<Activation> acquire(const std::string &name);
+            bool active(const std::string &name) const;
+
         protected:
             friend class Source;
+            friend class Activation;
+
+            void release(const std::string &name);
             
             void process(const Event &event);
+            void process(const EventRef &event);
 
             #if ROBOT_HAVE_IMU
             void process(const IMUData &data);
@@ -67,9 +118,19 @@ namespace Robot::Telemetry {
         private:
             bool m_initialized;
             std::vector<std::shared_ptr<class Source>> m_sources;
+            std::unordered_map<std::string, uint> m_refs;
+            uint m_history_refs;
+            std::atomic<uint> m_history_generation;
+
+            std::shared_ptr<Metrics::Counter> m_events_counter;
+            std::shared_ptr<Metrics::Histogram> m_history_lateness;
 
             ValueMap m_imu_values;
             ValueMap m_odometer_values;
+            ValueMap m_system_values;
+            ValueMap m_perf_values;
+            ValueMap m_autotune_values;
+            ValueMap m_traction_values;
 
             EventIMU m_imu_event;
             HistoryIMU m_history_imu;
@@ -78,13 +139,24 @@ namespace Robot::Telemetry {
             HistoryMotorDuty m_history_motor_duty;
             HistoryMotorRPM m_history_motor_rpm;
 
+            EventSystem m_system_event;
+            HistorySystem m_history_system;
+
             history_clock_type::time_point m_base_history;
             history_clock_type::time_point m_last_history;
             history_timer_type m_timer;
 
+            void apply(const Event &event);
             void resetHistory();
 
-            void timerSetup();
+            void acquireLocked(const std::string &name);
+            void releaseLocked(const std::string &name);
+            void startSources(const std::string &name);
+            void stopSources(const std::string &name);
+
+            void historyStart();
+            void historyStop();
+            void timerSetup(uint generation);
 
     };
         
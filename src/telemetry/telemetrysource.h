@@ -2,6 +2,8 @@
 #define _ROBOT_TELEMETRY_SOURCE_H_
 
 #include <memory>
+#include <string>
+#include <string_view>
 
 #include "types.h"
 #include "telemetry.h"
@@ -10,9 +12,22 @@ namespace Robot::Telemetry {
 
     class Source {
         public:
-            Source() {}
+            /**
+             * @brief Construct source
+             * 
+             * @param name Name used when acquiring the source through Telemetry::acquire
+             * @param always_on Source is started with telemetry and never parked (safety sources)
+             */
+            explicit Source(const std::string_view &name, bool always_on = false) :
+                m_name { name },
+                m_always_on { always_on },
+                m_active { false }
+            {}
             virtual ~Source() = default;
 
+            const std::string &name() const { return m_name; }
+            bool alwaysOn() const { return m_always_on; }
+
             virtual void init(const std::shared_ptr<Telemetry> &telemetry) 
             {
                 m_telemetry = telemetry;
@@ -25,6 +40,16 @@ namespace Robot::Telemetry {
             friend class Telemetry;
             std::weak_ptr<Telemetry> m_telemetry;
 
+            /**
+             * @brief Called when the first consumer acquires the source
+             */
+            virtual void start() {}
+
+            /**
+             * @brief Called when the last consumer releases the source
+             */
+            virtual void stop() {}
+
             void sendEvent(const Event &event)
             {
                 if (auto telemetry = m_telemetry.lock()) {
@@ -36,14 +61,30 @@ namespace Robot::Telemetry {
                 telemetry->process(event);
             }
 
+            void sendEvent(const EventRef &event)
+            {
+                if (auto telemetry = m_telemetry.lock()) {
+                    sendEvent(telemetry, event);
+                }
+            }
+            static void sendEvent(const std::shared_ptr<Telemetry> &telemetry, const EventRef &event)
+            {
+                telemetry->process(event);
+            }
+
             #if ROBOT_HAVE_IMU
             static void sendData(const std::shared_ptr<Telemetry> &telemetry, const IMUData &data)
             {
                 telemetry->process(data);
             }
             #endif
+
+        private:
+            const std::string m_name;
+            const bool m_always_on;
+            bool m_active;
     };
 
 }
 
-#endif
\ No newline at end of file
+#endif
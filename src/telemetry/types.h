@@ -27,7 +27,7 @@ namespace Robot::Telemetry {
     #endif
 
     using Value = std::variant<std::string, bool, double, float, std::uint32_t, std::int32_t>;
-    using ValueMap = std::map<std::string, Value>;
+    using ValueMap = std::map<std::string, Value, std::less<>>;
 
 }
 
@@ -0,0 +1,647 @@
+#define BOOST_TEST_MODULE Kinematic
+#include <boost/test/included/unit_test.hpp>
+
+#include <cmath>
+#include <array>
+#include <thread>
+#include <atomic>
+#include <chrono>
+#include <future>
+#include <random>
+#include <sstream>
+#include <fstream>
+#include <filesystem>
+
+#include <robotcontext.h>
+#include <robotlogging.h>
+#include <motor/control.h>
+#include <motor/motor.h>
+#include <motor/servo.h>
+#include <led/control.h>
+#include <input/control.h>
+#include <input/softwareinterface.h>
+#include <kinematic/kinematic.h>
+#include <kinematic/mixer.h>
+#include <kinematic/ackermann.h>
+#include <kinematic/path.h>
+#include <kinematic/trajectory.h>
+#include <telemetry/telemetry.h>
+#include <simulation/plant.h>
+#include <metrics/metrics.h>
+
+using namespace std::literals;
+using Robot::Kinematic::DriveMode;
+using Robot::Kinematic::ThrottleMode;
+using Robot::Kinematic::Orientation;
+using Robot::Kinematic::ChassisCommand;
+using Robot::Kinematic::Path;
+using Robot::Kinematic::PurePursuit;
+using Robot::Kinematic::Point;
+using Robot::Kinematic::Pose;
+using Robot::Value;
+using Robot::Motor::Motor;
+
+static Robot::Logging::LogInit __log_init { boost::log::trivial::warning };
+
+
+/**
+ * Kinematic driving the simulated plant through the manual input
+ */
+struct Rig {
+    std::shared_ptr<Robot::Context> context;
+    std::shared_ptr<Robot::Motor::Control> motor_control;
+    std::shared_ptr<Robot::LED::Control> led_control;
+    std::shared_ptr<Robot::Input::Control> input;
+    std::shared_ptr<Robot::Telemetry::Telemetry> telemetry;
+    std::shared_ptr<Robot::Kinematic::Kinematic> kinematic;
+
+    Rig() :
+        context { std::make_shared<Robot::Context>() },
+        motor_control { std::make_shared<Robot::Motor::Control>(context) },
+        led_control { std::make_shared<Robot::LED::Control>(context) },
+        input { std::make_shared<Robot::Input::Control>(context) },
+        telemetry { std::make_shared<Robot::Telemetry::Telemetry>(context) },
+        kinematic { std::make_shared<Robot::Kinematic::Kinematic>(context) }
+    {
+        context->init();
+        telemetry->init();
+        motor_control->init();
+        input->init(nullptr);
+        led_control->init(input);
+        kinematic->init(motor_control, led_control, telemetry, input);
+        context->start();
+    }
+
+    ~Rig()
+    {
+        context->stop();
+        kinematic->cleanup();
+        input->cleanup();
+        led_control->cleanup();
+        motor_control->cleanup();
+        telemetry->cleanup();
+        context->cleanup();
+    }
+
+    const std::unique_ptr<Motor> &motor(uint index) const { return motor_control->getMotors()[index]; }
+};
+
+
+
+BOOST_AUTO_TEST_SUITE(throttle_suite)
+
+BOOST_AUTO_TEST_CASE(DutyMode)
+{
+    Rig rig;
+    rig.kinematic->setDriveMode(DriveMode::ALL_WHEEL);
+    std::this_thread::sleep_for(100ms);
+
+    rig.input->manual()->setAxis(0.0f, 0.5f);
+    std::this_thread::sleep_for(100ms);
+    for (auto i=0u; i<Robot::Motor::MOTOR_COUNT; i++) {
+        BOOST_TEST((rig.motor(i)->getMode()==Motor::Mode::DUTY));
+        // Right hand motors are mirrored
+        BOOST_TEST(std::abs(rig.motor(i)->getDuty()) == 0.5f);
+    }
+}
+
+
+BOOST_AUTO_TEST_CASE(RPMMode)
+{
+    Rig rig;
+    rig.kinematic->setDriveMode(DriveMode::ALL_WHEEL);
+    rig.kinematic->setThrottleMode(ThrottleMode::RPM);
+    std::this_thread::sleep_for(100ms);
+
+    // Turning right, the left wheels are on the outer circle
+    rig.input->manual()->setAxis(0.5f, 0.5f);
+    std::this_thread::sleep_for(100ms);
+    for (auto i=0u; i<Robot::Motor::MOTOR_COUNT; i++) {
+        BOOST_TEST((rig.motor(i)->getMode()==Motor::Mode::RPM));
+    }
+    const auto outer = 0.5f*Robot::Config::WHEEL_MAX_RPM;
+    BOOST_TEST(rig.motor(0)->getTargetRPM() == outer);
+    BOOST_TEST(rig.motor(2)->getTargetRPM() == outer);
+    auto ratio = -rig.motor(1)->getTargetRPM()/outer;
+    BOOST_TEST(ratio > 0.2f);
+    BOOST_TEST(ratio < 1.0f);
+    BOOST_TEST(rig.motor(3)->getTargetRPM() == rig.motor(1)->getTargetRPM());
+
+    // The wheels hold the turning circle speed ratio
+    std::this_thread::sleep_for(1500ms);
+    auto plant = rig.context->plant();
+    BOOST_TEST(plant->wheelRPM(0) == outer, boost::test_tools::tolerance(0.1f));
+    BOOST_TEST(-plant->wheelRPM(1)/plant->wheelRPM(0) == ratio, boost::test_tools::tolerance(0.1f));
+
+    // Back to duty, the last steering is reapplied
+    rig.kinematic->setThrottleMode(ThrottleMode::DUTY);
+    std::this_thread::sleep_for(100ms);
+    BOOST_TEST((rig.motor(0)->getMode()==Motor::Mode::DUTY));
+    BOOST_TEST(rig.motor(0)->getDuty() == 0.5f);
+}
+
+
+BOOST_AUTO_TEST_CASE(SameTick)
+{
+    Rig rig;
+    rig.kinematic->setDriveMode(DriveMode::SKID);
+    rig.kinematic->setThrottleMode(ThrottleMode::RPM);
+    std::this_thread::sleep_for(100ms);
+
+    // Every motor tick sees either none or all of the new targets
+    uint torn = 0u;
+    std::atomic<float> target { 0.0f };
+    boost::signals2::scoped_connection connection = rig.motor_control->sig_motor.connect([&](const auto &motors) {
+        auto count = 0u;
+        for (auto &motor : motors) {
+            if (std::abs(motor->getTargetRPM())==target.load()) {
+                count++;
+            }
+        }
+        if (count!=0u && count!=motors.size()) {
+            torn++;
+        }
+    });
+    for (auto i=0; i<50; i++) {
+        auto throttle = (i%2) ? 0.4f : 0.6f;
+        target = throttle*Robot::Config::WHEEL_MAX_RPM;
+        rig.input->manual()->setAxis(0.0f, throttle);
+        std::this_thread::sleep_for(7ms);
+    }
+    BOOST_TEST(torn == 0u);
+}
+
+
+BOOST_AUTO_TEST_CASE(Coalesce)
+{
+    Rig rig;
+    rig.kinematic->setDriveMode(DriveMode::SKID);
+    std::this_thread::sleep_for(100ms);
+    auto coalesced = Robot::Metrics::registry().counter("robot_kinematic_steer_coalesced", "");
+    const auto before = coalesced->value();
+
+    // Hold the kinematic strand while a burst of commands arrives
+    std::promise<void> release;
+    auto released = release.get_future().share();
+    boost::asio::post(rig.kinematic->strand(), [released]{ released.wait(); });
+    for (auto i=1; i<=100; i++) {
+        rig.input->manual()->setAxis(0.0f, i/200.0f);
+    }
+    release.set_value();
+    std::this_thread::sleep_for(100ms);
+
+    // Only the latest is applied
+    BOOST_TEST(coalesced->value()-before == 99u);
+    BOOST_TEST(rig.motor(0)->getDuty() == 0.5f);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+
+
+BOOST_AUTO_TEST_SUITE(drivemode_suite)
+
+BOOST_AUTO_TEST_CASE(Flip)
+{
+    Rig rig;
+    auto duration = Robot::Metrics::registry().histogram("robot_kinematic_switch_duration_seconds", "");
+    const auto count_before = duration->count();
+    const auto sum_before = duration->sum();
+
+    // Switch on every command, the schemes are reused rather than rebuilt
+    constexpr std::array modes { DriveMode::ALL_WHEEL, DriveMode::FRONT_WHEEL, DriveMode::REAR_WHEEL, DriveMode::SKID, DriveMode::SPINNING, DriveMode::NONE };
+    constexpr auto SWITCHES { 600u };
+    for (auto i=0u; i<SWITCHES; i++) {
+        rig.kinematic->setDriveMode(modes[i%modes.size()]);
+        rig.input->manual()->setAxis(0.2f, 0.3f);
+    }
+    rig.kinematic->setDriveMode(DriveMode::SKID);
+    std::this_thread::sleep_for(100ms);
+
+    const auto switches = duration->count()-count_before;
+    BOOST_TEST(switches == SWITCHES+1);
+    BOOST_TEST((duration->sum()-sum_before)/switches < 0.005);
+
+    // The last activation starts from a clean command
+    BOOST_TEST((rig.kinematic->getDriveMode()==DriveMode::SKID));
+    BOOST_TEST(rig.motor(0)->getDuty() == 0.0f);
+    rig.input->manual()->setAxis(0.0f, 0.5f);
+    std::this_thread::sleep_for(100ms);
+    BOOST_TEST(rig.motor(0)->getDuty() == 0.5f);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+
+
+BOOST_AUTO_TEST_SUITE(mixer_suite)
+
+using namespace Robot::Kinematic;
+using Robot::Config::WHEEL_STRAIGHT_ANGLE;
+
+static constexpr std::array<Orientation, 4> ORIENTATIONS { Orientation::NORTH, Orientation::SOUTH, Orientation::EAST, Orientation::WEST };
+
+/**
+ * The per wheel mapping the mixer tables are folded from
+ */
+static Mixer::Output reference(Orientation orientation, const std::array<float, 4> &angle, const std::array<float, 4> &throttle)
+{
+    MotorMap map;
+    switch (orientation) {
+        case Orientation::NORTH: map = MOTOR_MAP_NORTH; break;
+        case Orientation::SOUTH: map = MOTOR_MAP_SOUTH; break;
+        case Orientation::EAST:  map = MOTOR_MAP_EAST; break;
+        case Orientation::WEST:  map = MOTOR_MAP_WEST; break;
+    }
+    Mixer::Output output;
+    for (auto position=0u; position<map.size(); position++) {
+        const auto &entry = map[position];
+        const auto servo = Value::fromAngle(angle[position]);
+        output.servo[entry.index] = entry.invert ? -servo : servo;
+        output.throttle[entry.index] = entry.invert_duty ? -throttle[position] : throttle[position];
+    }
+    return output;
+}
+
+static bool reversed(Orientation orientation)
+{
+    return orientation==Orientation::SOUTH || orientation==Orientation::EAST;
+}
+
+static void check(const Mixer::Output &output, const Mixer::Output &expected)
+{
+    for (auto i=0u; i<Robot::Motor::MOTOR_COUNT; i++) {
+        BOOST_TEST(std::abs(static_cast<int>(output.servo[i].asServoPulse())-static_cast<int>(expected.servo[i].asServoPulse())) <= 1);
+        BOOST_TEST(output.throttle[i] == expected.throttle[i], boost::test_tools::tolerance(1e-6f));
+    }
+}
+
+
+BOOST_AUTO_TEST_CASE(Straight)
+{
+    const auto skew = 0.2f;
+    const auto left = 0.5f;
+    const auto right = -0.3f;
+    for (auto orientation : ORIENTATIONS) {
+        const auto s = reversed(orientation) ? -skew : skew;
+        const auto S = WHEEL_STRAIGHT_ANGLE;
+        check(MIXER_STRAIGHT.mix(orientation, ChassisCommand { 0.0f, 0.0f, skew, left, right }),
+              reference(orientation, { S-s, S+s, S+s, S-s }, { left, right, left, right }));
+    }
+}
+
+
+BOOST_AUTO_TEST_CASE(Steering)
+{
+    const auto l = 0.3f;
+    const auto r = -0.25f;
+    const auto skew = 0.05f;
+    const ChassisCommand command { l, r, skew, 0.6f, 0.4f };
+    const std::array<float, 4> throttle { 0.6f, 0.4f, 0.6f, 0.4f };
+    for (auto orientation : ORIENTATIONS) {
+        const auto s = reversed(orientation) ? -skew : skew;
+        const auto S = WHEEL_STRAIGHT_ANGLE;
+        check(MIXER_ALL_WHEEL.mix(orientation, command), reference(orientation, { S+l-s, S+r+s, S+l+s, S+r-s }, throttle));
+        check(MIXER_FRONT_WHEEL.mix(orientation, command), reference(orientation, { S+l-s, S+r+s, S+s, S-s }, throttle));
+        check(MIXER_REAR_WHEEL.mix(orientation, command), reference(orientation, { S+s, S-s, S+l-s, S+r+s }, throttle));
+    }
+}
+
+
+BOOST_AUTO_TEST_CASE(Spinning)
+{
+    // The right side is mirrored, all motors end up with the same throttle
+    for (auto orientation : ORIENTATIONS) {
+        auto output = MIXER_SPINNING.mix(orientation, ChassisCommand { 0.0f, 0.0f, 0.0f, 0.7f, -0.7f });
+        for (auto i=0u; i<Robot::Motor::MOTOR_COUNT; i++) {
+            BOOST_TEST(output.throttle[i] == 0.7f);
+            BOOST_TEST((output.servo[i] == Value::CENTER));
+        }
+    }
+}
+
+
+BOOST_AUTO_TEST_CASE(Reversed)
+{
+    // Turning the rover around drives the motors backwards through the same layout
+    Rig rig;
+    rig.kinematic->setDriveMode(DriveMode::SKID);
+    rig.kinematic->setOrientation(Orientation::SOUTH);
+    std::this_thread::sleep_for(100ms);
+
+    rig.input->manual()->setAxis(0.0f, 0.5f);
+    std::this_thread::sleep_for(100ms);
+    const auto expected = reference(Orientation::SOUTH, { WHEEL_STRAIGHT_ANGLE, WHEEL_STRAIGHT_ANGLE, WHEEL_STRAIGHT_ANGLE, WHEEL_STRAIGHT_ANGLE }, { 0.5f, 0.5f, 0.5f, 0.5f });
+    for (auto i=0u; i<Robot::Motor::MOTOR_COUNT; i++) {
+        BOOST_TEST(rig.motor(i)->getDuty() == expected.throttle[i]);
+    }
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+
+
+BOOST_AUTO_TEST_SUITE(ackermann_suite)
+
+using Robot::Kinematic::Ackermann;
+
+BOOST_AUTO_TEST_CASE(Analytic)
+{
+    // Well within a servo step (pi/2000 rad) and the throttle resolution
+    for (const auto *table : { &Robot::Kinematic::ACKERMANN_ALL_WHEEL, &Robot::Kinematic::ACKERMANN_SINGLE_AXLE }) {
+        for (auto i=1; i<=1000; i++) {
+            const auto inner_angle = i*Ackermann::ANGLE_MAX/1000.0f;
+            const auto lookup = table->lookup(inner_angle);
+            const auto analytic = table->analytic(inner_angle);
+            BOOST_TEST(std::abs(lookup.outer_angle-analytic.outer_angle) < 1e-4f);
+            BOOST_TEST(std::abs(lookup.ratio-analytic.ratio) < 2e-4f);
+            BOOST_TEST(lookup.outer_angle < inner_angle);
+        }
+    }
+}
+
+
+BOOST_AUTO_TEST_CASE(Limits)
+{
+    constexpr auto straight = Robot::Kinematic::ACKERMANN_ALL_WHEEL.lookup(0.0f);
+    static_assert(straight.outer_angle==0.0f);
+    static_assert(straight.ratio==1.0f);
+
+    const auto &table = Robot::Kinematic::ACKERMANN_SINGLE_AXLE;
+    const auto full = table.lookup(Ackermann::ANGLE_MAX);
+    BOOST_TEST(full.outer_angle == table.analytic(Ackermann::ANGLE_MAX).outer_angle, boost::test_tools::tolerance(1e-5f));
+    BOOST_TEST(table.lookup(2.0f*Ackermann::ANGLE_MAX).ratio == full.ratio);
+}
+
+
+BOOST_AUTO_TEST_CASE(Curvature)
+{
+    using Robot::Kinematic::ACKERMANN_ALL_WHEEL;
+    for (auto inner_angle=0.01f; inner_angle<Robot::Kinematic::Ackermann::ANGLE_MAX; inner_angle+=0.01f) {
+        const auto curvature = ACKERMANN_ALL_WHEEL.curvature(inner_angle);
+        BOOST_TEST(ACKERMANN_ALL_WHEEL.innerAngle(curvature) == inner_angle, boost::test_tools::tolerance(1e-4f));
+        BOOST_TEST(ACKERMANN_ALL_WHEEL.innerAngle(-curvature) == inner_angle, boost::test_tools::tolerance(1e-4f));
+    }
+    BOOST_TEST(ACKERMANN_ALL_WHEEL.innerAngle(1.0f) == Robot::Kinematic::Ackermann::ANGLE_MAX);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+
+
+BOOST_AUTO_TEST_SUITE(path_suite)
+
+BOOST_AUTO_TEST_CASE(Resample)
+{
+    const Path path { { { 0.0f, 0.0f }, { 1000.0f, 0.0f }, { 1000.0f, 505.0f } } };
+    BOOST_TEST(path.length() == 1505.0f);
+    // Every SPACING mm and the end point
+    BOOST_TEST(path.size() == 152u);
+    BOOST_TEST(path[100].x == 1000.0f, boost::test_tools::tolerance(1e-3f));
+    BOOST_TEST(path.at(1250.0f).y == 250.0f, boost::test_tools::tolerance(1e-3f));
+    BOOST_TEST(path.at(1502.5f).y == 502.5f, boost::test_tools::tolerance(1e-3f));
+    BOOST_TEST(path.at(2000.0f).y == 505.0f);
+
+    BOOST_CHECK_THROW(Path({ { 0.0f, 0.0f } }), std::invalid_argument);
+    BOOST_CHECK_THROW(Path({ { 1.0f, 1.0f }, { 1.0f, 1.0f } }), std::invalid_argument);
+}
+
+
+BOOST_AUTO_TEST_CASE(Spline)
+{
+    const Path path { { { 0.0f, 0.0f }, { 500.0f, 200.0f }, { 1000.0f, 0.0f } }, true };
+    auto closest = 1e9f;
+    for (auto i=0u; i<path.size(); i++) {
+        closest = std::min(closest, std::hypot(path[i].x-500.0f, path[i].y-200.0f));
+        if (i>0) {
+            // Uniform arc length between samples
+            BOOST_TEST(std::hypot(path[i].x-path[i-1].x, path[i].y-path[i-1].y) <= Path::SPACING*1.001f);
+        }
+    }
+    BOOST_TEST(closest < Path::SPACING);
+    BOOST_TEST(path.length() > std::hypot(500.0f, 200.0f)*2.0f);
+}
+
+
+BOOST_AUTO_TEST_CASE(Track)
+{
+    using Robot::Kinematic::ACKERMANN_ALL_WHEEL;
+
+    // S curve followed by the all wheel steering geometry, starting off the path
+    auto path = std::make_shared<const Path>(std::vector<Point> { { 0.0f, 0.0f }, { 800.0f, 0.0f }, { 1600.0f, 600.0f }, { 2400.0f, 600.0f }, { 3200.0f, 0.0f } }, true);
+    PurePursuit pursuit { 250.0f };
+    pursuit.setPath(path);
+    Pose pose { 0.0f, 50.0f, 0.0f };
+
+    constexpr auto STEP { 15.0f };  // mm per update, full speed at 50Hz
+    auto error = 0.0f;
+    auto steps = 0u;
+    for (; steps<1000u; steps++) {
+        const auto previous = pursuit.nearest();
+        const auto command = pursuit.update(pose);
+        BOOST_TEST(pursuit.nearest()-previous <= PurePursuit::SEARCH_WINDOW);
+        if (command.done)
+            break;
+        const auto curvature = std::copysign(ACKERMANN_ALL_WHEEL.curvature(ACKERMANN_ALL_WHEEL.innerAngle(command.curvature)), command.curvature);
+        pose.advance(STEP, curvature);
+        if (steps>50u) {
+            const auto &nearest = (*path)[pursuit.nearest()];
+            error = std::max(error, std::hypot(nearest.x-pose.x, nearest.y-pose.y));
+        }
+    }
+    BOOST_TEST(steps < 1000u);
+    BOOST_TEST(steps*STEP < path->length()*1.1f);
+    BOOST_TEST(error < 40.0f);
+    BOOST_TEST(std::hypot(pose.x-3200.0f, pose.y) < 2.0f*Path::SPACING);
+}
+
+
+BOOST_AUTO_TEST_CASE(Arc)
+{
+    // A quarter circle ends a radius to the side
+    Pose pose;
+    const auto radius = 500.0f;
+    for (auto i=0; i<100; i++) {
+        pose.advance(radius*static_cast<float>(M_PI_2)/100.0f, 1.0f/radius);
+    }
+    BOOST_TEST(pose.x == radius, boost::test_tools::tolerance(1e-3f));
+    BOOST_TEST(pose.y == radius, boost::test_tools::tolerance(1e-3f));
+    BOOST_TEST(pose.heading == static_cast<float>(M_PI_2), boost::test_tools::tolerance(1e-4f));
+}
+
+
+BOOST_AUTO_TEST_CASE(Following)
+{
+    Rig rig;
+    rig.kinematic->setPath({ { 0.0f, 0.0f }, { 2000.0f, 0.0f } });
+    rig.kinematic->setDriveMode(DriveMode::PATH);
+    std::this_thread::sleep_for(100ms);
+    BOOST_TEST((rig.kinematic->getDriveMode()==DriveMode::PATH));
+
+    // The input throttle sets the speed along the straight path
+    rig.input->manual()->setAxis(-1.0f, 0.5f);
+    std::this_thread::sleep_for(100ms);
+    for (auto i=0u; i<Robot::Motor::MOTOR_COUNT; i++) {
+        BOOST_TEST(std::abs(rig.motor(i)->getDuty()) == 0.5f);
+    }
+
+    // Nothing to follow without a path
+    rig.kinematic->clearPath();
+    std::this_thread::sleep_for(100ms);
+    for (auto i=0u; i<Robot::Motor::MOTOR_COUNT; i++) {
+        BOOST_TEST(rig.motor(i)->getDuty() == 0.0f);
+    }
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+
+
+BOOST_AUTO_TEST_SUITE(trajectory_suite)
+
+using Robot::Kinematic::TrajectorySample;
+using Robot::Kinematic::TrajectoryEncoder;
+using Robot::Kinematic::TrajectoryDecoder;
+using Robot::Kinematic::TrajectoryPlayer;
+using Robot::Kinematic::ReplaySync;
+
+static std::string tempFile(const std::string &name)
+{
+    return (std::filesystem::temp_directory_path() / name).string();
+}
+
+static void writeTrajectory(const std::string &filename, DriveMode drive_mode, const std::vector<TrajectorySample> &samples)
+{
+    std::vector<std::uint8_t> data;
+    TrajectoryEncoder::header(data, drive_mode);
+    TrajectoryEncoder encoder;
+    for (const auto &sample : samples) {
+        encoder.encode(data, sample);
+    }
+    std::ofstream file { filename, std::ios::binary };
+    file.write(reinterpret_cast<const char*>(data.data()), data.size());
+}
+
+
+BOOST_AUTO_TEST_CASE(Encoding)
+{
+    // Stick movements from a random walk at the gamepad rate
+    std::mt19937 rng { 42 };
+    std::normal_distribution<float> step { 0.0f, 0.02f };
+    std::vector<TrajectorySample> samples;
+    TrajectorySample sample { 0, 0, 0.0f, 0.0f, 0.0f, 0.0f };
+    for (auto i=0; i<2000; i++) {
+        sample.time += 10;
+        sample.odometer += 3;
+        sample.steering = std::clamp(sample.steering+step(rng), -1.0f, 1.0f);
+        sample.throttle = std::clamp(sample.throttle+step(rng), -1.0f, 1.0f);
+        if (i%10==0) {
+            sample.aux_x = std::clamp(sample.aux_x+step(rng), -1.0f, 1.0f);
+        }
+        samples.push_back(sample);
+    }
+
+    std::vector<std::uint8_t> data;
+    TrajectoryEncoder::header(data, DriveMode::SKID);
+    TrajectoryEncoder encoder;
+    for (const auto &sample : samples) {
+        encoder.encode(data, sample);
+    }
+    BOOST_TEST(data.size() < samples.size()*8u);
+
+    std::istringstream in { std::string(data.begin(), data.end()) };
+    TrajectoryDecoder decoder { in };
+    BOOST_TEST((decoder.header()==DriveMode::SKID));
+    TrajectorySample decoded;
+    for (const auto &expected : samples) {
+        BOOST_TEST_REQUIRE(decoder.next(decoded));
+        BOOST_TEST(decoded.time == expected.time);
+        BOOST_TEST(decoded.odometer == expected.odometer);
+        BOOST_TEST(std::abs(decoded.steering-expected.steering) <= 1.0f/TrajectoryEncoder::AXIS_SCALE);
+        BOOST_TEST(std::abs(decoded.throttle-expected.throttle) <= 1.0f/TrajectoryEncoder::AXIS_SCALE);
+        BOOST_TEST(std::abs(decoded.aux_x-expected.aux_x) <= 1.0f/TrajectoryEncoder::AXIS_SCALE);
+        BOOST_TEST(decoded.aux_y == 0.0f);
+    }
+    BOOST_TEST(!decoder.next(decoded));
+
+    std::istringstream garbage { "not a recording" };
+    TrajectoryDecoder bad { garbage };
+    BOOST_CHECK_THROW(bad.header(), std::runtime_error);
+}
+
+
+BOOST_AUTO_TEST_CASE(Sync)
+{
+    const auto filename = tempFile("test_kinematic_sync.trj");
+    writeTrajectory(filename, DriveMode::ALL_WHEEL, {
+        { 0,    0,   0.0f, 0.5f, 0.0f, 0.0f },
+        { 100,  100, 0.2f, 0.5f, 0.0f, 0.0f },
+        { 5000, 200, 0.2f, 0.0f, 0.0f, 0.0f },
+        { 5100, 200, 0.0f, 0.0f, 0.0f, 0.0f },  // Steering while standing still
+    });
+    const auto t0 = TrajectoryPlayer::clock_type::now();
+
+    TrajectoryPlayer time { filename, ReplaySync::TIME };
+    BOOST_TEST((time.driveMode()==DriveMode::ALL_WHEEL));
+    time.start(t0, 0);
+    BOOST_TEST(time.poll(t0, 0)->throttle == 0.5f, boost::test_tools::tolerance(1e-4f));
+    BOOST_TEST(!time.poll(t0+99ms, 1000).has_value());
+    // Passed samples are skipped
+    BOOST_TEST(time.poll(t0+5050ms, 0)->time == 5000u);
+    BOOST_TEST(!time.done());
+    BOOST_TEST(time.poll(t0+5100ms, 0)->time == 5100u);
+    BOOST_TEST(time.done());
+
+    TrajectoryPlayer distance { filename, ReplaySync::DISTANCE };
+    distance.start(t0, 1000);
+    BOOST_TEST(distance.poll(t0, 1000)->time == 0u);
+    BOOST_TEST(!distance.poll(t0+10s, 1099).has_value());
+    BOOST_TEST(distance.poll(t0+10s, 1100)->time == 100u);
+    BOOST_TEST(distance.poll(t0+10s, 1250)->time == 5000u);
+    BOOST_TEST(!distance.poll(t0+10s+50ms, 1250).has_value());
+    BOOST_TEST(distance.poll(t0+10s+100ms, 1250)->time == 5100u);
+    BOOST_TEST(distance.done());
+
+    std::filesystem::remove(filename);
+}
+
+
+BOOST_AUTO_TEST_CASE(TeachRepeat)
+{
+    const auto filename = tempFile("test_kinematic_teach.trj");
+    Rig rig;
+    rig.kinematic->setDriveMode(DriveMode::SKID);
+    std::this_thread::sleep_for(100ms);
+
+    rig.kinematic->startRecording(filename);
+    rig.input->manual()->setAxis(0.0f, 0.3f);
+    std::this_thread::sleep_for(50ms);
+    rig.input->manual()->setAxis(0.0f, 0.6f);
+    std::this_thread::sleep_for(300ms);
+    rig.input->manual()->setAxis(0.0f, 0.0f);
+    std::this_thread::sleep_for(50ms);
+    BOOST_TEST(rig.kinematic->isRecording());
+    rig.kinematic->stopRecording();
+    std::this_thread::sleep_for(100ms);
+    BOOST_TEST(!rig.kinematic->isRecording());
+
+    // The replay switches back to the recorded drive mode and ignores the input
+    rig.kinematic->setDriveMode(DriveMode::ALL_WHEEL);
+    std::this_thread::sleep_for(100ms);
+    rig.kinematic->startReplay(filename, ReplaySync::TIME);
+    std::this_thread::sleep_for(200ms);
+    rig.input->manual()->setAxis(0.0f, -1.0f);
+    std::this_thread::sleep_for(20ms);
+    BOOST_TEST(rig.kinematic->isReplaying());
+    BOOST_TEST((rig.kinematic->getDriveMode()==DriveMode::SKID));
+    BOOST_TEST(rig.motor(0)->getDuty() == 0.6f, boost::test_tools::tolerance(1e-4f));
+
+    std::this_thread::sleep_for(400ms);
+    BOOST_TEST(!rig.kinematic->isReplaying());
+    BOOST_TEST(rig.motor(0)->getDuty() == 0.0f);
+
+    BOOST_CHECK_THROW(rig.kinematic->startReplay(tempFile("test_kinematic_missing.trj")), std::runtime_error);
+    std::filesystem::remove(filename);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
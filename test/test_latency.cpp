@@ -0,0 +1,258 @@
+#define BOOST_TEST_MODULE Latency
+#include <boost/test/included/unit_test.hpp>
+
+/**
+ * End-to-end latency from SoftwareSource::setAxis until the motor duty and servo
+ * pulse are committed by the motor and servo ticks.
+ *
+ * Environment:
+ *   ROBOT_LATENCY_SAMPLES    Number of inputs injected per case (default 50)
+ *   ROBOT_LATENCY_BUDGET_MS  Allowed 99th percentile latency (default 60)
+ *   ROBOT_LATENCY_SUBSCRIBERS  Subscription readers in the loaded case (default 8)
+ */
+
+#include <mutex>
+#include <thread>
+#include <chrono>
+#include <random>
+#include <vector>
+#include <atomic>
+#include <cstdlib>
+#include <algorithm>
+#include <condition_variable>
+#include <boost/format.hpp>
+
+#include <robotcontext.h>
+#include <robotlogging.h>
+#include <common/notifysubscription.h>
+#include <motor/control.h>
+#include <motor/motor.h>
+#include <motor/servo.h>
+#include <led/control.h>
+#include <input/control.h>
+#include <input/softwareinterface.h>
+#include <kinematic/kinematic.h>
+#include <telemetry/telemetry.h>
+#include <telemetry/sources/motors.h>
+#include <telemetry/sources/systemhealth.h>
+
+using namespace std::literals;
+using clock_type = std::chrono::steady_clock;
+
+static Robot::Logging::LogInit __log_init { boost::log::trivial::warning };
+
+
+static uint envValue(const char *name, uint def)
+{
+    if (auto value = std::getenv(name)) {
+        return std::strtoul(value, nullptr, 10);
+    }
+    return def;
+}
+
+
+/**
+ * The control path of Robot without network, power and RC receiver
+ */
+struct Rig {
+    std::shared_ptr<Robot::Context> context;
+    std::shared_ptr<Robot::Motor::Control> motor_control;
+    std::shared_ptr<Robot::LED::Control> led_control;
+    std::shared_ptr<Robot::Input::Control> input;
+    std::shared_ptr<Robot::Telemetry::Telemetry> telemetry;
+    std::shared_ptr<Robot::Kinematic::Kinematic> kinematic;
+
+    Rig() :
+        context { std::make_shared<Robot::Context>() },
+        motor_control { std::make_shared<Robot::Motor::Control>(context) },
+        led_control { std::make_shared<Robot::LED::Control>(context) },
+        input { std::make_shared<Robot::Input::Control>(context) },
+        telemetry { std::make_shared<Robot::Telemetry::Telemetry>(context) },
+        kinematic { std::make_shared<Robot::Kinematic::Kinematic>(context) }
+    {
+        telemetry->addSource(std::make_shared<Robot::Telemetry::Motors>(motor_control));
+        telemetry->addSource(std::make_shared<Robot::Telemetry::SystemHealth>(context));
+
+        context->init();
+        telemetry->init();
+        motor_control->init();
+        input->init(nullptr);
+        led_control->init(input);
+        kinematic->init(motor_control, led_control, telemetry, input);
+        context->start();
+
+        kinematic->setDriveMode(Robot::Kinematic::DriveMode::ALL_WHEEL);
+        std::this_thread::sleep_for(200ms);
+    }
+
+    ~Rig()
+    {
+        context->stop();
+        kinematic->cleanup();
+        input->cleanup();
+        led_control->cleanup();
+        motor_control->cleanup();
+        telemetry->cleanup();
+        context->cleanup();
+    }
+};
+
+
+/**
+ * Simulates the web frontend, each reader drains a subscription as fast as it is signalled
+ */
+class SubscriptionLoad {
+    public:
+        SubscriptionLoad(Rig &rig, uint readers) :
+            m_running { true }
+        {
+            for (auto i=0u; i<readers; i++) {
+                std::shared_ptr<Robot::NotifySubscription<int>> sub;
+                switch (i%4) {
+                    case 0: sub = Robot::notify_subscribe(*rig.telemetry); break;
+                    case 1: sub = Robot::notify_subscribe(*rig.led_control); break;
+                    case 2: sub = Robot::notify_subscribe(*rig.motor_control->getMotors()[i%Robot::Motor::MOTOR_COUNT]); break;
+                    default: sub = Robot::notify_subscribe(*rig.input->manual()); break;
+                }
+                m_threads.emplace_back([this, sub]{
+                    while (m_running) {
+                        sub->read(50ms);
+                    }
+                    sub->unsubscribe();
+                });
+            }
+        }
+        ~SubscriptionLoad()
+        {
+            m_running = false;
+            for (auto &thread : m_threads) {
+                thread.join();
+            }
+        }
+    private:
+        std::atomic<bool> m_running;
+        std::vector<std::thread> m_threads;
+};
+
+
+struct Result {
+    std::vector<double> motor_ms;
+    std::vector<double> servo_ms;
+    uint missed;
+};
+
+
+static Result measure(Rig &rig, uint samples)
+{
+    auto &motor = rig.motor_control->getMotors()[0];
+    auto servo = motor->servo();
+
+    std::mutex mutex;
+    std::condition_variable cond;
+    bool pending = false;
+    bool motor_seen = false;
+    bool servo_seen = false;
+    float pre_duty = 0.0f;
+    Robot::Value pre_servo;
+    clock_type::time_point injected;
+    Result result { {}, {}, 0u };
+
+    // The tick signals fire right after the outputs have been written
+    boost::signals2::scoped_connection motor_connection = rig.motor_control->sig_motor.connect([&](const auto &) {
+        auto now = clock_type::now();
+        const std::lock_guard<std::mutex> lock(mutex);
+        if (pending && !motor_seen && motor->getOutputDuty()!=pre_duty) {
+            result.motor_ms.push_back(std::chrono::duration<double, std::milli>(now-injected).count());
+            motor_seen = true;
+            cond.notify_all();
+        }
+    });
+    boost::signals2::scoped_connection servo_connection = rig.motor_control->sig_servo.connect([&](const auto &) {
+        auto now = clock_type::now();
+        const std::lock_guard<std::mutex> lock(mutex);
+        if (pending && !servo_seen && servo->getValue()!=pre_servo) {
+            result.servo_ms.push_back(std::chrono::duration<double, std::milli>(now-injected).count());
+            servo_seen = true;
+            cond.notify_all();
+        }
+    });
+
+    std::mt19937 mt { 42 };
+    std::uniform_int_distribution<int> jitter { 0, 20 };
+    auto manual = rig.input->manual();
+    for (auto i=0u; i<samples; i++) {
+        auto value = (i%2) ? 0.5f : -0.5f;
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            pre_duty = motor->getOutputDuty();
+            pre_servo = servo->getValue();
+            motor_seen = false;
+            servo_seen = false;
+            pending = true;
+            injected = clock_type::now();
+        }
+        manual->setAxis(value, value*0.8f);
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            if (!cond.wait_for(lock, 500ms, [&]{ return motor_seen && servo_seen; })) {
+                result.missed++;
+            }
+            pending = false;
+        }
+        // Spread the injections over the tick phase
+        std::this_thread::sleep_for(std::chrono::milliseconds(20+jitter(mt)));
+    }
+
+    return result;
+}
+
+
+static double percentile(std::vector<double> values, double p)
+{
+    if (values.empty()) {
+        return 0.0;
+    }
+    std::sort(values.begin(), values.end());
+    auto idx = static_cast<std::size_t>(p*(values.size()-1)+0.5);
+    return values[std::min(idx, values.size()-1)];
+}
+
+
+static void report(const std::string &name, const Result &result)
+{
+    const auto budget = static_cast<double>(envValue("ROBOT_LATENCY_BUDGET_MS", 60));
+    for (const auto &[output, values] : { std::make_pair("motor", &result.motor_ms), std::make_pair("servo", &result.servo_ms) }) {
+        auto p99 = percentile(*values, 0.99);
+        std::cout << boost::format("%-8s %-6s n=%-4d p50=%6.2fms p90=%6.2fms p99=%6.2fms max=%6.2fms")
+            % name % output % values->size()
+            % percentile(*values, 0.5) % percentile(*values, 0.9) % p99 % percentile(*values, 1.0)
+            << std::endl;
+        BOOST_CHECK_MESSAGE(p99<=budget, name << " " << output << " p99 latency " << p99 << "ms exceeds budget " << budget << "ms");
+    }
+    BOOST_CHECK_MESSAGE(result.missed==0u, name << " " << result.missed << " inputs never reached the outputs");
+}
+
+
+
+BOOST_AUTO_TEST_SUITE(latency_suite)
+
+BOOST_AUTO_TEST_CASE(Idle)
+{
+    Rig rig;
+    report("idle", measure(rig, envValue("ROBOT_LATENCY_SAMPLES", 50)));
+}
+
+
+BOOST_AUTO_TEST_CASE(Loaded)
+{
+    Rig rig;
+
+    rig.led_control->setAnimation(Robot::LED::AnimationMode::RAINBOW_WAVE);
+    auto motors = rig.telemetry->acquire("history_motor_duty");
+    auto system = rig.telemetry->acquire("history_system");
+    SubscriptionLoad load { rig, envValue("ROBOT_LATENCY_SUBSCRIBERS", 8) };
+
+    report("loaded", measure(rig, envValue("ROBOT_LATENCY_SAMPLES", 50)));
+}
+
+BOOST_AUTO_TEST_SUITE_END()
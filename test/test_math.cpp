@@ -0,0 +1,175 @@
+#define BOOST_TEST_MODULE Math
+#include <boost/test/included/unit_test.hpp>
+
+#include <cmath>
+#include <chrono>
+
+#include <math/motionprofile.h>
+#include <math/matrix.h>
+#include <math/lqr.h>
+#include <math/constmath.h>
+
+using namespace std::literals;
+using Robot::Math::MotionProfile;
+using Robot::Math::Matrix;
+
+static constexpr MotionProfile::sample_time_type DT { 20ms };
+
+
+BOOST_AUTO_TEST_SUITE(motionprofile_suite)
+
+BOOST_AUTO_TEST_CASE(Limits)
+{
+    constexpr auto accel = 600.0f;
+    constexpr auto jerk = 6000.0f;
+    MotionProfile profile { accel, jerk };
+    profile.setTarget(100.0f);
+
+    auto last_velocity = 0.0f;
+    auto last_acceleration = 0.0f;
+    auto ticks = 0u;
+    while (!profile.done() && ticks<1000u) {
+        auto velocity = profile.update(DT);
+        // Monotonic without overshoot
+        BOOST_TEST(velocity >= last_velocity);
+        BOOST_TEST(velocity <= 100.0f);
+        BOOST_TEST(std::abs(profile.getAcceleration()) <= accel);
+        if (!profile.done()) {
+            BOOST_TEST(std::abs(profile.getAcceleration()-last_acceleration) <= jerk*DT.count()*1.001f);
+        }
+        last_velocity = velocity;
+        last_acceleration = profile.getAcceleration();
+        ticks++;
+    }
+    BOOST_TEST(profile.getVelocity() == 100.0f);
+
+    // Trapezoid time plus the jerk ramps, with some slack for the sampling
+    auto elapsed = ticks*DT.count();
+    BOOST_TEST(elapsed >= 100.0f/accel);
+    BOOST_TEST(elapsed <= 100.0f/accel + accel/jerk + 4.0f*DT.count());
+}
+
+
+BOOST_AUTO_TEST_CASE(Retarget)
+{
+    MotionProfile profile { 600.0f, 6000.0f };
+    profile.setTarget(200.0f);
+    for (auto i=0; i<10; i++) {
+        profile.update(DT);
+    }
+    BOOST_TEST(profile.getAcceleration() > 0.0f);
+
+    // Reverse in the middle of the ramp, the acceleration is unwound with the jerk limit
+    auto velocity = profile.getVelocity();
+    auto acceleration = profile.getAcceleration();
+    profile.setTarget(-50.0f);
+    profile.update(DT);
+    BOOST_TEST(profile.getAcceleration() == acceleration-6000.0f*DT.count(), boost::test_tools::tolerance(0.001f));
+    BOOST_TEST(profile.getVelocity() > velocity);
+
+    for (auto i=0; i<100 && !profile.done(); i++) {
+        profile.update(DT);
+        BOOST_TEST(profile.getVelocity() >= -50.0f);
+    }
+    BOOST_TEST(profile.getVelocity() == -50.0f);
+}
+
+
+BOOST_AUTO_TEST_CASE(Trapezoid)
+{
+    MotionProfile profile { 500.0f, 0.0f };
+    profile.setTarget(100.0f);
+    BOOST_TEST(profile.update(DT) == 10.0f, boost::test_tools::tolerance(0.001f));
+    BOOST_TEST(profile.getAcceleration() == 500.0f);
+    for (auto i=0; i<9; i++) {
+        profile.update(DT);
+    }
+    BOOST_TEST(profile.getVelocity() == 100.0f, boost::test_tools::tolerance(0.001f));
+}
+
+
+BOOST_AUTO_TEST_CASE(Disabled)
+{
+    MotionProfile profile { 0.0f, 0.0f };
+    profile.reset(20.0f);
+    profile.setTarget(100.0f);
+    BOOST_TEST(profile.update(DT) == 100.0f);
+    BOOST_TEST(profile.done());
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+
+
+BOOST_AUTO_TEST_SUITE(matrix_suite)
+
+BOOST_AUTO_TEST_CASE(Multiply)
+{
+    const Matrix<2, 3> a { 1, 2, 3, 4, 5, 6 };
+    const Matrix<3, 2> b { 7, 8, 9, 10, 11, 12 };
+    auto c = a*b;
+    BOOST_TEST(c(0, 0) == 58.0f);
+    BOOST_TEST(c(0, 1) == 64.0f);
+    BOOST_TEST(c(1, 0) == 139.0f);
+    BOOST_TEST(c(1, 1) == 154.0f);
+
+    auto t = a.transpose();
+    BOOST_TEST(t(2, 1) == 6.0f);
+    BOOST_TEST((a + a*2.0f)(1, 2) == 18.0f);
+}
+
+
+BOOST_AUTO_TEST_CASE(Inverse)
+{
+    const Matrix<3, 3, double> a { 0, 2, 1, 1, 1, 0, 3, 0, 1 };
+    Matrix<3, 3, double> inv;
+    BOOST_TEST(a.inverse(inv));
+    BOOST_TEST((a*inv - Matrix<3, 3, double>::identity()).maxAbs() < 1e-12);
+
+    const Matrix<2, 2, double> singular { 1, 2, 2, 4 };
+    Matrix<2, 2, double> singular_inv;
+    BOOST_TEST(!singular.inverse(singular_inv));
+}
+
+
+BOOST_AUTO_TEST_CASE(Discretize)
+{
+    // Double integrator
+    constexpr auto dt { 0.1 };
+    const Matrix<2, 2, double> A { 0, 1, 0, 0 };
+    const Matrix<2, 1, double> B { 0, 1 };
+    Matrix<2, 2, double> Ad;
+    Matrix<2, 1, double> Bd;
+    Robot::Math::discretize(A, B, dt, Ad, Bd);
+    BOOST_TEST(Ad(0, 1) == dt, boost::test_tools::tolerance(1e-12));
+    BOOST_TEST(Ad(1, 1) == 1.0, boost::test_tools::tolerance(1e-12));
+    BOOST_TEST(Bd[0] == dt*dt/2.0, boost::test_tools::tolerance(1e-12));
+    BOOST_TEST(Bd[1] == dt, boost::test_tools::tolerance(1e-12));
+}
+
+
+BOOST_AUTO_TEST_CASE(ScalarLQR)
+{
+    // x+ = x + u with unit weights, the Riccati solution is the golden ratio
+    const Matrix<1, 1, double> one { 1.0 };
+    Matrix<1, 1, double> K;
+    BOOST_TEST(Robot::Math::dlqr(one, one, one, one, K));
+    const auto P = (1.0+std::sqrt(5.0))/2.0;
+    BOOST_TEST(K[0] == P/(1.0+P), boost::test_tools::tolerance(1e-6));
+}
+
+
+BOOST_AUTO_TEST_CASE(ConstTrig)
+{
+    namespace Const = Robot::Math::Const;
+    static_assert(Const::atan(1.0)>0.785 && Const::atan(1.0)<0.786);
+    for (auto x=-4.0; x<=4.0; x+=0.01) {
+        BOOST_TEST(std::abs(Const::sin(x)-std::sin(x)) < 1e-12);
+        BOOST_TEST(std::abs(Const::atan(x)-std::atan(x)) < 1e-12);
+        if (std::abs(x)<1.5) {
+            BOOST_TEST(std::abs(Const::tan(x)-std::tan(x)) < 1e-10);
+        }
+    }
+}
+
+BOOST_AUTO_TEST_SUITE_END()
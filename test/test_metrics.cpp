@@ -0,0 +1,162 @@
+#define BOOST_TEST_MODULE Metrics
+#include <boost/test/included/unit_test.hpp>
+
+#include <memory>
+#include <thread>
+#include <string>
+#include <boost/asio.hpp>
+
+#include <robotcontext.h>
+#include <metrics/metrics.h>
+#include <metrics/server.h>
+#include <metrics/trace.h>
+#include <metrics/perfcounters.h>
+
+using namespace std::literals;
+using Robot::Metrics::Registry;
+using Robot::Metrics::Server;
+
+
+static std::string scrape(unsigned short port, const std::string &target)
+{
+    boost::asio::io_context io;
+    boost::asio::ip::tcp::socket socket { io };
+    socket.connect({ boost::asio::ip::make_address("127.0.0.1"), port });
+
+    std::string request = "GET " + target + " HTTP/1.1\r\nHost: localhost\r\n\r\n";
+    boost::asio::write(socket, boost::asio::buffer(request));
+
+    std::string response;
+    boost::system::error_code ec;
+    boost::asio::read(socket, boost::asio::dynamic_buffer(response), ec);
+    BOOST_CHECK(ec==boost::asio::error::eof || !ec);
+    return response;
+}
+
+
+BOOST_AUTO_TEST_SUITE(metrics_suite)
+
+BOOST_AUTO_TEST_CASE(TestRender)
+{
+    Registry registry;
+    auto counter = registry.counter("test_ticks", "Number of ticks");
+    auto gauge = registry.gauge("test_level", "Current level");
+    auto histogram = registry.histogram("test_duration_seconds", "Durations", { 0.001, 0.01 });
+
+    // Same name returns the existing metric
+    BOOST_CHECK(registry.counter("test_ticks", "")==counter);
+    BOOST_CHECK_THROW(registry.gauge("test_ticks", ""), std::invalid_argument);
+
+    counter->inc();
+    counter->inc(2);
+    gauge->set(1.5);
+    histogram->observe(0.0005);
+    histogram->observe(5ms);
+    histogram->observe(1.0);
+
+    auto text = registry.render();
+    BOOST_TEST_MESSAGE(text);
+    BOOST_CHECK(text.find("# TYPE test_ticks counter\n")!=std::string::npos);
+    BOOST_CHECK(text.find("test_ticks_total 3\n")!=std::string::npos);
+    BOOST_CHECK(text.find("test_level 1.5\n")!=std::string::npos);
+    BOOST_CHECK(text.find("test_duration_seconds_bucket{le=\"0.001\"} 1\n")!=std::string::npos);
+    BOOST_CHECK(text.find("test_duration_seconds_bucket{le=\"0.01\"} 2\n")!=std::string::npos);
+    BOOST_CHECK(text.find("test_duration_seconds_bucket{le=\"+Inf\"} 3\n")!=std::string::npos);
+    BOOST_CHECK(text.find("test_duration_seconds_count 3\n")!=std::string::npos);
+    BOOST_CHECK(text.size()>=6 && text.compare(text.size()-6, 6, "# EOF\n")==0);
+}
+
+
+BOOST_AUTO_TEST_CASE(TestServer)
+{
+    auto context = std::make_shared<Robot::Context>();
+    auto server = std::make_shared<Server>(context);
+    auto &properties = context->properties(Server::PROPERTY_GROUP);
+    properties.put(Server::PROPERTY_ADDRESS, "127.0.0.1"s);
+    properties.put(Server::PROPERTY_PORT, 0);
+
+    auto counter = Robot::Metrics::registry().counter("test_scrapes", "Scrapes performed by the test");
+    counter->inc(42);
+
+    server->init();
+    BOOST_REQUIRE(server->port()!=0);
+
+    auto work = boost::asio::make_work_guard(context->io());
+    std::thread thread { [&context]{ context->io().run(); } };
+
+    auto response = scrape(server->port(), "/metrics");
+    BOOST_CHECK(response.compare(0, 15, "HTTP/1.1 200 OK")==0);
+    BOOST_CHECK(response.find("application/openmetrics-text")!=std::string::npos);
+    BOOST_CHECK(response.find("test_scrapes_total 42\n")!=std::string::npos);
+    BOOST_CHECK(response.compare(response.size()-6, 6, "# EOF\n")==0);
+
+    response = scrape(server->port(), "/other");
+    BOOST_CHECK(response.compare(0, 12, "HTTP/1.1 404")==0);
+
+    server->cleanup();
+    work.reset();
+    context->io().stop();
+    thread.join();
+}
+
+
+BOOST_AUTO_TEST_CASE(TestTrace)
+{
+    namespace Trace = Robot::Metrics::Trace;
+
+    {
+        ROBOT_TRACE_SCOPE("test.before");
+    }
+    BOOST_CHECK(!Trace::enabled());
+
+    Trace::start();
+    {
+        ROBOT_TRACE_SCOPE("test.scope");
+        ROBOT_TRACE_INSTANT("test.instant");
+    }
+    std::thread thread { []{ ROBOT_TRACE_SCOPE("test.thread"); } };
+    thread.join();
+    Trace::stop();
+    {
+        ROBOT_TRACE_SCOPE("test.after");
+    }
+
+    auto json = Trace::dump();
+    BOOST_CHECK(json.compare(0, 39, "{\"displayTimeUnit\":\"ns\",\"traceEvents\":[")==0);
+    BOOST_CHECK(json.find("\"ph\":\"B\"")!=std::string::npos);
+    BOOST_CHECK(json.find("\"ph\":\"E\"")!=std::string::npos);
+    BOOST_CHECK(json.find("\"name\":\"test.scope\"")!=std::string::npos);
+    BOOST_CHECK(json.find("\"s\":\"t\",\"name\":\"test.instant\"")!=std::string::npos);
+    BOOST_CHECK(json.find("\"name\":\"test.thread\"")!=std::string::npos);
+    BOOST_CHECK(json.find("test.before")==std::string::npos);
+    BOOST_CHECK(json.find("test.after")==std::string::npos);
+}
+
+BOOST_AUTO_TEST_CASE(TestPerfLoop)
+{
+    using Robot::Metrics::PerfLoop;
+
+    auto loop = PerfLoop::get("test");
+    BOOST_CHECK(PerfLoop::get("test")==loop);
+
+    // Nothing is sampled while disabled
+    {
+        const PerfLoop::Scope scope { *loop };
+    }
+    BOOST_CHECK_EQUAL(loop->take().ticks, 0u);
+
+    // Counters may be unavailable (containers, perf_event_paranoid), ticks are only counted when they work
+    PerfLoop::setEnabled(true);
+    for (auto i=0; i<10; i++) {
+        const PerfLoop::Scope scope { *loop };
+    }
+    PerfLoop::setEnabled(false);
+    auto totals = loop->take();
+    BOOST_CHECK(totals.ticks==0u || totals.ticks==10u);
+    if (totals.ticks) {
+        BOOST_CHECK(totals.instructions>0u);
+    }
+    BOOST_CHECK_EQUAL(loop->take().ticks, 0u);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
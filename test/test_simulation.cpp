@@ -0,0 +1,704 @@
+#define BOOST_TEST_MODULE Simulation
+#include <boost/test/included/unit_test.hpp>
+
+#include <cmath>
+#include <chrono>
+#include <thread>
+#include <atomic>
+#include <algorithm>
+
+#include <robotcontext.h>
+#include <robotlogging.h>
+#include <simulation/plant.h>
+#include <simulation/tuner.h>
+#include <motor/control.h>
+#include <motor/motor.h>
+#include <motor/autotune.h>
+#include <motor/traction.h>
+#include <motor/servo.h>
+#include <motor/transaction.h>
+#include <kinematic/balancecontroller.h>
+
+using namespace std::literals;
+using Robot::Simulation::Plant;
+using Robot::Simulation::Tuner;
+using Robot::Kinematic::BalanceController;
+
+static Robot::Logging::LogInit __log_init { boost::log::trivial::warning };
+
+static constexpr auto REAR_LEFT { 2u };
+static constexpr auto REAR_RIGHT { 3u };
+
+
+BOOST_AUTO_TEST_SUITE(plant_suite)
+
+BOOST_AUTO_TEST_CASE(SteadyState)
+{
+    Plant plant;
+    plant.motorSet(0, 1.0f);
+    plant.advance(3s);
+
+    // Friction and load keep the wheel below the no load speed
+    auto rpm = plant.wheelRPM(0);
+    BOOST_TEST(rpm > 120.0f);
+    BOOST_TEST(rpm < 180.0f);
+
+    // Encoder counts follow the wheel and the chassis rolls with it
+    auto revolutions = static_cast<double>(plant.encoder(0)) / (Robot::Config::WHEEL_ENCODER_CPR*Robot::Config::WHEEL_GEARING);
+    BOOST_TEST(revolutions > 3.0*120.0/60.0/2.0);
+    auto rolling = rpm/60.0f * 2.0f*static_cast<float>(M_PI) * static_cast<float>(plant.parameters().wheel_radius);
+    BOOST_TEST(plant.groundSpeed(0) == rolling, boost::test_tools::tolerance(0.01f));
+
+    // Half duty settles at roughly half speed
+    plant.motorSet(0, 0.5f);
+    plant.advance(3s);
+    BOOST_TEST(plant.wheelRPM(0) == rpm/2.0f, boost::test_tools::tolerance(0.15f));
+}
+
+
+BOOST_AUTO_TEST_CASE(Inertia)
+{
+    Plant plant;
+    plant.motorSet(0, 1.0f);
+    plant.advance(10ms);
+    auto early = plant.wheelRPM(0);
+    plant.advance(1s);
+    BOOST_TEST(early > 0.0f);
+    BOOST_TEST(early < plant.wheelRPM(0)/2.0f);
+}
+
+
+BOOST_AUTO_TEST_CASE(BrakeAndFreeSpin)
+{
+    Plant braked;
+    Plant coasting;
+    for (auto plant : { &braked, &coasting }) {
+        plant->motorSet(0, 1.0f);
+        plant->advance(2s);
+    }
+    braked.motorBrake(0);
+    coasting.motorFreeSpin(0);
+    braked.advance(100ms);
+    coasting.advance(100ms);
+    BOOST_TEST(braked.wheelRPM(0) < coasting.wheelRPM(0));
+
+    // Friction eventually stops both without reversing
+    braked.advance(5s);
+    coasting.advance(5s);
+    BOOST_TEST(braked.wheelRPM(0) == 0.0f);
+    BOOST_TEST(coasting.wheelRPM(0) == 0.0f);
+}
+
+
+BOOST_AUTO_TEST_CASE(WheelSlip)
+{
+    auto parameters = Plant::Parameters::defaults();
+    parameters.traction = 0.1;
+    Plant plant { parameters };
+    plant.motorSet(0, 1.0f);
+    plant.advance(50ms);
+
+    auto surface = plant.wheelRPM(0)/60.0f * 2.0f*static_cast<float>(M_PI) * static_cast<float>(parameters.wheel_radius);
+    BOOST_TEST(surface > plant.groundSpeed(0)*1.5f);
+}
+
+
+BOOST_AUTO_TEST_CASE(ServoSlew)
+{
+    Plant plant;
+    plant.servoSendPulse(0, Robot::Config::SERVO_LIMIT_MAX);
+    plant.advance(20ms);
+    BOOST_TEST(plant.servoAngle(0) > 0.0f);
+    BOOST_TEST(plant.servoAngle(0) < 0.5f);
+
+    plant.advance(500ms);
+    BOOST_TEST(plant.servoAngle(0) == static_cast<float>(M_PI_2), boost::test_tools::tolerance(0.001f));
+}
+
+
+BOOST_AUTO_TEST_CASE(PendulumFalls)
+{
+    Plant plant;
+    plant.setPendulum(true, 0.05f);
+    plant.advance(2s);
+    // Lying on the front
+    BOOST_TEST(plant.imu().pitch == 0.0f);
+}
+
+
+BOOST_AUTO_TEST_CASE(PendulumBalanced)
+{
+    Plant plant;
+    plant.setPendulum(true, 0.05f);
+
+    // Simple PD on the rear wheels, driving towards the side it leans to
+    float max_tilt = 0.0f;
+    for (auto i=0; i<500; i++) {
+        auto imu = plant.imu();
+        auto tilt = static_cast<float>(M_PI_2) - imu.pitch;
+        auto duty = std::clamp(30.0f*tilt - 2.0f*imu.gyro_pitch, -1.0f, 1.0f);
+        plant.motorSet(REAR_LEFT, duty);
+        plant.motorSet(REAR_RIGHT, -duty);
+        plant.advance(10ms);
+        max_tilt = std::max(max_tilt, std::abs(tilt));
+    }
+    BOOST_TEST(max_tilt < 0.3f);
+}
+
+
+BOOST_AUTO_TEST_CASE(FasterThanRealTime)
+{
+    Plant plant;
+    for (auto index=0u; index<Robot::Motor::MOTOR_COUNT; index++) {
+        plant.motorSet(index, 0.7f);
+    }
+    plant.setPendulum(true, 0.01f);
+
+    const auto simulated = 60s;
+    auto start = std::chrono::steady_clock::now();
+    for (auto i=0; i<simulated/10ms; i++) {
+        plant.advance(10ms);
+    }
+    std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+    BOOST_TEST_MESSAGE("Simulated " << simulated.count() << "s in " << elapsed.count() << "s");
+    BOOST_TEST(elapsed.count() < std::chrono::duration<double>(simulated).count()/20.0);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+
+
+BOOST_AUTO_TEST_SUITE(tuner_suite)
+
+BOOST_AUTO_TEST_CASE(Episodes)
+{
+    Tuner tuner { Tuner::Loop::MOTOR };
+    // Too little gain never reaches the target
+    BOOST_TEST(!tuner.evaluate(Robot::Simulation::Gains { 1.0e-4f, 0.0f, 0.0f }).stable);
+    auto score = tuner.evaluate(Robot::Simulation::Gains { 0.02f, 0.2f, 0.0f });
+    BOOST_TEST(score.stable);
+    BOOST_TEST(score.rise_time > 0.0f);
+    BOOST_TEST(score.settling_time < 1.0f);
+}
+
+
+BOOST_AUTO_TEST_CASE(Search)
+{
+    auto context = std::make_shared<Robot::Context>();
+    for (auto loop : { Tuner::Loop::MOTOR, Tuner::Loop::BALANCING }) {
+        Tuner tuner { loop };
+        tuner.setThreads(2);
+        tuner.setGrid(3);
+        tuner.setRounds(2, 8);
+        auto result = tuner.run();
+        BOOST_TEST(result.score.stable);
+        BOOST_TEST(result.score.cost() <= tuner.evaluate(Tuner::defaults(loop)).cost());
+        BOOST_TEST(result.episodes == 1u + 27u + 2u*8u);
+
+        tuner.store(*context, result.gains);
+        BOOST_TEST(context->properties(Tuner::propertyGroup(loop)).get<float>("pid_p") == result.gains.p);
+    }
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+
+
+BOOST_AUTO_TEST_SUITE(autotune_suite)
+
+BOOST_AUTO_TEST_CASE(RelayExperiment)
+{
+    using Robot::Motor::Autotune;
+    constexpr auto interval = std::chrono::duration<float>(Robot::Motor::MOTOR_TIMER_INTERVAL);
+    constexpr auto counts_per_rev = static_cast<float>(Robot::Config::WHEEL_ENCODER_CPR*Robot::Config::WHEEL_GEARING);
+
+    // Same speed estimate and output shaping as the motor tick
+    Plant plant;
+    Autotune autotune;
+    autotune.start(100.0f, Robot::Motor::MOTOR_AUTOTUNE_AMPLITUDE);
+    auto last = plant.encoder(REAR_LEFT);
+    auto rpm = 0.0f;
+    auto duty_set = 0.0f;
+    auto ticks = 0u;
+    while (autotune.state()==Autotune::State::RUNNING && ticks<1000u) {
+        plant.advance(interval);
+        auto value = plant.encoder(REAR_LEFT);
+        rpm = ((value-last) * 60.0f / (counts_per_rev*interval.count()) + rpm)/2.0f;
+        last = value;
+        auto duty = autotune.update(rpm, interval);
+        if (std::abs(duty-duty_set)>Robot::Motor::MOTOR_DUTY_MIN_CHANGE) {
+            plant.motorSet(REAR_LEFT, duty);
+            duty_set = duty;
+        }
+        ticks++;
+    }
+    BOOST_TEST_MESSAGE("Auto-tune took " << ticks*interval.count() << "s");
+    BOOST_TEST(autotune.state()==Autotune::State::DONE);
+
+    const auto &status = autotune.status();
+    BOOST_TEST(status.cycles == Autotune::WARMUP_CYCLES+Autotune::MEASURE_CYCLES);
+    BOOST_TEST(status.result.ku > 0.0f);
+    BOOST_TEST(status.result.tu > 2.0f*interval.count());
+    // The bias ends up near the open loop duty for the setpoint
+    BOOST_TEST(status.bias > 0.3f);
+    BOOST_TEST(status.bias < 0.9f);
+
+    // The derived gains hold up in the step and load episode
+    Tuner tuner { Tuner::Loop::MOTOR };
+    auto score = tuner.evaluate(Robot::Simulation::Gains { status.result.p, status.result.i, status.result.d });
+    BOOST_TEST_MESSAGE("Auto-tune gains " << status.result.p << " " << status.result.i << " " << status.result.d << " cost " << score.cost());
+    BOOST_TEST(score.stable);
+}
+
+
+BOOST_AUTO_TEST_CASE(NoOscillation)
+{
+    using Robot::Motor::Autotune;
+    Autotune autotune;
+    autotune.start(100.0f, 0.1f);
+    // Wheel never moves
+    auto ticks = 0u;
+    while (autotune.state()==Autotune::State::RUNNING && ticks<1000u) {
+        autotune.update(0.0f, Robot::Motor::MOTOR_TIMER_INTERVAL);
+        ticks++;
+    }
+    BOOST_TEST(autotune.state()==Autotune::State::FAILED);
+    BOOST_TEST(autotune.update(0.0f, Robot::Motor::MOTOR_TIMER_INTERVAL) == 0.0f);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+
+
+BOOST_AUTO_TEST_SUITE(traction_suite)
+
+BOOST_AUTO_TEST_CASE(SlipAndStall)
+{
+    using Robot::Motor::Traction;
+    Traction traction;
+
+    // Skid turn, the inner wheels are expected at a third of the speed and all run 10% slow
+    const Robot::Motor::MotorValues expected { 120.0f, -40.0f, 120.0f, -40.0f };
+    Robot::Motor::MotorValues rpm { 108.0f, -36.0f, 108.0f, -36.0f };
+    for (auto i=0u; i<50u; i++) {
+        BOOST_TEST(!traction.update(expected, rpm));
+    }
+    BOOST_TEST(traction.reference() == 0.9f, boost::test_tools::tolerance(1e-4f));
+
+    // One wheel spins up, the reference stays with the others
+    rpm[1] = -80.0f;
+    for (auto i=1u; i<Traction::SLIP_TICKS; i++) {
+        BOOST_TEST(!traction.update(expected, rpm));
+    }
+    BOOST_TEST(traction.update(expected, rpm));
+    BOOST_TEST(traction.state(1)==Traction::State::SLIP);
+    BOOST_TEST(traction.reference() == 0.9f, boost::test_tools::tolerance(1e-4f));
+    BOOST_TEST(traction.limit(1) < 1.0f);
+    BOOST_TEST(traction.limit(0) == 1.0f);
+
+    // Limited back within the margin the limit holds, below it grip is regained
+    rpm[1] = -44.0f;
+    auto limit = traction.limit(1);
+    BOOST_TEST(!traction.update(expected, rpm));
+    BOOST_TEST(traction.limit(1) == limit);
+    rpm[1] = -36.0f;
+    BOOST_TEST(traction.update(expected, rpm));
+    BOOST_TEST(traction.state(1)==Traction::State::GRIP);
+    BOOST_TEST(traction.limit(1) > limit);
+
+    // A blocked wheel
+    rpm[2] = 0.0f;
+    for (auto i=1u; i<Traction::STALL_TICKS; i++) {
+        traction.update(expected, rpm);
+    }
+    BOOST_TEST(traction.state(2)==Traction::State::GRIP);
+    BOOST_TEST(traction.update(expected, rpm));
+    BOOST_TEST(traction.state(2)==Traction::State::STALL);
+
+    // Wheels not driven are left alone
+    traction.update({ 0.0f, 0.0f, 0.0f, 0.0f }, rpm);
+    BOOST_TEST((traction.states()==Traction::StateList { Traction::State::GRIP, Traction::State::GRIP, Traction::State::GRIP, Traction::State::GRIP }));
+}
+
+
+BOOST_AUTO_TEST_CASE(PlantSlip)
+{
+    using Robot::Motor::Traction;
+    constexpr auto interval = std::chrono::duration<float>(Robot::Motor::MOTOR_TIMER_INTERVAL);
+    constexpr auto duty = 0.6f;
+    const auto expected_rpm = (duty-Robot::Motor::MOTOR_FF_KS)/Robot::Motor::MOTOR_FF_KV;
+
+    // Pushing against a load, the wheel on the slippery patch does not carry any of it
+    auto run = [&](bool limit, uint &slips) {
+        Plant plant;
+        plant.setTraction(0, 0.0f);
+        for (auto i=1u; i<Robot::Motor::MOTOR_COUNT; i++) {
+            plant.setLoad(i, 0.25f);
+        }
+        Traction traction;
+        Robot::Motor::MotorValues expected;
+        Robot::Motor::MotorValues rpm { 0.0f, 0.0f, 0.0f, 0.0f };
+        expected.fill(expected_rpm);
+        auto excess = 0.0f;
+        slips = 0u;
+        for (auto tick=0u; tick<100u; tick++) {
+            for (auto i=0u; i<Robot::Motor::MOTOR_COUNT; i++) {
+                plant.motorSet(i, duty * (limit ? traction.limit(i) : 1.0f));
+            }
+            plant.advance(interval);
+            for (auto i=0u; i<Robot::Motor::MOTOR_COUNT; i++) {
+                rpm[i] = (plant.wheelRPM(i)+rpm[i])/2.0f;
+            }
+            if (traction.update(expected, rpm) && traction.state(0)==Traction::State::SLIP) {
+                slips++;
+            }
+            BOOST_TEST(traction.state(1)==Traction::State::GRIP);
+            excess += rpm[0]-rpm[1];
+        }
+        return excess/100.0f;
+    };
+
+    uint slips;
+    const auto unlimited = run(false, slips);
+    BOOST_TEST(slips == 1u);
+    const auto limited = run(true, slips);
+    BOOST_TEST(slips >= 1u);
+    BOOST_TEST_MESSAGE("Slipping wheel excess " << unlimited << " RPM, limited " << limited << " RPM");
+    BOOST_TEST(limited < unlimited/2.0f);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+
+
+BOOST_AUTO_TEST_SUITE(balance_suite)
+
+/**
+ * Balance the pendulum for a while, drive forward at 0.3m/s and stop again.
+ * Sensors are read the way the balancing scheme does, tilt rate differentiated
+ * from the angle, position from the encoders and velocity from the wheel RPM.
+ */
+static void balanceRun(BalanceController::Mode mode)
+{
+    using namespace Robot::Config;
+    static constexpr auto DT { 10ms };
+    static constexpr auto METERS_PER_COUNT { WHEEL_CIRC_MM / (1000.0f*WHEEL_ENCODER_CPR*WHEEL_GEARING) };
+
+    Plant plant;
+    plant.setPendulum(true, 0.05f);
+    auto gains = BalanceController::Gains::defaults();
+    gains.mode = mode;
+    BalanceController controller { DT };
+    BOOST_TEST(controller.configure(gains));
+    BOOST_TEST((controller.mode()==mode));
+    controller.reset(0.0f);
+
+    auto position = [&plant] {
+        return (plant.encoder(REAR_LEFT) - plant.encoder(REAR_RIGHT)) * METERS_PER_COUNT / 2.0f;
+    };
+    auto velocity = [&plant] {
+        return (plant.wheelRPM(REAR_LEFT) - plant.wheelRPM(REAR_RIGHT)) * WHEEL_CIRC_MM / (1000.0f*60.0f*2.0f);
+    };
+
+    auto last_tilt = 0.05f;
+    auto max_tilt = 0.0f;
+    auto max_velocity = 0.0f;
+    for (auto i=0; i<1500; i++) {
+        if (i==500) 
+            controller.setVelocity(0.3f);
+        if (i==800) 
+            controller.setVelocity(0.0f);
+
+        auto tilt = static_cast<float>(M_PI_2) - plant.imu().pitch;
+        auto tilt_rate = (tilt-last_tilt) / std::chrono::duration<float>(DT).count();
+        last_tilt = tilt;
+        auto duty = controller.update({ tilt, tilt_rate, position(), velocity() });
+        plant.motorSet(REAR_LEFT, duty);
+        plant.motorSet(REAR_RIGHT, -duty);
+        plant.advance(DT);
+
+        max_tilt = std::max(max_tilt, std::abs(tilt));
+        max_velocity = std::max(max_velocity, velocity());
+        if (i==499) {
+            // Recovered and holding the position
+            BOOST_TEST(std::abs(tilt) < 0.02f);
+            BOOST_TEST(std::abs(position()) < 0.05f);
+        }
+    }
+    BOOST_TEST(max_tilt < 0.15f);
+    BOOST_TEST(max_velocity > 0.3f);
+    BOOST_TEST(max_velocity < 0.6f);
+    // Stopped where the velocity reference ended, 3s at 0.3m/s
+    BOOST_TEST(position() == 0.9f, boost::test_tools::tolerance(0.1f));
+    BOOST_TEST(std::abs(velocity()) < 0.05f);
+}
+
+
+BOOST_AUTO_TEST_CASE(Cascade)
+{
+    balanceRun(BalanceController::Mode::CASCADE);
+}
+
+
+BOOST_AUTO_TEST_CASE(LQR)
+{
+    balanceRun(BalanceController::Mode::LQR);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+
+
+BOOST_AUTO_TEST_SUITE(context_suite)
+
+BOOST_AUTO_TEST_CASE(MotorEncoderFromPlant)
+{
+    auto context = std::make_shared<Robot::Context>();
+    auto motor_control = std::make_shared<Robot::Motor::Control>(context);
+    context->init();
+    motor_control->init();
+    context->start();
+
+    auto &motor = motor_control->getMotors()[0];
+    motor->setDuty(0.8f);
+    motor->setEnabled(true);
+    std::this_thread::sleep_for(1s);
+
+    BOOST_TEST(context->plant()->wheelRPM(0) > 50.0f);
+    BOOST_TEST(motor->getRPM() > 50.0f);
+    BOOST_TEST(motor->getEncoderValue() > 0);
+
+    motor->setEnabled(false);
+    context->stop();
+    motor_control->cleanup();
+    context->cleanup();
+}
+
+
+BOOST_AUTO_TEST_CASE(MotorRPMProfile)
+{
+    auto context = std::make_shared<Robot::Context>();
+    auto motor_control = std::make_shared<Robot::Motor::Control>(context);
+    context->init();
+    motor_control->init();
+    context->start();
+
+    auto &motor = motor_control->getMotors()[REAR_LEFT];
+    motor->setEnabled(true);
+    motor->setTargetRPM(100.0f);
+    std::this_thread::sleep_for(60ms);
+    // Still ramping, and the duty follows the ramp instead of saturating
+    BOOST_TEST(motor->getReferenceRPM() < 100.0f);
+    BOOST_TEST(motor->getOutputDuty() < 0.5f);
+
+    std::this_thread::sleep_for(1s);
+    BOOST_TEST(motor->getReferenceRPM() == 100.0f);
+    BOOST_TEST(context->plant()->wheelRPM(REAR_LEFT) == 100.0f, boost::test_tools::tolerance(0.1f));
+
+    motor->setEnabled(false);
+    context->stop();
+    motor_control->cleanup();
+    context->cleanup();
+}
+
+
+BOOST_AUTO_TEST_CASE(MotorDirect)
+{
+    using Robot::Motor::Motor;
+    auto context = std::make_shared<Robot::Context>();
+    auto motor_control = std::make_shared<Robot::Motor::Control>(context);
+    context->init();
+    motor_control->init();
+    context->start();
+
+    auto &motor = motor_control->getMotors()[REAR_LEFT];
+    motor->setDirect();
+    BOOST_TEST((motor->getMode()==Motor::Mode::DIRECT));
+    // Not written while disabled
+    BOOST_TEST(!motor->writeDirect(0.6f));
+
+    motor->setEnabled(true);
+    BOOST_TEST(motor->writeDirect(0.6f));
+    std::this_thread::sleep_for(1s);
+    // The motor tick leaves the direct duty in place
+    BOOST_TEST(motor->getOutputDuty() == 0.6f);
+    BOOST_TEST(context->plant()->wheelRPM(REAR_LEFT) > 80.0f);
+
+    // Any other mode takes the driver back
+    motor->setDuty(0.0f);
+    BOOST_TEST(!motor->writeDirect(1.0f));
+    std::this_thread::sleep_for(1s);
+    BOOST_TEST(std::abs(context->plant()->wheelRPM(REAR_LEFT)) < 20.0f);
+
+    motor->setEnabled(false);
+    context->stop();
+    motor_control->cleanup();
+    context->cleanup();
+}
+
+
+BOOST_AUTO_TEST_CASE(MotorTransaction)
+{
+    using Robot::Motor::Motor;
+    using Robot::Motor::Transaction;
+    using Robot::Value;
+    auto context = std::make_shared<Robot::Context>();
+    auto motor_control = std::make_shared<Robot::Motor::Control>(context);
+    context->init();
+    motor_control->init();
+    context->start();
+
+    const auto &motors = motor_control->getMotors();
+    for (auto &motor : motors) {
+        motor->setEnabled(true);
+        motor->servo()->setEnabled(true);
+    }
+
+    // Alternate between two command sets, no tick may see a mix of them
+    const std::array<float, 2> duty { 0.2f, 0.4f };
+    const std::array<Value, 2> servo { Value::fromAngle(-0.3f), Value::fromAngle(0.3f) };
+    std::atomic<uint> torn { 0u };
+    std::atomic<uint> motor_ticks { 0u };
+    std::atomic<uint> servo_ticks { 0u };
+    boost::signals2::scoped_connection motor_connection = motor_control->sig_motor.connect([&](const auto &list) {
+        auto count = std::count_if(list.begin(), list.end(), [&](auto &motor) { return motor->getDuty()==duty[0]; });
+        if (count!=0 && count!=static_cast<long>(list.size())) {
+            torn++;
+        }
+        motor_ticks++;
+    });
+    boost::signals2::scoped_connection servo_connection = motor_control->sig_servo.connect([&](const auto &list) {
+        auto count = std::count_if(list.begin(), list.end(), [&](auto &s) { return s->getValue()==servo[0]; });
+        if (count!=0 && count!=static_cast<long>(list.size())) {
+            torn++;
+        }
+        servo_ticks++;
+    });
+
+    const auto generation = motor_control->getGeneration();
+    for (auto i=0u; i<60u; i++) {
+        Transaction transaction;
+        for (auto index=0u; index<Robot::Motor::MOTOR_COUNT; index++) {
+            transaction.setDuty(index, duty[i%2]);
+            transaction.setServo(index, servo[i%2]);
+        }
+        BOOST_TEST(motor_control->commit(transaction) == generation+i+1u);
+        std::this_thread::sleep_for(3ms);
+    }
+    BOOST_TEST(torn == 0u);
+    BOOST_TEST(motor_ticks > 0u);
+    BOOST_TEST(servo_ticks > 0u);
+
+    // Actuators without a staged value keep their command
+    Transaction partial;
+    BOOST_TEST(partial.empty());
+    partial.setTargetRPM(REAR_LEFT, 50.0f);
+    motor_control->commit(partial);
+    BOOST_TEST((motors[REAR_LEFT]->getMode()==Motor::Mode::RPM));
+    BOOST_TEST(motors[0]->getDuty() == duty[1]);
+    BOOST_TEST((motors[0]->servo()->getValue()==servo[1]));
+
+    motor_connection.disconnect();
+    servo_connection.disconnect();
+    for (auto &motor : motors) {
+        motor->servo()->setEnabled(false);
+        motor->setEnabled(false);
+    }
+    context->stop();
+    motor_control->cleanup();
+    context->cleanup();
+}
+
+
+BOOST_AUTO_TEST_CASE(MotorTraction)
+{
+    using Robot::Motor::Traction;
+    auto context = std::make_shared<Robot::Context>();
+    auto motor_control = std::make_shared<Robot::Motor::Control>(context);
+    context->init();
+    motor_control->init();
+    context->start();
+
+    const auto &motors = motor_control->getMotors();
+    auto plant = context->plant();
+    plant->setTraction(0, 0.0f);
+    for (auto i=1u; i<Robot::Motor::MOTOR_COUNT; i++) {
+        plant->setLoad(i, 0.25f);
+    }
+
+    std::array<std::atomic<bool>, Robot::Motor::MOTOR_COUNT> slipped { false, false, false, false };
+    std::atomic<float> limit { 1.0f };
+    boost::signals2::scoped_connection connection = motor_control->sig_motor.connect([&](const auto &list) {
+        for (auto i=0u; i<list.size(); i++) {
+            if (list[i]->getTraction()==Traction::State::SLIP) {
+                slipped[i] = true;
+            }
+        }
+        limit = std::min(limit.load(), list[0]->getTractionLimit());
+    });
+
+    BOOST_TEST(motor_control->getTractionControl());
+    for (auto &motor : motors) {
+        motor->setEnabled(true);
+    }
+    motor_control->setDuty({ 0.6f, 0.6f, 0.6f, 0.6f });
+    std::this_thread::sleep_for(1s);
+    BOOST_TEST(slipped[0]);
+    BOOST_TEST(!slipped[1]);
+    BOOST_TEST(!slipped[2]);
+    BOOST_TEST(!slipped[3]);
+    BOOST_TEST(limit < 1.0f);
+    // The command is left as is, only the output is limited
+    BOOST_TEST(motors[0]->getDuty() == 0.6f);
+
+    // Reported only
+    motor_control->setTractionControl(false);
+    std::this_thread::sleep_for(100ms);
+    BOOST_TEST(motors[0]->getTractionLimit() == 1.0f);
+
+    // Blocked wheel
+    plant->setLoad(1, 5.0f);
+    std::this_thread::sleep_for(1s);
+    BOOST_TEST((motors[1]->getTraction()==Traction::State::STALL));
+
+    connection.disconnect();
+    for (auto &motor : motors) {
+        motor->setEnabled(false);
+    }
+    context->stop();
+    motor_control->cleanup();
+    context->cleanup();
+}
+
+
+BOOST_AUTO_TEST_CASE(MotorAutotune)
+{
+    using Robot::Motor::Autotune;
+    auto context = std::make_shared<Robot::Context>();
+    auto motor_control = std::make_shared<Robot::Motor::Control>(context);
+    context->init();
+    motor_control->init();
+    context->start();
+
+    auto &motor = motor_control->getMotors()[REAR_LEFT];
+    motor->setEnabled(true);
+    motor->startAutotune(100.0f);
+    BOOST_TEST((motor->getMode()==Robot::Motor::Motor::Mode::AUTOTUNE));
+    for (auto i=0; i<100 && motor->getAutotune().state==Autotune::State::RUNNING; i++) {
+        std::this_thread::sleep_for(100ms);
+    }
+    auto status = motor->getAutotune();
+    BOOST_TEST((status.state==Autotune::State::DONE));
+
+    // Continues holding the setpoint with the new gains
+    BOOST_TEST((motor->getMode()==Robot::Motor::Motor::Mode::RPM));
+    std::this_thread::sleep_for(1s);
+    BOOST_TEST(context->plant()->wheelRPM(REAR_LEFT) == 100.0f, boost::test_tools::tolerance(0.1f));
+
+    motor->setEnabled(false);
+    context->stop();
+    motor_control->cleanup();
+    context->cleanup();
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,127 @@
+#define BOOST_TEST_MODULE Telemetry
+#include <boost/test/included/unit_test.hpp>
+
+#include <memory>
+
+#include <robotcontext.h>
+#include <telemetry/telemetry.h>
+#include <telemetry/eventpool.h>
+#include <telemetry/sources/abstracttelemetrysource.h>
+
+using namespace std::literals;
+using Robot::Telemetry::Telemetry;
+
+
+class CountingSource : public Robot::Telemetry::AbstractSource<CountingSource> {
+    public:
+        explicit CountingSource(const std::string_view &name, bool always_on = false) :
+            AbstractSource { name, always_on },
+            starts { 0u },
+            stops { 0u }
+        {}
+
+        uint starts;
+        uint stops;
+
+    protected:
+        void start() override { starts++; }
+        void stop() override { stops++; }
+};
+
+
+BOOST_AUTO_TEST_SUITE(telemetry_suite)
+
+BOOST_AUTO_TEST_CASE(TestActivation)
+{
+    auto context = std::make_shared<Robot::Context>();
+    auto telemetry = std::make_shared<Telemetry>(context);
+    auto mpu = std::make_shared<CountingSource>("mpu");
+    auto battery = std::make_shared<CountingSource>("battery", true);
+    telemetry->addSource(mpu);
+    telemetry->addSource(battery);
+
+    telemetry->init();
+    BOOST_CHECK_EQUAL(mpu->starts, 0u);
+    BOOST_CHECK_EQUAL(battery->starts, 1u);
+    BOOST_CHECK(!telemetry->active("mpu"));
+
+    auto a1 = telemetry->acquire("mpu");
+    auto a2 = telemetry->acquire("mpu");
+    BOOST_CHECK_EQUAL(mpu->starts, 1u);
+    BOOST_CHECK(telemetry->active("mpu"));
+
+    a1.reset();
+    BOOST_CHECK_EQUAL(mpu->stops, 0u);
+    a2->release();
+    BOOST_CHECK_EQUAL(mpu->stops, 1u);
+    BOOST_CHECK(!telemetry->active("mpu"));
+
+    // Releasing twice must not underflow the reference count
+    a2.reset();
+    BOOST_CHECK_EQUAL(mpu->stops, 1u);
+
+    // History series keep their feeding source running
+    {
+        auto history = telemetry->acquire("history_imu");
+        BOOST_CHECK_EQUAL(mpu->starts, 2u);
+        BOOST_CHECK(telemetry->active("history_imu"));
+    }
+    BOOST_CHECK_EQUAL(mpu->stops, 2u);
+
+    // Always-on sources are never parked by consumers
+    telemetry->acquire("battery").reset();
+    BOOST_CHECK_EQUAL(battery->stops, 0u);
+
+    telemetry->cleanup();
+    BOOST_CHECK_EQUAL(battery->stops, 1u);
+    BOOST_CHECK_EQUAL(mpu->stops, 2u);
+}
+
+
+BOOST_AUTO_TEST_CASE(TestAcquireBeforeInit)
+{
+    auto context = std::make_shared<Robot::Context>();
+    auto telemetry = std::make_shared<Telemetry>(context);
+    auto motors = std::make_shared<CountingSource>("motors");
+    telemetry->addSource(motors);
+
+    auto activation = telemetry->acquire("motors");
+    BOOST_CHECK_EQUAL(motors->starts, 0u);
+    telemetry->init();
+    BOOST_CHECK_EQUAL(motors->starts, 1u);
+    telemetry->cleanup();
+    BOOST_CHECK_EQUAL(motors->stops, 1u);
+}
+
+
+BOOST_AUTO_TEST_CASE(TestEventPool)
+{
+    using namespace Robot::Telemetry;
+    EventPool<EventBattery, 2> pool { "battery" };
+
+    auto e1 = pool.acquire();
+    auto e2 = pool.acquire();
+    BOOST_REQUIRE(e1);
+    BOOST_REQUIRE(e2);
+    BOOST_CHECK(e1.get()!=e2.get());
+    BOOST_CHECK(!pool.acquire());
+
+    e1->addCell(3.7f);
+    BOOST_CHECK_EQUAL(e1->cell_count, 1u);
+    BOOST_CHECK(e1->name=="battery");
+
+    // Type erased references keep the slot alive
+    EventRef ref { e1 };
+    e1.reset();
+    BOOST_CHECK(!pool.acquire());
+    BOOST_CHECK(event_cast<EventBattery>(*ref)!=nullptr);
+    BOOST_CHECK(event_cast<EventIMU>(*ref)==nullptr);
+    ref.reset();
+
+    // Released slots are reset to their initial value
+    auto e3 = pool.acquire();
+    BOOST_REQUIRE(e3);
+    BOOST_CHECK_EQUAL(e3->cell_count, 0u);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
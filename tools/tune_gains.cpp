@@ -0,0 +1,120 @@
+/**
+ * Offline gain tuning against the simulated plant.
+ *
+ * Runs step response and disturbance episodes for the motor RPM loop and the
+ * balancing loop on all cores, and prints the best gains as property groups:
+ *
+ *   tune_gains [--loop motor|balancing|all] [--threads N] [--grid N] [--rounds N] [--candidates N]
+ *
+ * The output can be sent unchanged to the PUT /properties endpoint of the web API.
+ */
+#include <memory>
+#include <string>
+#include <vector>
+#include <chrono>
+#include <iostream>
+#include <boost/format.hpp>
+#include <boost/log/trivial.hpp>
+
+#include <robotcontext.h>
+#include <robotlogging.h>
+#include <motor/motor.h>
+#include <simulation/tuner.h>
+
+using namespace std::literals;
+using Robot::Simulation::Tuner;
+
+static void usage(const char *name)
+{
+    std::cerr << "Usage: " << name << " [--loop motor|balancing|all] [--threads N] [--grid N] [--rounds N] [--candidates N]" << std::endl;
+}
+
+
+int main(int argc, char *argv[])
+{
+    Robot::Logging::initLogging();
+
+    std::vector<Tuner::Loop> loops { Tuner::Loop::MOTOR, Tuner::Loop::BALANCING };
+    uint threads = 0u;
+    uint grid = 0u;
+    uint rounds = 8u;
+    uint candidates = 32u;
+
+    for (auto n=1; n<argc; n++) {
+        std::string arg { argv[n] };
+        if (n+1>=argc) {
+            usage(argv[0]);
+            return 1;
+        }
+        std::string value { argv[++n] };
+        if (arg=="--loop") {
+            if (value=="motor") {
+                loops = { Tuner::Loop::MOTOR };
+            }
+            else if (value=="balancing") {
+                loops = { Tuner::Loop::BALANCING };
+            }
+            else if (value!="all") {
+                usage(argv[0]);
+                return 1;
+            }
+        }
+        else if (arg=="--threads") {
+            threads = std::stoul(value);
+        }
+        else if (arg=="--grid") {
+            grid = std::stoul(value);
+        }
+        else if (arg=="--rounds") {
+            rounds = std::stoul(value);
+        }
+        else if (arg=="--candidates") {
+            candidates = std::stoul(value);
+        }
+        else {
+            usage(argv[0]);
+            return 1;
+        }
+    }
+
+    auto context = std::make_shared<Robot::Context>();
+    Robot::Motor::Motor::registerProperties(context);
+
+    for (auto loop : loops) {
+        Tuner tuner { loop };
+        if (threads>0u) {
+            tuner.setThreads(threads);
+        }
+        if (grid>0u) {
+            tuner.setGrid(grid);
+        }
+        tuner.setRounds(rounds, candidates);
+
+        auto initial = tuner.evaluate(Tuner::defaults(loop));
+        auto start = std::chrono::steady_clock::now();
+        auto result = tuner.run();
+        std::chrono::duration<float> elapsed = std::chrono::steady_clock::now() - start;
+
+        BOOST_LOG_TRIVIAL(info) << boost::format("%s: %d episodes in %.1fs, cost %.3f -> %.3f (rise %.3fs, overshoot %.1f%%, settling %.3fs, disturbance %.3f)")
+            % loop % result.episodes % elapsed.count() % initial.cost() % result.score.cost()
+            % result.score.rise_time % (100.0f*result.score.overshoot) % result.score.settling_time % result.score.disturbance;
+        if (!result.score.stable) {
+            BOOST_LOG_TRIVIAL(warning) << loop << ": no stable gains found";
+        }
+
+        tuner.store(*context, result.gains);
+    }
+
+    // Print the tuned groups as JSON
+    std::cout << "{" << std::endl;
+    for (auto n=0u; n<loops.size(); n++) {
+        const auto &group = Tuner::propertyGroup(loops[n]);
+        const auto &values = context->properties(group);
+        std::cout << boost::format("    \"%s\": { \"pid_p\": %g, \"pid_i\": %g, \"pid_d\": %g }%s")
+            % group % values.get<float>("pid_p") % values.get<float>("pid_i") % values.get<float>("pid_d") % (n+1<loops.size() ? "," : "")
+            << std::endl;
+    }
+    std::cout << "}" << std::endl;
+
+    return 0;
+}
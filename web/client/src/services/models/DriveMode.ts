@@ -13,5 +13,6 @@ export enum DriveMode {
     SKID = 'SKID',
     SPINNING = 'SPINNING',
     BALANCING = 'BALANCING',
+    PATH = 'PATH',
     PASSTHROUGH = 'PASSTHROUGH',
 }
\ No newline at end of file
@@ -5,7 +5,7 @@ from aiohttp.web import Application, RouteTableDef, Request, Response, HTTPBadRe
 from socketio import AsyncServer
 from dataclasses import dataclass
 
-from beaglerover import Kinematic, Subscription, DriveMode, Orientation
+from beaglerover import Kinematic, Subscription, DriveMode, Orientation, ThrottleMode
 
 from .util import to_enum
 from .watches import WatchableNamespace, SubscriptionWatch
@@ -22,6 +22,7 @@ RESET_ODOMETER_ACTION = "resetOdometer"
 KINEMATIC_PROPERTIES = frozenset([
     "drive_mode",
     "orientation",
+    "throttle_mode",
 ])
 
 
@@ -33,6 +34,7 @@ DRIVE_MODES = [
     { "key": str(DriveMode.SKID),        "disabled": False,  "name": "Skid steer" },
     { "key": str(DriveMode.SPINNING),    "disabled": False,  "name": "Spinning" },
     { "key": str(DriveMode.BALANCING),   "disabled": False,  "name": "Balancing" },
+    { "key": str(DriveMode.PATH),        "disabled": False,  "name": "Path following" },
 ]
 
 ORIENTATIONS = [
@@ -47,6 +49,7 @@ def kinematic2dict(kinematic: Kinematic) -> dict:
     return {
         "drive_mode": str(kinematic.drive_mode),
         "orientation": str(kinematic.orientation),
+        "throttle_mode": str(kinematic.throttle_mode),
     }
 
 
@@ -59,6 +62,8 @@ def set_kinematic_from_dict(kinematic: Kinematic, json: dict):
             elif key == "orientation":
                 logger.info(f"SetOrientation: {value} {to_enum(Orientation, value)}")
                 value = to_enum(Orientation, value)
+            elif key == "throttle_mode":
+                value = to_enum(ThrottleMode, value)
             setattr(kinematic, key, value)
 
 
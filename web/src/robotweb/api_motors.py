@@ -71,6 +71,7 @@ def motor2dict(motor) -> Dict:
         "rpm": motor.rpm,
         "encoder": motor.encoder,
         "odometer": motor.odometer,
+        "traction": motor.traction,
     }
 
 def motor2dict_telemetry(motor) -> Dict:
@@ -130,6 +131,31 @@ async def put_motor(request: Request) -> Response:
     return json_response(json)
 
 
+@route.post("/{index:\d+}/autotune")
+async def start_autotune(request: Request) -> Response:
+    robot = request.config_dict["robot"]
+    index = int(request.match_info["index"])
+    motor = robot.motor_control.motors[index]
+
+    json = await json_request(request)
+    if "rpm" not in json:
+        raise HTTPBadRequest()
+    if "amplitude" in json:
+        motor.start_autotune(json["rpm"], json["amplitude"])
+    else:
+        motor.start_autotune(json["rpm"])
+    return json_response(motor.autotune)
+
+
+@route.delete("/{index:\d+}/autotune")
+async def cancel_autotune(request: Request) -> Response:
+    robot = request.config_dict["robot"]
+    index = int(request.match_info["index"])
+    motor = robot.motor_control.motors[index]
+    motor.cancel_autotune()
+    return json_response(motor.autotune)
+
+
 
 
 class MotorWatch(SubscriptionWatch):
@@ -10,6 +10,28 @@ from beaglerover import Telemetry
 logger = logging.getLogger(__name__)
 
 
+# Keep history series running for a while after the last request
+HISTORY_LEASE_TIME = 10.0
+_history_leases = dict()
+
+
+def lease_history(telemetry: Telemetry, name: str):
+    """ Acquire the history series and release it again when not requested for HISTORY_LEASE_TIME seconds """
+    loop = asyncio.get_running_loop()
+    lease = _history_leases.get(name, None)
+    if lease:
+        activation, handle = lease
+        handle.cancel()
+    else:
+        activation = telemetry.acquire("history_"+name)
+
+    def __expire():
+        activation.release()
+        del _history_leases[name]
+
+    _history_leases[name] = (activation, loop.call_later(HISTORY_LEASE_TIME, __expire))
+
+
 def get_history(telemetry: Telemetry, name: str) -> dict:
     ts, head,buffer = getattr(telemetry, "history_"+name)
     return {
@@ -37,6 +59,26 @@ async def index(request: Request) -> Response:
     robot = request.config_dict["robot"]
     return json_response(robot.telemetry.odometer)
 
+@route.get("/system")
+async def index(request: Request) -> Response:
+    robot = request.config_dict["robot"]
+    return json_response(robot.telemetry.system)
+
+@route.get("/perf")
+async def index(request: Request) -> Response:
+    robot = request.config_dict["robot"]
+    return json_response(robot.telemetry.perf)
+
+@route.get("/autotune")
+async def index(request: Request) -> Response:
+    robot = request.config_dict["robot"]
+    return json_response(robot.telemetry.autotune)
+
+@route.get("/traction")
+async def index(request: Request) -> Response:
+    robot = request.config_dict["robot"]
+    return json_response(robot.telemetry.traction)
+
 
 @route.get("/history")
 async def history(request: Request) -> Response:
@@ -50,6 +92,8 @@ async def history(request: Request) -> Response:
         names = set()
 
     try:
+        for name in names:
+            lease_history(telemetry, name)
         with telemetry:
             res = dict()
             for name in names:
@@ -67,6 +111,7 @@ async def history_named(request: Request) -> Response:
     robot = request.config_dict["robot"]
     telemetry = robot.telemetry
     try:
+        lease_history(telemetry, name)
         with telemetry:
             return json_response(get_history(telemetry, name))
     except AttributeError:
@@ -74,8 +119,29 @@ async def history_named(request: Request) -> Response:
 
 
 
-class IMUWatch(SubscriptionWatch):
+class TelemetryWatch(SubscriptionWatch):
+    """ Subscription watch keeping its telemetry source active while watched """
+    SOURCE = None
+
+    def __init__(self, *args, **kwargs):
+        super().__init__(*args, **kwargs)
+        self.activation = None
+
+    async def on_start(self):
+        if not self.activation:
+            self.activation = self.target.acquire(self.SOURCE)
+        await super().on_start()
+
+    async def on_stop(self):
+        await super().on_stop()
+        if self.activation:
+            self.activation.release()
+            self.activation = None
+
+
+class IMUWatch(TelemetryWatch):
     UPDATE_GRACE_PERIOD = 0.5
+    SOURCE = "mpu"
 
     def data(self):
         return self.target.imu
@@ -89,8 +155,9 @@ class IMUWatch(SubscriptionWatch):
         await asyncio.sleep(self.UPDATE_GRACE_PERIOD)
 
 
-class OdometerWatch(SubscriptionWatch):
+class OdometerWatch(TelemetryWatch):
     UPDATE_GRACE_PERIOD = 0.5
+    SOURCE = "odometer"
 
     def data(self):
         return self.target.odometer
@@ -104,6 +171,60 @@ class OdometerWatch(SubscriptionWatch):
         await asyncio.sleep(self.UPDATE_GRACE_PERIOD)
 
 
+class SystemWatch(TelemetryWatch):
+    UPDATE_GRACE_PERIOD = 0.5
+    SOURCE = "system"
+
+    def data(self):
+        return self.target.system
+
+    def _target_subscribe(self):
+        if not self.sub:
+            self.sub = self.target.subscribe( (self.target.NOTIFY_SYSTEM,) )
+
+    async def emit(self, res: tuple):
+        await super().emit(res)
+        await asyncio.sleep(self.UPDATE_GRACE_PERIOD)
+
+
+class PerfWatch(TelemetryWatch):
+    UPDATE_GRACE_PERIOD = 0.5
+    SOURCE = "perf"
+
+    def data(self):
+        return self.target.perf
+
+    def _target_subscribe(self):
+        if not self.sub:
+            self.sub = self.target.subscribe( (self.target.NOTIFY_PERF,) )
+
+    async def emit(self, res: tuple):
+        await super().emit(res)
+        await asyncio.sleep(self.UPDATE_GRACE_PERIOD)
+
+
+class AutotuneWatch(TelemetryWatch):
+    SOURCE = "motors"
+
+    def data(self):
+        return self.target.autotune
+
+    def _target_subscribe(self):
+        if not self.sub:
+            self.sub = self.target.subscribe( (self.target.NOTIFY_AUTOTUNE,) )
+
+
+class TractionWatch(TelemetryWatch):
+    SOURCE = "motors"
+
+    def data(self):
+        return self.target.traction
+
+    def _target_subscribe(self):
+        if not self.sub:
+            self.sub = self.target.subscribe( (self.target.NOTIFY_TRACTION,) )
+
+
 class TelemetryNamespace(WatchableNamespace):
     NAME = "/telemetry"
 
@@ -116,7 +237,11 @@ class TelemetryNamespace(WatchableNamespace):
         logger.info(f"Robot: {robot} {robot.telemetry}")
         await self._init_watches([
             IMUWatch(self, robot.telemetry, f"update_imu"),
-            OdometerWatch(self, robot.telemetry, f"update_odometer")
+            OdometerWatch(self, robot.telemetry, f"update_odometer"),
+            SystemWatch(self, robot.telemetry, f"update_system"),
+            PerfWatch(self, robot.telemetry, f"update_perf"),
+            AutotuneWatch(self, robot.telemetry, f"update_autotune"),
+            TractionWatch(self, robot.telemetry, f"update_traction"),
         ])
 
 